@@ -0,0 +1,162 @@
+/**
+ * @file rt_baseline.h
+ * @brief Porte de non-régression : mesure courante contre seuils et référence
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Une mise à jour du kernel ou du firmware qui dégrade la latence doit être
+ * bloquée en CI, sur le matériel réel, avant d'atteindre les machines. Deux
+ * familles de contrôles, combinables :
+ * 
+ * - seuils absolus (--max-p99, --max-latency, --max-miss-rate) : le contrat
+ *   de l'application, indépendant de toute mesure précédente ;
+ * - comparaison à une référence (--baseline <trace>) : la queue de la
+ *   distribution courante est-elle significativement plus lourde que celle
+ *   d'une mesure enregistrée avec --trace sur une image validée ?
+ * 
+ * TEST DE QUEUE :
+ * Comparer deux p99.9 bruts ne suffit pas : sur 10 000 cycles, le p99.9
+ * repose sur 10 échantillons et varie d'une exécution à l'autre. Pour chaque
+ * percentile q, le seuil T est la fin de la case d'histogramme qui contient
+ * le p_q de la référence ; on compte dans chaque mesure la proportion
+ * d'échantillons au-delà de T. Un test z unilatéral à deux proportions dit
+ * si l'excès de la mesure courante dépasse ce que le hasard explique : une
+ * régression est signalée au-delà de REGRESSION_Z_THRESHOLD.
+ * 
+ * Sur peu d'échantillons le test manque de puissance (il ne signale rien),
+ * il ne crie pas au loup. Le maximum, un échantillon unique, n'est pas
+ * testé : seul --max-latency le borne.
+ */
+
+#ifndef RT_BASELINE_H
+#define RT_BASELINE_H
+
+#include <stdint.h>
+#include <math.h>
+#include <string>
+
+#include "rt_utils.h"
+#include "rt_trace.h"
+
+// ============================================================================
+// PARAMÈTRES DE LA PORTE
+// ============================================================================
+
+/// Seuil du test z unilatéral : risque de fausse alerte de 0,1 % par percentile
+constexpr double REGRESSION_Z_THRESHOLD = 3.09;
+
+/// Percentiles de queue comparés à la référence
+constexpr double REGRESSION_PERCENTILES[] = {99.0, 99.9, 99.99};
+
+/**
+ * @brief Contrôles demandés sur la ligne de commande
+ */
+struct RegressionGate {
+    std::string baseline_path;      ///< Trace de référence (vide = pas de comparaison)
+    uint64_t max_p99_ns = 0;        ///< Limite du p99 (0 = aucune)
+    uint64_t max_latency_ns = 0;    ///< Limite de la latence maximale (0 = aucune)
+    double max_miss_rate = -1.0;    ///< Limite du taux de deadlines manquées, en fraction (< 0 = aucune)
+    
+    /// Au moins un contrôle demandé ?
+    bool enabled() const
+    {
+        return !baseline_path.empty() || max_p99_ns != 0 || max_latency_ns != 0 || max_miss_rate >= 0.0;
+    }
+};
+
+// ============================================================================
+// COMPARAISON DES QUEUES
+// ============================================================================
+
+/**
+ * @brief Résultat du test d'un percentile de queue
+ */
+struct TailComparison {
+    double percentile = 0.0;
+    uint64_t baseline_ns = 0;       ///< p_q de la référence
+    uint64_t current_ns = 0;        ///< p_q de la mesure courante
+    uint64_t threshold_ns = 0;      ///< Seuil T : fin de la case de baseline_ns
+    double baseline_excess = 0.0;   ///< Fraction de la référence au-delà de T
+    double current_excess = 0.0;    ///< Fraction de la mesure courante au-delà de T
+    double z = 0.0;                 ///< Statistique du test (> 0 : queue courante plus lourde)
+    bool regression = false;        ///< z > REGRESSION_Z_THRESHOLD
+};
+
+/// Échantillons rangés après la case d'indice bucket
+inline uint64_t histogram_count_above(const LatencyHistogram& histogram, size_t bucket)
+{
+    uint64_t count = 0;
+    for (size_t i = bucket + 1; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        count += histogram.bucket_count_at(i);
+    }
+    return count;
+}
+
+/**
+ * @brief Compare la queue de deux distributions au percentile donné
+ * 
+ * Les deux histogrammes ont les mêmes cases : compter au-delà d'une case
+ * est exact, sans interpolation.
+ * 
+ * @param baseline Mesure de référence (non vide)
+ * @param current Mesure courante (non vide)
+ * @param percentile Percentile testé (ex. 99.9)
+ */
+inline TailComparison compare_tail(const LatencyHistogram& baseline, const LatencyHistogram& current,
+                                   double percentile)
+{
+    TailComparison result;
+    result.percentile = percentile;
+    result.baseline_ns = baseline.value_at_percentile(percentile);
+    result.current_ns = current.value_at_percentile(percentile);
+    
+    const size_t bucket = LatencyHistogram::bucket_index(result.baseline_ns);
+    result.threshold_ns = LatencyHistogram::bucket_lower_bound(bucket) + LatencyHistogram::bucket_width(bucket);
+    
+    const double n0 = static_cast<double>(baseline.count());
+    const double n1 = static_cast<double>(current.count());
+    const double k0 = static_cast<double>(histogram_count_above(baseline, bucket));
+    const double k1 = static_cast<double>(histogram_count_above(current, bucket));
+    result.baseline_excess = k0 / n0;
+    result.current_excess = k1 / n1;
+    
+    // Proportion commune sous l'hypothèse « même distribution »
+    const double pooled = (k0 + k1) / (n0 + n1);
+    const double variance = pooled * (1.0 - pooled) * (1.0 / n0 + 1.0 / n1);
+    if (variance > 0.0) {
+        result.z = (result.current_excess - result.baseline_excess) / sqrt(variance);
+    }
+    result.regression = result.z > REGRESSION_Z_THRESHOLD;
+    return result;
+}
+
+/**
+ * @brief Reconstruit l'histogramme d'une trace de référence
+ * 
+ * @param path Trace enregistrée avec --trace
+ * @param histogram Histogramme rempli en cas de succès (deadline = période)
+ * @param error Explication en cas d'échec
+ * @return false si la trace est illisible ou vide
+ */
+inline bool load_baseline_histogram(const std::string& path, LatencyHistogram& histogram, std::string& error)
+{
+    TraceReader reader;
+    if (!reader.open(path)) {
+        error = reader.error();
+        return false;
+    }
+    if (reader.count() == 0) {
+        error = "trace sans échantillon";
+        return false;
+    }
+    
+    histogram.reset();
+    histogram.set_deadline_ns(static_cast<uint64_t>(reader.header()->period_us) * 1000);
+    for (uint64_t i = 0; i < reader.count(); ++i) {
+        histogram.record(reader.record(i).latency_ns);
+    }
+    return true;
+}
+
+#endif // RT_BASELINE_H
@@ -0,0 +1,491 @@
+/**
+ * @file rt_bench.cpp
+ * @brief Micro-benchmarks des primitives de rt_utils.h (chemin temps réel)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Chaque cycle de la boucle RT appelle timespec_add_us(), enregistre une
+ * latence dans LatencyHistogram et pousse un échantillon dans SpscRing ; le
+ * bilan appelle calculate_stats() et calculate_percentile(). Ce programme
+ * mesure ces primitives une à une, pour qu'une optimisation soit chiffrée
+ * plutôt que supposée :
+ * 
+ * - ns/op : lots d'opérations chronométrés par CLOCK_MONOTONIC, lot calibré
+ *   pour durer au moins BENCH_BATCH_MIN_NS (le coût de clock_gettime est
+ *   amorti) ; minimum et médiane sur --reps lots ;
+ * - cycles/op et instructions/op : groupe perf_event_open (rt_perf.h)
+ *   activé autour de chaque lot, médiane sur les lots. « n/d » si le PMU
+ *   est indisponible (machine virtuelle, perf_event_paranoid > 2).
+ * 
+ * La ligne « boucle vide » donne le coût du harnais lui-même : le retrancher
+ * des autres lignes pour les primitives de quelques ns.
+ * 
+ * ============================================================================
+ * UTILISATION
+ * ============================================================================
+ * 
+ *   ./rt_bench                          # Tous les bancs
+ *   sudo ./rt_bench --cpu 3 --prio 80   # CPU isolé, SCHED_FIFO : mesures stables
+ *   ./rt_bench --filter histogram       # Bancs dont le nom contient « histogram »
+ *   ./rt_bench --help                   # Afficher l'aide
+ * 
+ * ============================================================================
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <time.h>
+#include <errno.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <cstdlib>
+#include <climits>
+
+#include "rt_core.h"     // rt_utils.h, rt_perf.h et parse_int_option()
+
+// ============================================================================
+// CONSTANTES DE CONFIGURATION
+// ============================================================================
+
+/// Durée minimale d'un lot : clock_gettime() (~20-50 ns) pèse alors < 0,1 %
+constexpr uint64_t BENCH_BATCH_MIN_NS = 200000;
+
+/// Lots mesurés par banc (option --reps)
+constexpr int DEFAULT_BENCH_REPS = 51;
+
+/// Échantillons des bancs calculate_stats / calculate_percentile (10 s à 1 kHz)
+constexpr size_t BENCH_SAMPLE_COUNT = 10000;
+
+/// Entrées précalculées parcourues en boucle (puissance de 2 : index masqué)
+constexpr size_t BENCH_INPUT_COUNT = 1024;
+
+// ============================================================================
+// HARNAIS DE MESURE
+// ============================================================================
+
+/**
+ * @brief Empêche le compilateur d'éliminer un calcul dont le résultat est inutilisé
+ * 
+ * L'asm vide « lit » la valeur depuis la mémoire : elle doit être calculée,
+ * mais aucune instruction n'est émise.
+ */
+template <typename T>
+inline void do_not_optimize(const T& value)
+{
+    __asm__ __volatile__("" : : "g"(&value) : "memory");
+}
+
+/**
+ * @brief Un banc : exécute ops opérations de la primitive mesurée
+ */
+struct BenchCase {
+    std::string name;                           ///< Nom affiché (et filtré par --filter)
+    std::function<void(uint64_t ops)> run;      ///< Lot de ops opérations
+};
+
+/**
+ * @brief Résultat d'un banc
+ */
+struct BenchResult {
+    uint64_t ops_per_batch = 0;
+    double min_ns = 0.0;            ///< ns/op du lot le plus rapide
+    double median_ns = 0.0;         ///< ns/op médian
+    double cycles = -1.0;           ///< cycles/op médians (< 0 : indisponible)
+    double instructions = -1.0;     ///< instructions/op médianes (< 0 : indisponible)
+};
+
+/// Médiane d'un échantillon (réordonné)
+double median_of(std::vector<double>& values)
+{
+    auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+}
+
+/// Durée d'un lot de ops opérations (ns)
+uint64_t time_batch(const BenchCase& bench, uint64_t ops)
+{
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bench.run(ops);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    return timespec_diff_ns(start, end);
+}
+
+/**
+ * @brief Calibre la taille du lot, puis mesure reps lots
+ * 
+ * @param bench Banc à mesurer
+ * @param reps Nombre de lots mesurés
+ * @param perf Groupe cycles / instructions (peut n'être pas ouvert)
+ */
+BenchResult run_bench(const BenchCase& bench, int reps, PerfCounterGroup& perf)
+{
+    // Calibration : doubler le lot jusqu'à BENCH_BATCH_MIN_NS (chauffe les caches au passage)
+    uint64_t ops = 1;
+    while (time_batch(bench, ops) < BENCH_BATCH_MIN_NS && ops < (1ULL << 40)) {
+        ops *= 2;
+    }
+    
+    std::vector<double> ns_per_op, cycles_per_op, instructions_per_op;
+    const double divisor = static_cast<double>(ops);
+    for (int r = 0; r < reps; ++r) {
+        perf.reset();
+        perf.enable();
+        const uint64_t elapsed_ns = time_batch(bench, ops);
+        perf.disable();
+        ns_per_op.push_back(static_cast<double>(elapsed_ns) / divisor);
+        
+        uint64_t values[2];
+        if (perf.read(values)) {
+            if (perf.available(0)) cycles_per_op.push_back(static_cast<double>(values[0]) / divisor);
+            if (perf.available(1)) instructions_per_op.push_back(static_cast<double>(values[1]) / divisor);
+        }
+    }
+    
+    BenchResult result;
+    result.ops_per_batch = ops;
+    result.min_ns = *std::min_element(ns_per_op.begin(), ns_per_op.end());
+    result.median_ns = median_of(ns_per_op);
+    if (!cycles_per_op.empty()) result.cycles = median_of(cycles_per_op);
+    if (!instructions_per_op.empty()) result.instructions = median_of(instructions_per_op);
+    return result;
+}
+
+// ============================================================================
+// ENTRÉES DES BANCS
+// ============================================================================
+
+/**
+ * @brief Générateur pseudo-aléatoire xorshift64 (reproductible, sans allocation)
+ */
+struct XorShift64 {
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    
+    uint64_t next()
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+};
+
+/**
+ * @brief Latence synthétique : pic vers 10 µs, queue jusqu'à quelques centaines de µs
+ * 
+ * Forme typique d'une mesure RT : la distribution des valeurs conditionne
+ * le coût de nth_element et des cases parcourues dans l'histogramme.
+ */
+uint64_t synthetic_latency_ns(XorShift64& rng)
+{
+    const uint64_t base = 8000 + rng.next() % 4000;
+    const uint64_t r = rng.next() % 1000;
+    if (r == 0) return base + rng.next() % 500000;   // 0,1 % de pics
+    if (r < 20) return base + rng.next() % 50000;    // 2 % de queue
+    return base;
+}
+
+/**
+ * @brief Bancs des primitives de rt_utils.h
+ * 
+ * Les entrées sont précalculées une fois : chaque lot ne mesure que la
+ * primitive, pas la génération de ses arguments.
+ */
+std::vector<BenchCase> make_bench_cases()
+{
+    XorShift64 rng;
+    
+    auto starts = std::make_shared<std::vector<struct timespec>>(BENCH_INPUT_COUNT);
+    auto ends = std::make_shared<std::vector<struct timespec>>(BENCH_INPUT_COUNT);
+    for (size_t k = 0; k < BENCH_INPUT_COUNT; ++k) {
+        (*starts)[k] = ns_to_timespec(1000000000000ULL + rng.next() % 1000000000000ULL);
+        (*ends)[k] = ns_to_timespec(timespec_to_ns((*starts)[k]) + rng.next() % 2000000);
+    }
+    
+    auto samples = std::make_shared<std::vector<uint64_t>>(BENCH_SAMPLE_COUNT);
+    auto histogram = std::make_shared<LatencyHistogram>(1000000);
+    for (uint64_t& sample : *samples) {
+        sample = synthetic_latency_ns(rng);
+        histogram->record(sample);
+    }
+    auto latencies = std::make_shared<std::vector<uint64_t>>(BENCH_INPUT_COUNT);
+    for (uint64_t& latency : *latencies) {
+        latency = synthetic_latency_ns(rng);
+    }
+    
+    std::vector<BenchCase> cases;
+    
+    cases.push_back({"boucle vide", [](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            do_not_optimize(i);
+        }
+    }});
+    
+    cases.push_back({"timespec_diff_ns", [starts, ends](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            const size_t k = static_cast<size_t>(i) & (BENCH_INPUT_COUNT - 1);
+            uint64_t diff = timespec_diff_ns((*starts)[k], (*ends)[k]);
+            do_not_optimize(diff);
+        }
+    }});
+    
+    // Usage de la boucle RT : échéance suivante, normalisée une fois par seconde
+    cases.push_back({"timespec_add_us 1000 µs", [](uint64_t ops) {
+        struct timespec ts = {1000, 0};
+        for (uint64_t i = 0; i < ops; ++i) {
+            timespec_add_us(ts, 1000);
+            do_not_optimize(ts);
+        }
+    }});
+    
+    // Le while de normalisation tourne une fois par seconde ajoutée
+    cases.push_back({"timespec_add_us 2.5 s", [](uint64_t ops) {
+        struct timespec ts = {1000, 0};
+        for (uint64_t i = 0; i < ops; ++i) {
+            timespec_add_us(ts, 2500000);
+            do_not_optimize(ts);
+        }
+    }});
+    
+    cases.push_back({"calculate_stats(vector 10k)", [samples](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            LatencyStats stats = calculate_stats(*samples);
+            do_not_optimize(stats);
+        }
+    }});
+    
+    cases.push_back({"calculate_stats(histogram)", [histogram](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            LatencyStats stats = calculate_stats(*histogram);
+            do_not_optimize(stats);
+        }
+    }});
+    
+    cases.push_back({"calculate_percentile(vector 10k)", [samples](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            uint64_t p99 = calculate_percentile(*samples, 99.0);
+            do_not_optimize(p99);
+        }
+    }});
+    
+    cases.push_back({"calculate_percentile(histogram)", [histogram](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            uint64_t p99 = calculate_percentile(*histogram, 99.0);
+            do_not_optimize(p99);
+        }
+    }});
+    
+    cases.push_back({"RunningStats::add", [latencies](uint64_t ops) {
+        RunningStats stats(1000000);
+        for (uint64_t i = 0; i < ops; ++i) {
+            stats.add((*latencies)[static_cast<size_t>(i) & (BENCH_INPUT_COUNT - 1)]);
+        }
+        do_not_optimize(stats);
+    }});
+    
+    auto target = std::make_shared<LatencyHistogram>(1000000);
+    cases.push_back({"LatencyHistogram::record", [latencies, target](uint64_t ops) {
+        for (uint64_t i = 0; i < ops; ++i) {
+            target->record((*latencies)[static_cast<size_t>(i) & (BENCH_INPUT_COUNT - 1)]);
+        }
+        do_not_optimize(*target);
+    }});
+    
+    // Producteur et consommateur sur le même thread : coût propre, sans
+    // transfert de ligne de cache entre cœurs
+    auto ring = std::make_shared<SpscRing<LatencySample>>(BENCH_INPUT_COUNT);
+    cases.push_back({"SpscRing push + pop", [ring](uint64_t ops) {
+        LatencySample sample = {};
+        for (uint64_t i = 0; i < ops; ++i) {
+            sample.latency_ns = i;
+            ring->try_push(sample);
+            ring->try_pop(sample);
+            do_not_optimize(sample);
+        }
+    }});
+    
+    return cases;
+}
+
+// ============================================================================
+// ANALYSE DES ARGUMENTS
+// ============================================================================
+
+/**
+ * @brief Affiche l'aide du programme
+ */
+void print_usage(const char* program_name)
+{
+    std::cout << "Usage: " << program_name << " [OPTIONS]\n"
+              << "\n"
+              << "Micro-benchmarks des primitives de rt_utils.h (ns/op, cycles/op).\n"
+              << "\n"
+              << "OPTIONS:\n"
+              << "  --cpu <n>         CPU d'exécution (défaut: non affiné)\n"
+              << "  --prio <n>        Priorité SCHED_FIFO 1-99 (défaut: SCHED_OTHER ; sudo requis)\n"
+              << "  --reps <n>        Lots mesurés par banc (défaut: " << DEFAULT_BENCH_REPS << ")\n"
+              << "  --filter <texte>  Seuls les bancs dont le nom contient ce texte\n"
+              << "  --help, -h        Affiche cette aide\n"
+              << "\n"
+              << "EXEMPLES:\n"
+              << "  " << program_name << "\n"
+              << "  sudo " << program_name << " --cpu 3 --prio 80\n"
+              << "  " << program_name << " --filter timespec\n"
+              << std::endl;
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+/// Largeur affichée d'un texte UTF-8 (« µ » : deux octets, une colonne)
+size_t display_width(const std::string& text)
+{
+    size_t width = 0;
+    for (char c : text) {
+        if ((static_cast<unsigned char>(c) & 0xC0) != 0x80) ++width;
+    }
+    return width;
+}
+
+/// Valeur par opération, ou « n/d » si le compteur est indisponible
+void print_counter(double value)
+{
+    if (value < 0.0) {
+        std::cout << std::setw(10) << "n/d";
+    } else {
+        std::cout << std::setw(10) << std::setprecision(1) << value;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    int cpu = -1;
+    int priority = 0;
+    int reps = DEFAULT_BENCH_REPS;
+    std::string filter;
+    const long max_cpu = sysconf(_SC_NPROCESSORS_CONF) - 1;
+    
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        
+        if (arg == "--help" || arg == "-h") {
+            print_usage(argv[0]);
+            return 0;
+        } else if (arg == "--cpu") {
+            if (!parse_int_option(arg, value, 0, max_cpu, cpu)) return 1;
+            ++i;
+        } else if (arg == "--prio") {
+            if (!parse_int_option(arg, value, 1, 99, priority)) return 1;
+            ++i;
+        } else if (arg == "--reps") {
+            if (!parse_int_option(arg, value, 3, 100000, reps)) return 1;
+            ++i;
+        } else if (arg == "--filter") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            filter = value;
+            ++i;
+        } else {
+            std::cerr << "Option inconnue: " << arg << "\n" << std::endl;
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    
+    std::cout << COLOR_CYAN
+              << "\n╔══════════════════════════════════════════════════════════════╗\n"
+              << "║          MICRO-BENCHMARKS DES PRIMITIVES RT_UTILS            ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // Même environnement que la boucle RT : CPU fixe, pas de préemption, pas de page fault
+    if (cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(static_cast<size_t>(cpu), &cpuset);
+        if (pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) != 0) {
+            std::cerr << COLOR_YELLOW << "⚠ Affinage sur le CPU " << cpu << " impossible"
+                      << COLOR_RESET << std::endl;
+        }
+    }
+    if (priority > 0) {
+        struct sched_param param;
+        param.sched_priority = priority;
+        if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
+            std::cerr << COLOR_YELLOW << "⚠ SCHED_FIFO : " << strerror(errno)
+                      << " (sudo requis) : mesure en SCHED_OTHER" << COLOR_RESET << std::endl;
+        }
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            std::cerr << COLOR_YELLOW << "⚠ mlockall : " << strerror(errno) << COLOR_RESET << std::endl;
+        }
+    }
+    
+    PerfCounterGroup perf;
+    if (!perf.open(PERF_CYCLES_INSTRUCTIONS, 2, true)) {
+        std::cout << COLOR_YELLOW << "⚠ Compteurs matériels indisponibles (" << perf.error()
+                  << ") : ns/op seulement" << COLOR_RESET << std::endl;
+    }
+    
+    std::cout << "Configuration :" << std::endl;
+    std::cout << "  • CPU              : " << (cpu >= 0 ? std::to_string(cpu) : std::string("non affiné"))
+              << std::endl;
+    std::cout << "  • Ordonnancement   : "
+              << (priority > 0 ? "SCHED_FIFO " + std::to_string(priority) : std::string("SCHED_OTHER"))
+              << std::endl;
+    std::cout << "  • Lots par banc    : " << reps << " (≥ " << BENCH_BATCH_MIN_NS / 1000
+              << " µs chacun)" << std::endl;
+    std::cout << "  • Compteurs        : " << (perf.opened() == 2 ? "cycles, instructions"
+                                             : perf.opened() == 1 ? "partiels" : "aucun")
+              << std::endl;
+    
+    std::cout << "\n  Primitive                         │ ns/op min     médiane │  cycles/op    instr/op" << std::endl;
+    std::cout << "  ──────────────────────────────────┼───────────────────────┼──────────────────────" << std::endl;
+    std::cout << std::fixed;
+    
+    size_t run_count = 0;
+    for (const BenchCase& bench : make_bench_cases()) {
+        if (!filter.empty() && bench.name.find(filter) == std::string::npos) continue;
+        ++run_count;
+        
+        const BenchResult result = run_bench(bench, reps, perf);
+        std::cout << "  " << bench.name
+                  << std::string(34 - std::min<size_t>(display_width(bench.name), 34), ' ')
+                  << "│ " << std::setprecision(2)
+                  << std::setw(10) << result.min_ns << std::setw(11) << result.median_ns << " │ ";
+        print_counter(result.cycles);
+        std::cout << "  ";
+        print_counter(result.instructions);
+        std::cout << std::endl;
+    }
+    
+    if (run_count == 0) {
+        std::cerr << COLOR_RED << "✗ Aucun banc ne correspond à « " << filter << " »" << COLOR_RESET << std::endl;
+        return 1;
+    }
+    
+    std::cout << "\n  (médianes sur " << reps << " lots ; « boucle vide » = coût du harnais par opération ;"
+              << "\n   cycles et instructions comptés en espace utilisateur seulement)" << std::endl;
+    
+    if (priority > 0) {
+        struct sched_param param;
+        param.sched_priority = 0;
+        sched_setscheduler(0, SCHED_OTHER, &param);
+        munlockall();
+    }
+    return 0;
+}
@@ -0,0 +1,263 @@
+/**
+ * @file rt_clock.h
+ * @brief Source d'horodatage de la boucle de mesure
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Chaque cycle lit l'heure au moins une fois : le coût et la gigue de cette
+ * lecture font partie de la mesure. Deux sources sont disponibles :
+ * 
+ * - monotonic : clock_gettime(CLOCK_MONOTONIC) via le vDSO (défaut, partout)
+ * - cntvct    : lecture directe du compteur du timer générique ARM
+ *               (registre cntvct_el0, 54 MHz sur le Raspberry Pi 4),
+ *               précédée d'une barrière isb. Disponible uniquement dans les
+ *               builds TARGET_RPI4 (aarch64).
+ * 
+ * La boucle travaille en "ticks" bruts de la source ; la conversion en
+ * nanosecondes se fait par une multiplication et un décalage, avec un
+ * facteur calibré au démarrage contre CLOCK_MONOTONIC (même base de temps
+ * que les échéances de clock_nanosleep). Pour la source monotonic, un tick
+ * vaut une nanoseconde et les conversions sont l'identité.
+ */
+
+#ifndef RT_CLOCK_H
+#define RT_CLOCK_H
+
+#include <time.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+
+#include "rt_utils.h"
+
+#if defined(TARGET_RPI4) && defined(__aarch64__)
+#define RT_HAVE_CNTVCT 1
+#else
+#define RT_HAVE_CNTVCT 0
+#endif
+
+// ============================================================================
+// SOURCES D'HORODATAGE
+// ============================================================================
+
+/**
+ * @brief Source des horodatages de la boucle temps réel
+ */
+enum class ClockSource {
+    MONOTONIC,   ///< clock_gettime(CLOCK_MONOTONIC) via le vDSO
+    CNTVCT       ///< Compteur virtuel du timer générique ARM (cntvct_el0)
+};
+
+/// Durée de la calibration contre CLOCK_MONOTONIC
+constexpr int CLOCK_CALIBRATION_MS = 50;
+
+/// Lectures encadrées par point de calibration (on garde la plus serrée)
+constexpr int CLOCK_CALIBRATION_TRIES = 16;
+
+/**
+ * @brief Nom d'une source (tel qu'accepté par --clock)
+ */
+inline const char* clock_source_name(ClockSource source)
+{
+    return source == ClockSource::CNTVCT ? "cntvct" : "monotonic";
+}
+
+/**
+ * @brief Convertit un nom de source
+ * 
+ * @return true si le nom est connu
+ */
+inline bool parse_clock_source(const std::string& name, ClockSource& source)
+{
+    if (name == "monotonic") {
+        source = ClockSource::MONOTONIC;
+    } else if (name == "cntvct") {
+        source = ClockSource::CNTVCT;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+#if RT_HAVE_CNTVCT
+/**
+ * @brief Lit le compteur virtuel ARM
+ * 
+ * isb : sans barrière, le processeur peut lire le compteur en avance, avant
+ * la fin des instructions qui précèdent (lecture spéculative).
+ */
+inline uint64_t read_cntvct()
+{
+    uint64_t ticks;
+    __asm__ __volatile__("isb\n\tmrs %0, cntvct_el0" : "=r"(ticks) : : "memory");
+    return ticks;
+}
+
+/// Fréquence nominale du compteur, programmée par le firmware (Hz)
+inline uint64_t read_cntfrq()
+{
+    uint64_t hz;
+    __asm__ __volatile__("mrs %0, cntfrq_el0" : "=r"(hz));
+    return hz;
+}
+#endif
+
+// ============================================================================
+// HORLOGE CALIBRÉE
+// ============================================================================
+
+/**
+ * @brief Horodatage en ticks bruts, converti en ns hors du chemin critique
+ * 
+ * Construit par défaut sur CLOCK_MONOTONIC (un tick = une ns) ; init()
+ * sélectionne et calibre une autre source. Une fois initialisée, l'horloge
+ * est en lecture seule et peut être partagée par plusieurs threads.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * TimestampClock clock;
+ * clock.init(ClockSource::CNTVCT);          // au démarrage, hors boucle RT
+ * uint64_t t0 = clock.now();
+ * // ...
+ * uint64_t elapsed_ns = clock.delta_ns(clock.now() - t0);
+ * @endcode
+ */
+class TimestampClock {
+public:
+    /**
+     * @brief Sélectionne la source et la calibre contre CLOCK_MONOTONIC
+     * 
+     * Dure CLOCK_CALIBRATION_MS pour la source cntvct.
+     * 
+     * @return false si la source n'existe pas dans ce build
+     */
+    bool init(ClockSource source)
+    {
+        source_ = ClockSource::MONOTONIC;
+        tick_base_ = 0;
+        ns_base_ = 0;
+        if (source == ClockSource::MONOTONIC) {
+            return true;
+        }
+#if RT_HAVE_CNTVCT
+        source_ = ClockSource::CNTVCT;
+        nominal_hz_ = read_cntfrq();
+        
+        uint64_t ticks_a, ns_a, ticks_b, ns_b;
+        sample_pair(ticks_a, ns_a);
+        struct timespec pause = {0, CLOCK_CALIBRATION_MS * 1000000L};
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &pause, NULL);
+        sample_pair(ticks_b, ns_b);
+        
+        const double ns_per_tick = static_cast<double>(ns_b - ns_a)
+                                 / static_cast<double>(ticks_b - ticks_a);
+        mult_ = static_cast<uint64_t>(ns_per_tick * static_cast<double>(1ULL << SHIFT) + 0.5);
+        inv_mult_ = static_cast<uint64_t>(static_cast<double>(1ULL << SHIFT) / ns_per_tick + 0.5);
+        frequency_hz_ = 1e9 / ns_per_tick;
+        tick_base_ = ticks_b;
+        ns_base_ = ns_b;
+        return true;
+#else
+        return false;
+#endif
+    }
+    
+    /// Horodatage brut (ticks de la source)
+    uint64_t now() const
+    {
+#if RT_HAVE_CNTVCT
+        if (source_ == ClockSource::CNTVCT) {
+            return read_cntvct();
+        }
+#endif
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return timespec_to_ns(ts);
+    }
+    
+    /// Durée en ticks → ns (une multiplication 64×64 et un décalage)
+    uint64_t delta_ns(uint64_t ticks) const
+    {
+        if (source_ == ClockSource::MONOTONIC) return ticks;
+        return mul_shift(ticks, mult_);
+    }
+    
+    /// Horodatage brut → instant CLOCK_MONOTONIC (ns)
+    uint64_t to_ns(uint64_t ticks) const
+    {
+        if (source_ == ClockSource::MONOTONIC) return ticks;
+        return ticks >= tick_base_ ? ns_base_ + mul_shift(ticks - tick_base_, mult_)
+                                   : ns_base_ - mul_shift(tick_base_ - ticks, mult_);
+    }
+    
+    /// Instant CLOCK_MONOTONIC (ns) → horodatage brut, ex. une échéance
+    uint64_t from_ns(uint64_t ns) const
+    {
+        if (source_ == ClockSource::MONOTONIC) return ns;
+        return ns >= ns_base_ ? tick_base_ + mul_shift(ns - ns_base_, inv_mult_)
+                              : tick_base_ - mul_shift(ns_base_ - ns, inv_mult_);
+    }
+    
+    ClockSource source() const { return source_; }          ///< Source active
+    double frequency_hz() const { return frequency_hz_; }   ///< Fréquence calibrée (Hz)
+    uint64_t nominal_hz() const { return nominal_hz_; }     ///< Fréquence annoncée (cntfrq_el0)
+    
+    /// Description lisible, ex. "cntvct_el0 (54.000 MHz calibrés)"
+    std::string describe() const
+    {
+        if (source_ == ClockSource::MONOTONIC) {
+            return "CLOCK_MONOTONIC (vDSO)";
+        }
+        char text[96];
+        snprintf(text, sizeof(text), "cntvct_el0 (%.3f MHz calibrés, %.3f MHz annoncés)",
+                 frequency_hz_ / 1e6, static_cast<double>(nominal_hz_) / 1e6);
+        return text;
+    }
+
+private:
+    /// Précision des facteurs de conversion (virgule fixe 32.32)
+    static constexpr unsigned SHIFT = 32;
+    
+    /// (value × mult) >> SHIFT sans débordement, calcul intermédiaire sur 128 bits
+    static uint64_t mul_shift(uint64_t value, uint64_t mult)
+    {
+        __extension__ typedef unsigned __int128 uint128;
+        return static_cast<uint64_t>((static_cast<uint128>(value) * mult) >> SHIFT);
+    }
+
+#if RT_HAVE_CNTVCT
+    /**
+     * @brief Lecture simultanée du compteur et de CLOCK_MONOTONIC
+     * 
+     * clock_gettime() est encadré par deux lectures du compteur ; la paire
+     * la plus serrée parmi CLOCK_CALIBRATION_TRIES est retenue et le
+     * compteur est pris au milieu de l'encadrement.
+     */
+    static void sample_pair(uint64_t& ticks, uint64_t& ns)
+    {
+        uint64_t best_width = UINT64_MAX;
+        for (int k = 0; k < CLOCK_CALIBRATION_TRIES; ++k) {
+            struct timespec ts;
+            uint64_t before = read_cntvct();
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            uint64_t after = read_cntvct();
+            if (after - before < best_width) {
+                best_width = after - before;
+                ticks = before + (after - before) / 2;
+                ns = timespec_to_ns(ts);
+            }
+        }
+    }
+#endif
+
+    ClockSource source_ = ClockSource::MONOTONIC;
+    uint64_t mult_ = 1ULL << SHIFT;       ///< ns par tick (virgule fixe)
+    uint64_t inv_mult_ = 1ULL << SHIFT;   ///< Ticks par ns (virgule fixe)
+    uint64_t tick_base_ = 0;              ///< Point de calibration : ticks...
+    uint64_t ns_base_ = 0;                ///< ... et instant CLOCK_MONOTONIC correspondant
+    double frequency_hz_ = 1e9;
+    uint64_t nominal_hz_ = 1000000000ULL;
+};
+
+#endif // RT_CLOCK_H
@@ -0,0 +1,374 @@
+/**
+ * @file rt_core.cpp
+ * @brief Configuration temps réel du thread et garde d'allocation (bibliothèque rt_core)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Partie non template de rt_core.h : ces fonctions ne sont appelées qu'avant
+ * la boucle temps réel, leur place n'est pas dans un en-tête.
+ * 
+ * Le remplacement de operator new vit ici : tout programme lié à rt_core
+ * (et qui configure ses threads avec configure_realtime) compte ainsi les
+ * allocations faites pendant la fenêtre de mesure de ses tâches.
+ */
+
+#include <pthread.h>      // Threads POSIX et affinage CPU
+#include <sched.h>        // Ordonnancement : sched_setscheduler(), SCHED_FIFO
+#include <sys/mman.h>     // Verrouillage mémoire : mlockall()
+#include <errno.h>        // Codes d'erreur
+#include <string.h>       // strerror()
+#include <stdlib.h>       // malloc(), posix_memalign(), strtol()
+#include <unistd.h>       // syscall()
+#include <sys/syscall.h>  // syscall(SYS_sched_setattr) pour SCHED_DEADLINE
+
+#include <iostream>       // Sortie console
+#include <new>            // Remplacement de operator new (garde d'allocation)
+
+#include "rt_core.h"
+
+// ============================================================================
+// GARDE D'ALLOCATION : REMPLACEMENT DE operator new
+// ============================================================================
+
+/*
+ * Toute allocation C++ (std::vector qui grandit, std::string, iostream...)
+ * passe par operator new. Le remplacer permet de compter celles qui ont lieu
+ * pendant la fenêtre de mesure d'un thread RT (rt_note_allocation), voire
+ * d'arrêter le programme à la première (--memory-guard abort).
+ */
+void* operator new(std::size_t size)
+{
+    rt_note_allocation(size);
+    if (void* p = malloc(size == 0 ? 1 : size)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size)
+{
+    return ::operator new(size);
+}
+
+void* operator new(std::size_t size, std::align_val_t align)
+{
+    rt_note_allocation(size);
+    void* p = nullptr;
+    if (posix_memalign(&p, std::max(sizeof(void*), static_cast<std::size_t>(align)),
+                       size == 0 ? 1 : size) == 0) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size, std::align_val_t align)
+{
+    return ::operator new(size, align);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, std::size_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t) noexcept { free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { free(p); }
+void operator delete[](void* p, std::size_t, std::align_val_t) noexcept { free(p); }
+
+// ============================================================================
+// ANALYSE DES ARGUMENTS
+// ============================================================================
+
+/**
+ * @brief Convertit la valeur d'une option numérique en vérifiant ses bornes
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param min_value Valeur minimale acceptée
+ * @param max_value Valeur maximale acceptée
+ * @param out Valeur convertie en cas de succès
+ * @return true si la valeur est un entier valide dans [min_value, max_value]
+ */
+bool parse_int_option(const std::string& option, const char* value,
+                      long min_value, long max_value, int& out)
+{
+    if (value == nullptr) {
+        std::cerr << "Valeur manquante pour " << option << std::endl;
+        return false;
+    }
+    
+    char* end = nullptr;
+    errno = 0;
+    long parsed = strtol(value, &end, 10);
+    
+    if (errno != 0 || end == value || *end != '\0'
+        || parsed < min_value || parsed > max_value) {
+        std::cerr << "Valeur invalide pour " << option << ": " << value
+                  << " (attendu: " << min_value << " à " << max_value << ")" << std::endl;
+        return false;
+    }
+    
+    out = static_cast<int>(parsed);
+    return true;
+}
+
+// ============================================================================
+// FONCTIONS DE CONFIGURATION TEMPS RÉEL
+// ============================================================================
+
+/**
+ * @brief Nom d'une politique d'ordonnancement
+ */
+const char* policy_name(int policy)
+{
+    switch (policy) {
+        case SCHED_FIFO:     return "SCHED_FIFO";
+        case SCHED_RR:       return "SCHED_RR";
+        case SCHED_DEADLINE: return "SCHED_DEADLINE";
+        default:             return "SCHED_OTHER";
+    }
+}
+
+#ifndef SCHED_FLAG_RESET_ON_FORK
+#define SCHED_FLAG_RESET_ON_FORK 0x01   // <linux/sched.h>, absent de la glibc
+#endif
+
+/**
+ * @brief Attributs de sched_setattr() (ABI du kernel, struct sched_attr)
+ * 
+ * La glibc de Raspberry Pi OS ne fournit ni la structure ni la fonction :
+ * l'appel système est invoqué directement.
+ */
+struct DeadlineAttr {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;     ///< Budget CPU par période (ns)
+    uint64_t sched_deadline;    ///< Échéance relative au début de la période (ns)
+    uint64_t sched_period;      ///< Période de réactivation (ns)
+};
+
+/**
+ * @brief Passe le thread courant en SCHED_DEADLINE
+ * 
+ * SCHED_DEADLINE (EDF + Constant Bandwidth Server) : le kernel garantit
+ * runtime ns de CPU dans chaque fenêtre [début de période, début + deadline],
+ * à condition que la somme des réservations reste admissible
+ * (runtime / période cumulés ≤ sched_rt_runtime_us / sched_rt_period_us).
+ * Une tâche DEADLINE est prioritaire sur toute tâche SCHED_FIFO.
+ * 
+ * @param config Paramètres d'exécution (période, deadline, budget)
+ * @return 0 en cas de succès, sinon errno
+ */
+int set_deadline_scheduling(const RtTaskConfig& config)
+{
+    DeadlineAttr attr {};
+    attr.size = sizeof(attr);
+    attr.sched_policy = SCHED_DEADLINE;
+    // Sans ce drapeau, une tâche DEADLINE ne peut pas créer de thread (EAGAIN) :
+    // le thread de rapport repart ainsi en SCHED_OTHER
+    attr.sched_flags = SCHED_FLAG_RESET_ON_FORK;
+    attr.sched_runtime = static_cast<uint64_t>(config.runtime_us) * 1000;
+    attr.sched_deadline = config.deadline_ns();
+    attr.sched_period = static_cast<uint64_t>(config.period_us) * 1000;
+    
+    if (syscall(SYS_sched_setattr, 0, &attr, 0) != 0) {
+        return errno;
+    }
+    return 0;
+}
+
+/**
+ * @brief Configure le thread courant pour l'exécution temps réel
+ * 
+ * Cette fonction applique les trois configurations essentielles pour une tâche
+ * temps réel sous Linux :
+ * 1. Verrouillage mémoire (mlockall)
+ * 2. Ordonnancement SCHED_FIFO
+ * 3. Affinage CPU sur un cœur isolé
+ * 
+ * @param config Paramètres d'exécution (priorité, CPU cible)
+ * @return true si la configuration réussit, false sinon
+ */
+bool configure_realtime(const RtTaskConfig& config)
+{
+    std::cout << COLOR_CYAN << "\n╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           CONFIGURATION TEMPS RÉEL                           ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // ========================================================================
+    // ÉTAPE 1 : VERROUILLAGE MÉMOIRE
+    // ========================================================================
+    
+    std::cout << "1️⃣  Verrouillage mémoire avec mlockall()" << std::endl;
+    std::cout << "   ────────────────────────────────────────" << std::endl;
+    std::cout << "   Objectif : Éviter les page faults qui causent des latences" << std::endl;
+    std::cout << "              imprévisibles (plusieurs millisecondes)." << std::endl;
+    std::cout << std::endl;
+    
+    /*
+     * mlockall() verrouille toutes les pages mémoire en RAM.
+     * 
+     * POURQUOI C'EST NÉCESSAIRE ?
+     * Par défaut, Linux utilise la mémoire virtuelle. Quand un programme accède
+     * à une page non chargée en RAM, un "page fault" se produit : le kernel doit
+     * charger la page depuis le disque ou la swap. Ce processus peut prendre
+     * plusieurs MILLISECONDES - catastrophique pour le temps réel.
+     * 
+     * MCL_CURRENT : Verrouille les pages actuellement mappées
+     * MCL_FUTURE : Verrouille aussi les futures allocations
+     */
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << COLOR_RED 
+                  << "   ✗ Erreur mlockall: " << strerror(errno) << "\n\n"
+                  << "   Solution : Exécuter avec sudo\n"
+                  << "              sudo ./rt_tuto\n"
+                  << COLOR_RESET << std::endl;
+        return false;
+    }
+    std::cout << "   " << COLOR_GREEN << "✓ Mémoire verrouillée (MCL_CURRENT | MCL_FUTURE)" 
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // ========================================================================
+    // ÉTAPE 2 : ORDONNANCEMENT SCHED_FIFO
+    // ========================================================================
+    
+    std::cout << "2️⃣  Configuration ordonnancement " << policy_name(config.policy) << std::endl;
+    std::cout << "   ─────────────────────────────────────────" << std::endl;
+    std::cout << "   Objectif : Garantir l'exécution prioritaire du thread." << std::endl;
+    std::cout << std::endl;
+    
+    /*
+     * POLITIQUES D'ORDONNANCEMENT LINUX :
+     * 
+     * SCHED_OTHER (défaut) :
+     *   - Ordonnancement équitable (CFS)
+     *   - Pas de garanties de latence
+     *   - Préemptable à tout moment
+     * 
+     * SCHED_FIFO (temps réel) :
+     *   - First-In-First-Out
+     *   - Priorités 1-99 (99 = plus haute)
+     *   - Préempté UNIQUEMENT par :
+     *     * Thread de priorité supérieure
+     *     * Interruption matérielle
+     *   - Garde le CPU jusqu'à ce qu'il :
+     *     * Se bloque (sleep, I/O, mutex)
+     *     * Yield explicitement
+     * 
+     * SCHED_RR : comme SCHED_FIFO, avec un quantum de temps entre threads
+     *   de même priorité.
+     * 
+     * SCHED_DEADLINE (EDF) : pas de priorité, mais une réservation
+     *   (runtime, deadline, période). Voir set_deadline_scheduling().
+     */
+    if (config.policy == SCHED_DEADLINE) {
+        std::cout << "   Configuration :" << std::endl;
+        std::cout << "   • Politique : SCHED_DEADLINE (EDF, via sched_setattr)" << std::endl;
+        std::cout << "   • Runtime   : " << config.runtime_us << " µs par période" << std::endl;
+        std::cout << "   • Deadline  : " << config.deadline_ns() / 1000 << " µs" << std::endl;
+        std::cout << "   • Période   : " << config.period_us << " µs" << std::endl;
+        std::cout << std::endl;
+        
+        int err = set_deadline_scheduling(config);
+        if (err != 0) {
+            std::cerr << COLOR_RED 
+                      << "   ✗ Erreur sched_setattr: " << strerror(err) << "\n\n"
+                      << "   Solutions :\n"
+                      << "   1. Exécuter avec sudo: sudo ./rt_tuto\n"
+                      << "   2. EBUSY : réservation refusée (contrôle d'admission) ;\n"
+                      << "      réduire --runtime ou vérifier /proc/sys/kernel/sched_rt_runtime_us\n"
+                      << "   3. EINVAL : il faut runtime ≤ deadline ≤ période\n"
+                      << COLOR_RESET << std::endl;
+            munlockall();
+            return false;
+        }
+        std::cout << "   " << COLOR_GREEN << "✓ SCHED_DEADLINE activé ("
+                  << config.runtime_us << "/" << config.period_us << " µs)"
+                  << COLOR_RESET << "\n" << std::endl;
+        
+        /*
+         * Une tâche SCHED_DEADLINE doit pouvoir s'exécuter sur tous les CPUs de
+         * son domaine d'ordonnancement : sched_setaffinity() vers un seul CPU
+         * est refusé (EBUSY). Pour réserver un CPU isolé, il faut créer une
+         * partition cpuset exclusive contenant ce CPU et y placer le processus.
+         */
+        std::cout << "3️⃣  Affinage CPU" << std::endl;
+        std::cout << "   ────────────────" << std::endl;
+        std::cout << "   " << COLOR_YELLOW << "⚠ Non appliqué : SCHED_DEADLINE exige une affinité couvrant\n"
+                  << "     tout le domaine d'ordonnancement (utiliser un cpuset exclusif)"
+                  << COLOR_RESET << std::endl;
+        return true;
+    }
+    
+    struct sched_param param;
+    param.sched_priority = config.priority;
+    
+    std::cout << "   Configuration :" << std::endl;
+    std::cout << "   • Politique : " << policy_name(config.policy) << " (temps réel)" << std::endl;
+    std::cout << "   • Priorité  : " << config.priority << " (1-99, 99 = max)" << std::endl;
+    std::cout << std::endl;
+    
+    if (sched_setscheduler(0, config.policy, &param) != 0) {
+        std::cerr << COLOR_RED 
+                  << "   ✗ Erreur sched_setscheduler: " << strerror(errno) << "\n\n"
+                  << "   Solutions :\n"
+                  << "   1. Exécuter avec sudo: sudo ./rt_tuto\n"
+                  << "   2. Vérifier : ulimit -r (doit être 99)\n"
+                  << COLOR_RESET << std::endl;
+        munlockall();
+        return false;
+    }
+    std::cout << "   " << COLOR_GREEN << "✓ " << policy_name(config.policy) << " activé avec priorité " << config.priority 
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // ========================================================================
+    // ÉTAPE 3 : AFFINAGE CPU (CPU PINNING)
+    // ========================================================================
+    
+    std::cout << "3️⃣  Affinage sur CPU isolé" << std::endl;
+    std::cout << "   ────────────────────────" << std::endl;
+    std::cout << "   Objectif : Exécuter sur un CPU dédié sans interférences." << std::endl;
+    std::cout << std::endl;
+    
+    /*
+     * CPU PINNING : POURQUOI ?
+     * 
+     * Même avec SCHED_FIFO, des interférences peuvent survenir :
+     * - Interruptions matérielles
+     * - Threads kernel (softirq, workqueues)
+     * - Cache invalidation par d'autres processus
+     * 
+     * SOLUTION : Combiner l'affinage avec l'isolation CPU du kernel.
+     * 
+     * PARAMÈTRES KERNEL (configurés par setup_realtime_rpi.sh) :
+     *   isolcpus=2,3  : CPUs exclus du scheduler général
+     *   rcu_nocbs=2,3 : RCU callbacks déplacés ailleurs
+     *   nohz_full=2,3 : Ticks timer désactivés (tickless)
+     * 
+     * L'affinage force le thread sur un CPU isolé, garantissant une
+     * exécution sans perturbation.
+     */
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<size_t>(config.cpu), &cpuset);
+    
+    std::cout << "   Configuration :" << std::endl;
+    std::cout << "   • CPU cible : " << config.cpu << " (isolé par isolcpus=2,3)" << std::endl;
+    std::cout << "   • Méthode   : pthread_setaffinity_np()" << std::endl;
+    std::cout << std::endl;
+    
+    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
+        std::cerr << COLOR_YELLOW 
+                  << "   ⚠ Avertissement : Affinage CPU échoué - " << strerror(errno) << "\n"
+                  << "     Le test continue mais les résultats peuvent être moins bons.\n"
+                  << COLOR_RESET << std::endl;
+    } else {
+        std::cout << "   " << COLOR_GREEN << "✓ Thread affiné sur CPU " << config.cpu 
+                  << COLOR_RESET << std::endl;
+    }
+    
+    return true;
+}
@@ -0,0 +1,709 @@
+/**
+ * @file rt_core.h
+ * @brief Tâche périodique temps réel réutilisable (bibliothèque rt_core)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Ce fichier regroupe ce que toute boucle de contrôle périodique doit faire
+ * correctement, indépendamment du travail qu'elle réalise :
+ * 
+ * - configuration du thread (mlockall, SCHED_FIFO / RR / DEADLINE, affinage)
+ * - pré-chargement de la pile et garde d'allocation pendant la mesure
+ * - réveil sur échéances absolues (PeriodicWaiter, rt_timer.h)
+ * - horodatage (TimestampClock, rt_clock.h) et calibration de l'instrument
+ * - statistiques en flux : histogrammes de latence et de temps d'exécution,
+ *   dépassements de période (rt_utils.h)
+ * - compteurs PMU relevés à chaque cycle, en option (rt_perf.h)
+ * 
+ * Le travail du cycle est un paramètre de template de PeriodicTask : il est
+ * appelé directement depuis la boucle, sans fonction virtuelle ni
+ * std::function, et le compilateur peut l'intégrer (inline) dans le chemin
+ * critique. rt_tuto est construit sur cette bibliothèque.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * RtTaskConfig config = RtTaskConfig()
+ *     .with_policy(SCHED_FIFO)
+ *     .with_priority(80)
+ *     .with_cpu(2)
+ *     .with_period_us(1000)
+ *     .with_iterations(10000);
+ * 
+ * PeriodicTask task(config, [&](const LatencySample& sample) {
+ *     controller.step(sample.timestamp_ns);
+ *     return true;                        // false : fin de la tâche
+ * });
+ * if (!task.configure()) return 1;
+ * TaskStats stats = task.run();           // premier réveil une période après l'appel
+ * 
+ * LatencyStats summary = calculate_stats(stats.histogram);
+ * LatencyPercentiles tail = calculate_percentiles(stats.histogram);
+ * std::cout << "max " << summary.max_ns << " ns, p99.9 " << tail.p999_ns << " ns" << std::endl;
+ * print_histogram(stats.histogram);
+ * @endcode
+ * 
+ * Plusieurs tâches alignées sur une origine commune : chaque thread appelle
+ * configure(), prépare ses statistiques par make_stats() hors de la boucle,
+ * puis run(origine, stats) avec le même instant de premier réveil.
+ */
+
+#ifndef RT_CORE_H
+#define RT_CORE_H
+
+#include <sched.h>
+#include <stdint.h>
+#include <time.h>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "rt_utils.h"
+#include "rt_clock.h"
+#include "rt_timer.h"
+#include "rt_memory.h"
+#include "rt_perf.h"
+
+// ============================================================================
+// VALEURS PAR DÉFAUT
+// ============================================================================
+
+/**
+ * PÉRIODE DE LA TÂCHE PÉRIODIQUE (valeur par défaut, option --period)
+ * 
+ * Pour une application temps réel typique (contrôle, robotique), une période
+ * de 1 ms (1000 µs) est courante. Plus la période est courte, plus les
+ * contraintes de latence sont strictes.
+ */
+constexpr int DEFAULT_PERIOD_US = 1000;  // 1000 µs = 1 ms
+
+/**
+ * NOMBRE D'ITÉRATIONS (valeur par défaut, options --loops / --duration)
+ * 
+ * Pour une démonstration pédagogique, 1000 itérations (1 seconde) suffisent.
+ * Pour des tests de stress réels, utilisez cyclictest avec des millions
+ * d'itérations.
+ */
+constexpr int DEFAULT_NUM_ITERATIONS = 1000;
+
+/**
+ * PRIORITÉ TEMPS RÉEL (valeur par défaut, option --prio)
+ * 
+ * Sous Linux, les priorités SCHED_FIFO vont de 1 (plus basse) à 99 (plus haute).
+ * Une priorité de 80 est suffisante pour la plupart des applications tout en
+ * laissant de la marge pour d'éventuels threads critiques du système.
+ */
+constexpr int DEFAULT_RT_PRIORITY = 80;
+
+/**
+ * CPU ISOLÉ POUR L'EXÉCUTION (valeur par défaut, option --cpu)
+ * 
+ * Le script setup_realtime_rpi.sh configure isolcpus=2,3. Ces CPUs sont
+ * réservés aux tâches temps réel et ne reçoivent pas de tâches du scheduler
+ * général.
+ */
+constexpr int DEFAULT_RT_CPU = 2;
+
+/**
+ * ALIGNEMENT SUR LES PÉRIODES SCHED_DEADLINE
+ * 
+ * Le kernel ne publie pas l'instant de début de ses périodes : la boucle
+ * observe DEADLINE_ALIGN_PERIODS réveils avant la mesure et prend le plus
+ * précoce comme origine de la grille des réveils attendus.
+ */
+constexpr int DEADLINE_ALIGN_PERIODS = 20;
+
+/**
+ * PRÉ-CHARGEMENT DE LA PILE (option --prefault-stack)
+ * 
+ * Profondeur de pile touchée par chaque thread RT avant la mesure : 256 Ko
+ * couvrent très largement la boucle et le travail d'un cycle ordinaire.
+ */
+constexpr int DEFAULT_PREFAULT_STACK_KB = 256;
+
+/**
+ * ATTENTE ACTIVE DU MÉCANISME HYBRIDE (option --spin)
+ * 
+ * Le thread dort jusqu'à DEFAULT_SPIN_US avant l'échéance puis scrute
+ * l'horloge : la marge doit couvrir la latence de réveil du kernel, sinon
+ * le mécanisme se comporte comme clock_nanosleep.
+ */
+constexpr int DEFAULT_SPIN_US = 50;
+
+/**
+ * CALIBRATION DE L'INSTRUMENT
+ * 
+ * Avant chaque mesure, la boucle chronomètre INSTRUMENT_CALIBRATION_SAMPLES
+ * lectures d'horloge dos à dos, puis autant de séquences de comptabilité
+ * (lecture, conversion, enregistrement dans l'histogramme), sur le même CPU
+ * et avec la même politique que la mesure elle-même.
+ */
+constexpr int INSTRUMENT_CALIBRATION_SAMPLES = 10000;
+
+// ============================================================================
+// CONFIGURATION D'UNE TÂCHE
+// ============================================================================
+
+/**
+ * @brief Politique de rattrapage après un dépassement de période
+ * 
+ * SKIP     : les échéances déjà passées sont abandonnées, le prochain réveil
+ *            est la première échéance future (défaut, comportement attendu
+ *            d'une boucle de contrôle).
+ * CATCH_UP : toutes les échéances sont exécutées, dos à dos, jusqu'à
+ *            rattraper le retard (rafale de cycles sans sommeil).
+ */
+enum class OverrunPolicy {
+    SKIP,
+    CATCH_UP
+};
+
+/**
+ * @brief Paramètres d'une tâche périodique
+ * 
+ * Les champs sont publics (lecture directe dans la boucle) ; les méthodes
+ * with_*() permettent de construire une configuration en une expression.
+ */
+struct RtTaskConfig {
+    int period_us = DEFAULT_PERIOD_US;       ///< Période de la tâche (µs)
+    int num_iterations = DEFAULT_NUM_ITERATIONS;  ///< Nombre de cycles (0 = jusqu'à ce que le cycle retourne false)
+    int priority = DEFAULT_RT_PRIORITY;      ///< Priorité SCHED_FIFO (1-99)
+    int policy = SCHED_FIFO;                 ///< SCHED_FIFO, SCHED_RR ou SCHED_DEADLINE
+    int runtime_us = 0;                      ///< Budget SCHED_DEADLINE par période (µs)
+    int cpu = DEFAULT_RT_CPU;                ///< CPU cible de l'affinage
+    int deadline_us = 0;                     ///< Deadline de réveil (µs, 0 = période)
+    OverrunPolicy overrun_policy = OverrunPolicy::SKIP;  ///< Rattrapage des dépassements
+    int prefault_stack_kb = DEFAULT_PREFAULT_STACK_KB;  ///< Pile pré-chargée par thread RT
+    TimerBackend timer = TimerBackend::NANOSLEEP;       ///< Mécanisme de réveil
+    int spin_us = DEFAULT_SPIN_US;           ///< Mécanisme hybride : attente active finale (µs)
+    TimestampClock clock;                    ///< Source des horodatages (déjà calibrée)
+    bool subtract_overhead = false;          ///< Retirer le plancher de l'instrument des latences
+    bool measure_exec = true;                ///< Chronométrer le travail de chaque cycle
+    bool measure_pmu = false;                ///< Relever les compteurs PMU à chaque cycle
+    
+    RtTaskConfig& with_period_us(int us) { period_us = us; return *this; }
+    RtTaskConfig& with_iterations(int n) { num_iterations = n; return *this; }
+    RtTaskConfig& with_priority(int prio) { priority = prio; return *this; }
+    RtTaskConfig& with_policy(int sched_policy) { policy = sched_policy; return *this; }
+    RtTaskConfig& with_runtime_us(int us) { runtime_us = us; return *this; }
+    RtTaskConfig& with_cpu(int target_cpu) { cpu = target_cpu; return *this; }
+    RtTaskConfig& with_deadline_us(int us) { deadline_us = us; return *this; }
+    RtTaskConfig& with_overrun_policy(OverrunPolicy p) { overrun_policy = p; return *this; }
+    RtTaskConfig& with_prefault_stack_kb(int kb) { prefault_stack_kb = kb; return *this; }
+    RtTaskConfig& with_timer(TimerBackend backend, int spin = DEFAULT_SPIN_US)
+    {
+        timer = backend;
+        spin_us = spin;
+        return *this;
+    }
+    RtTaskConfig& with_clock(const TimestampClock& source) { clock = source; return *this; }
+    RtTaskConfig& with_subtract_overhead(bool on) { subtract_overhead = on; return *this; }
+    RtTaskConfig& with_exec_time(bool on) { measure_exec = on; return *this; }
+    RtTaskConfig& with_pmu(bool on) { measure_pmu = on; return *this; }
+    
+    /// Deadline effective en ns : une latence au-delà est une deadline manquée
+    uint64_t deadline_ns() const
+    {
+        return static_cast<uint64_t>(deadline_us > 0 ? deadline_us : period_us) * 1000;
+    }
+    
+    /// Période en ns
+    uint64_t period_ns() const
+    {
+        return static_cast<uint64_t>(period_us) * 1000;
+    }
+};
+
+// ============================================================================
+// RÉSULTATS D'UNE TÂCHE
+// ============================================================================
+
+/**
+ * @brief Coût propre de l'instrument de mesure (passe de calibration)
+ * 
+ * Une latence lue par la boucle contient au moins le coût d'une lecture
+ * d'horloge : c'est le plancher de l'instrument. En dessous de quelques
+ * fois ce plancher, la mesure observe surtout l'instrument lui-même.
+ */
+struct InstrumentFloor {
+    bool measured = false;          ///< Faux si aucune calibration (--analyze)
+    uint64_t read_min_ns = 0;       ///< Lecture d'horloge la plus rapide (plancher)
+    uint64_t read_p50_ns = 0;       ///< Lecture d'horloge médiane
+    uint64_t read_max_ns = 0;       ///< Lecture d'horloge la plus lente
+    uint64_t bookkeeping_p50_ns = 0;   ///< Lecture + conversion + enregistrement (médiane)
+    bool subtracted = false;        ///< Plancher retiré de chaque latence
+    
+    /// Agrège le plancher d'un autre thread (on garde le plus pessimiste)
+    void merge(const InstrumentFloor& other)
+    {
+        if (!other.measured) return;
+        if (!measured) {
+            *this = other;
+            return;
+        }
+        read_min_ns = std::max(read_min_ns, other.read_min_ns);
+        read_p50_ns = std::max(read_p50_ns, other.read_p50_ns);
+        read_max_ns = std::max(read_max_ns, other.read_max_ns);
+        bookkeeping_p50_ns = std::max(bookkeeping_p50_ns, other.bookkeeping_p50_ns);
+    }
+};
+
+/**
+ * @brief Statistiques en flux d'une tâche périodique
+ * 
+ * Mémoire constante quel que soit le nombre de cycles : tout est alloué
+ * avant la boucle, l'enregistrement d'un cycle est en O(1).
+ */
+struct TaskStats {
+    LatencyHistogram histogram;        ///< Latences de réveil (et deadlines manquées)
+    LatencyHistogram exec_histogram;   ///< Temps d'exécution du cycle (vide si non mesuré)
+    OverrunStats overruns;             ///< Dépassements de période
+    MemoryGuardStats memory;           ///< Page faults et allocations pendant la mesure
+    InstrumentFloor instrument;        ///< Coût de l'instrument, mesuré avant la boucle
+    PmuStats pmu;                      ///< Compteurs PMU par cycle (measure_pmu)
+    
+    /// Agrège les résultats d'un autre thread
+    void merge(const TaskStats& other)
+    {
+        histogram.merge(other.histogram);
+        exec_histogram.merge(other.exec_histogram);
+        overruns.merge(other.overruns);
+        memory.merge(other.memory);
+        instrument.merge(other.instrument);
+        pmu.merge(other.pmu);
+    }
+};
+
+// ============================================================================
+// ANALYSE DES ARGUMENTS (rt_core.cpp)
+// ============================================================================
+
+/**
+ * @brief Convertit la valeur d'une option numérique en vérifiant ses bornes
+ * 
+ * Partagée par rt_tuto et rt_bench ; les erreurs sont décrites sur std::cerr.
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param min_value Valeur minimale acceptée
+ * @param max_value Valeur maximale acceptée
+ * @param out Valeur convertie en cas de succès
+ * @return true si la valeur est un entier valide dans [min_value, max_value]
+ */
+bool parse_int_option(const std::string& option, const char* value,
+                      long min_value, long max_value, int& out);
+
+// ============================================================================
+// CONFIGURATION DU THREAD (rt_core.cpp)
+// ============================================================================
+
+/**
+ * @brief Nom d'une politique d'ordonnancement
+ */
+const char* policy_name(int policy);
+
+/**
+ * @brief Passe le thread courant en SCHED_DEADLINE
+ * 
+ * @param config Période, deadline et budget (runtime_us) de la réservation
+ * @return 0 en cas de succès, sinon errno
+ */
+int set_deadline_scheduling(const RtTaskConfig& config);
+
+/**
+ * @brief Configure le thread courant pour l'exécution temps réel
+ * 
+ * mlockall, politique d'ordonnancement, affinage CPU ; chaque étape est
+ * expliquée sur la sortie standard.
+ * 
+ * @param config Paramètres d'exécution (politique, priorité, CPU cible)
+ * @return true si la configuration réussit, false sinon
+ */
+bool configure_realtime(const RtTaskConfig& config);
+
+// ============================================================================
+// CALIBRATION DE L'INSTRUMENT DE MESURE
+// ============================================================================
+
+/**
+ * @brief Mesure le coût de l'horodatage et de la comptabilité d'un cycle
+ * 
+ * À appeler depuis le thread de mesure, après sa configuration temps réel :
+ * le plancher obtenu est celui de CE CPU sous CETTE politique.
+ * 
+ * Deux passes :
+ *   1. lectures d'horloge dos à dos : l'écart entre deux lectures est le
+ *      coût d'une lecture, soit la plus petite latence mesurable ;
+ *   2. séquence complète d'un échantillon (lecture, conversion en ns,
+ *      enregistrement dans un histogramme) reproduite à vide.
+ * 
+ * @param clock Horloge de la mesure
+ * @return Plancher de l'instrument
+ */
+inline InstrumentFloor calibrate_instrument(const TimestampClock& clock)
+{
+    LatencyHistogram reads;
+    LatencyHistogram bookkeeping;
+    LatencyHistogram scratch;   // Destination factice des enregistrements
+    
+    for (int k = 0; k < INSTRUMENT_CALIBRATION_SAMPLES; ++k) {
+        uint64_t t0 = clock.now();
+        uint64_t t1 = clock.now();
+        reads.record(clock.delta_ns(t1 - t0));
+    }
+    
+    for (int k = 0; k < INSTRUMENT_CALIBRATION_SAMPLES; ++k) {
+        uint64_t t0 = clock.now();
+        uint64_t sample = clock.now();
+        scratch.record(clock.delta_ns(sample - t0));
+        uint64_t t1 = clock.now();
+        bookkeeping.record(clock.delta_ns(t1 - t0));
+    }
+    
+    InstrumentFloor floor;
+    floor.measured = true;
+    floor.read_min_ns = reads.min_ns();
+    floor.read_p50_ns = calculate_percentiles(reads).p50_ns;
+    floor.read_max_ns = reads.max_ns();
+    floor.bookkeeping_p50_ns = calculate_percentiles(bookkeeping).p50_ns;
+    return floor;
+}
+
+// ============================================================================
+// TÂCHE PÉRIODIQUE
+// ============================================================================
+
+/**
+ * @brief Boucle périodique temps réel autour d'un travail de cycle
+ * 
+ * @tparam Cycle Appelable invoqué à chaque réveil avec l'échantillon du
+ *               cycle (const LatencySample&). S'il renvoie un booléen,
+ *               false termine la tâche ; il peut aussi ne rien renvoyer.
+ *               Son temps d'exécution (réveil → retour) alimente
+ *               exec_histogram lorsque measure_exec est vrai.
+ * 
+ * configure() et run() doivent être appelés par le thread qui exécute la
+ * tâche : l'ordonnancement, l'affinage, la pile pré-chargée et le signal
+ * du mécanisme de réveil lui sont propres.
+ */
+template <typename Cycle>
+class PeriodicTask {
+public:
+    PeriodicTask(const RtTaskConfig& config, Cycle cycle)
+        : config_(config), cycle_(std::move(cycle))
+    {
+    }
+    
+    /// Configure le thread appelant (voir configure_realtime)
+    bool configure() const
+    {
+        return configure_realtime(config_);
+    }
+    
+    /// Statistiques vides, seuils de deadline posés (allouées hors boucle RT)
+    TaskStats make_stats() const
+    {
+        TaskStats stats;
+        stats.histogram.set_deadline_ns(config_.deadline_ns());
+        stats.exec_histogram.set_deadline_ns(config_.period_ns());
+        return stats;
+    }
+    
+    /// Exécute la tâche ; premier réveil une période après l'appel
+    TaskStats run()
+    {
+        TaskStats stats = make_stats();
+        struct timespec first_wake;
+        clock_gettime(CLOCK_MONOTONIC, &first_wake);
+        timespec_add_us(first_wake, static_cast<uint64_t>(config_.period_us));
+        run(first_wake, stats);
+        return stats;
+    }
+    
+    /**
+     * @brief Exécute la tâche : attente, mesure, cycle, période suivante
+     * 
+     * @param next_period Instant du premier réveil (CLOCK_MONOTONIC) ; une
+     *                    origine commune aligne plusieurs tâches entre elles
+     * @param stats Destination des mesures, préparée par make_stats()
+     */
+    void run(struct timespec next_period, TaskStats& stats);
+    
+    const RtTaskConfig& config() const { return config_; }   ///< Paramètres de la tâche
+
+private:
+    /// Appelle le travail du cycle ; false si la tâche doit s'arrêter
+    bool invoke(const LatencySample& sample)
+    {
+        if constexpr (std::is_same<decltype(cycle_(sample)), void>::value) {
+            cycle_(sample);
+            return true;
+        } else {
+            return static_cast<bool>(cycle_(sample));
+        }
+    }
+    
+    RtTaskConfig config_;
+    Cycle cycle_;
+};
+
+template <typename Cycle>
+void PeriodicTask<Cycle>::run(struct timespec next_period, TaskStats& stats)
+{
+    const uint64_t period_ns = config_.period_ns();
+    const bool edf = config_.policy == SCHED_DEADLINE;
+    const TimestampClock& clock = config_.clock;
+    bool realign = false;   ///< SCHED_DEADLINE : grille à recaler au prochain réveil
+    
+    // Pile de CE thread créée et verrouillée maintenant, pas au premier appel profond
+    prefault_stack(static_cast<size_t>(config_.prefault_stack_kb) * 1024);
+    
+    // Mécanisme de réveil, préparé par le thread qui attend (signal dirigé)
+    PeriodicWaiter waiter;
+    if (!edf && !waiter.open(config_.timer, config_.spin_us, &clock)) {
+        std::cerr << COLOR_YELLOW << "  ⚠ Réveil " << timer_backend_name(config_.timer)
+                  << " indisponible (" << waiter.error() << "), repli sur clock_nanosleep"
+                  << COLOR_RESET << std::endl;
+        waiter.open(TimerBackend::NANOSLEEP, 0);
+    }
+    
+    /*
+     * SCHED_DEADLINE : les périodes sont cadencées par le kernel, à partir
+     * de l'activation de la réservation, et non par next_period. Quelques
+     * périodes d'alignement donnent la phase de cette grille : l'origine est
+     * le réveil le plus précoce observé, ramené à la première période. Les
+     * latences mesurées sont donc relatives à ce meilleur réveil.
+     */
+    if (edf) {
+        uint64_t origin_ns = UINT64_MAX;
+        for (int k = 0; k < DEADLINE_ALIGN_PERIODS; ++k) {
+            sched_yield();
+            struct timespec wake;
+            clock_gettime(CLOCK_MONOTONIC, &wake);
+            origin_ns = std::min(origin_ns, timespec_to_ns(wake) - static_cast<uint64_t>(k) * period_ns);
+        }
+        next_period = ns_to_timespec(origin_ns);
+        timespec_add_us(next_period, static_cast<uint64_t>(DEADLINE_ALIGN_PERIODS) * static_cast<uint64_t>(config_.period_us));
+    }
+    
+    // Plancher de l'instrument, sur ce CPU et sous cette politique
+    stats.instrument = calibrate_instrument(clock);
+    stats.instrument.subtracted = config_.subtract_overhead;
+    const uint64_t subtract_ns = config_.subtract_overhead ? stats.instrument.read_min_ns : 0;
+    
+    /*
+     * Compteurs PMU de CE thread (pid 0) : ils le suivent quel que soit son
+     * CPU et ne comptent que lui. Le groupe est épinglé (pinned) : jamais
+     * multiplexé, donc sans extrapolation. Le kernel est compté si le
+     * système l'autorise (root, ou perf_event_paranoid ≤ 1) : le chemin de
+     * réveil et les IRQs reçues pendant le cycle font partie du coût.
+     */
+    PerfCounterGroup pmu;
+    uint64_t pmu_previous[PMU_EVENT_COUNT] = {};
+    bool pmu_on = false;
+    if (config_.measure_pmu) {
+        pmu_on = pmu.open(PMU_CYCLE_EVENTS, PMU_EVENT_COUNT, false, true);
+        stats.pmu.user_only = !pmu_on;
+        if (!pmu_on) {
+            pmu_on = pmu.open(PMU_CYCLE_EVENTS, PMU_EVENT_COUNT, true, true);
+        }
+        if (pmu_on) {
+            stats.pmu.measured = true;
+            stats.pmu.error = pmu.error();
+            for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) stats.pmu.available[k] = pmu.available(k);
+            stats.pmu.by_latency.prepare();
+            stats.pmu.by_exec.prepare();
+            pmu.reset();
+            pmu.enable();
+            pmu.read_fast(pmu_previous);
+            stats.pmu.user_read = pmu.user_readable(0);
+        } else {
+            std::cerr << COLOR_YELLOW << "  ⚠ Compteurs PMU indisponibles (" << pmu.error() << ")"
+                      << COLOR_RESET << std::endl;
+        }
+    }
+    
+    /*
+     * La préparation (pré-chargement, calibration, trace kernel) a pu durer
+     * plus d'une période : les échéances déjà passées sont sautées, en
+     * gardant la phase de la grille (commune aux threads en mode --cpus).
+     */
+    if (!edf) {
+        struct timespec ready;
+        clock_gettime(CLOCK_MONOTONIC, &ready);
+        while (timespec_to_ns(next_period) <= timespec_to_ns(ready)) {
+            timespec_add_us(next_period, static_cast<uint64_t>(config_.period_us));
+        }
+    }
+    
+    /*
+     * Fenêtre de mesure : toute allocation ou page fault de ce thread à
+     * partir d'ici est comptée (ou fatale en mode --memory-guard abort).
+     */
+    MemoryGuard guard;
+    guard.begin();
+    
+    // Échéance courante dans l'unité de l'horloge de mesure (ticks bruts)
+    uint64_t deadline_ticks = clock.from_ns(timespec_to_ns(next_period));
+    
+    // num_iterations = 0 : mesure sans limite (--soak), arrêtée par le cycle
+    const uint64_t iterations = config_.num_iterations > 0
+                              ? static_cast<uint64_t>(config_.num_iterations) : UINT64_MAX;
+    for (uint64_t i = 0; i < iterations; ++i) {
+        // --------------------------------------------------------------------
+        // ATTENTE DE LA PROCHAINE PÉRIODE
+        // --------------------------------------------------------------------
+        
+        /*
+         * clock_nanosleep() : Suspension précise du thread
+         * 
+         * Paramètres :
+         *   CLOCK_MONOTONIC : horloge de référence
+         *   TIMER_ABSTIME   : temps ABSOLU (pas relatif)
+         *   &next_period    : instant de réveil
+         *   NULL            : pas de temps restant retourné
+         * 
+         * POURQUOI TIMER_ABSTIME ?
+         * Avec un temps relatif, les petites erreurs s'accumulent.
+         * Avec un temps absolu, on spécifie l'instant exact de réveil,
+         * évitant toute dérive sur le long terme.
+         * 
+         * Autres mécanismes (--timer) : voir PeriodicWaiter dans rt_timer.h.
+         * 
+         * SCHED_DEADLINE : sched_yield() signale la fin du job ; le budget
+         * restant est abandonné et le kernel réveille la tâche au début de
+         * la période suivante (réapprovisionnement de la réservation).
+         */
+        if (edf) {
+            sched_yield();
+        } else {
+            waiter.wait_until(next_period);
+        }
+        
+        // --------------------------------------------------------------------
+        // MESURE DE LA LATENCE
+        // --------------------------------------------------------------------
+        
+        /*
+         * Immédiatement après le réveil, on mesure l'instant réel.
+         * La latence est la différence entre l'instant prévu (next_period)
+         * et l'instant réel (now).
+         * 
+         * Une latence de 0 est impossible (temps de réveil du scheduler).
+         * Une latence < 100 µs est excellente avec un kernel RT.
+         * Une latence > 500 µs indique un problème de configuration.
+         * 
+         * L'instant est lu en ticks bruts (clock.now(), voir rt_clock.h) :
+         * avec --clock cntvct, une seule instruction au lieu d'un appel vDSO,
+         * et la conversion en ns n'est faite que sur les écarts.
+         */
+        uint64_t now_ticks = clock.now();
+        
+        /*
+         * SCHED_DEADLINE : après un dépassement, le kernel redémarre la
+         * réservation à l'instant du réveil (nouvelle phase de la grille). Le
+         * premier réveil qui suit devient la nouvelle origine ; de même, un
+         * réveil en avance sur la grille estimée la recale.
+         */
+        if (edf && (realign || now_ticks < deadline_ticks)) {
+            deadline_ticks = now_ticks;
+            next_period = ns_to_timespec(clock.to_ns(now_ticks));
+            realign = false;
+        }
+        
+        uint64_t latency_ns = now_ticks > deadline_ticks ? clock.delta_ns(now_ticks - deadline_ticks) : 0;
+        
+        // --subtract-overhead : latence nette du coût de la lecture d'horloge
+        latency_ns = latency_ns > subtract_ns ? latency_ns - subtract_ns : 0;
+        stats.histogram.record(latency_ns);
+        
+        // --------------------------------------------------------------------
+        // TRAVAIL DU CYCLE
+        // --------------------------------------------------------------------
+        
+        /*
+         * Le travail utile de la boucle de contrôle (appel direct, intégrable
+         * par le compilateur). Son temps d'exécution est mesuré séparément de
+         * la latence de réveil : c'est leur somme qui doit tenir dans la
+         * période.
+         */
+        uint64_t now_ns = clock.to_ns(now_ticks);
+        if (!invoke(LatencySample{i, now_ns, latency_ns})) {
+            break;
+        }
+        
+        uint64_t cycle_end_ns = now_ns;
+        uint64_t exec_ns = 0;
+        if (config_.measure_exec) {
+            uint64_t end_ticks = clock.now();
+            exec_ns = clock.delta_ns(end_ticks - now_ticks);
+            stats.exec_histogram.record(exec_ns);
+            cycle_end_ns = clock.to_ns(end_ticks);
+        }
+        
+        // Compteurs écoulés depuis la fin du cycle précédent, rangés par latence et par exécution
+        if (pmu_on) {
+            uint64_t values[PMU_EVENT_COUNT];
+            uint64_t deltas[PMU_EVENT_COUNT];
+            pmu.read_fast(values);
+            for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) {
+                deltas[k] = values[k] - pmu_previous[k];
+                pmu_previous[k] = values[k];
+            }
+            stats.pmu.by_latency.record(latency_ns, deltas);
+            stats.pmu.by_exec.record(exec_ns, deltas);
+            ++stats.pmu.cycles;
+        }
+        
+        // --------------------------------------------------------------------
+        // CALCUL DE LA PROCHAINE PÉRIODE
+        // --------------------------------------------------------------------
+        
+        /*
+         * On ajoute la période à l'instant prévu.
+         * Si tv_nsec dépasse 1 seconde (1,000,000,000 ns), on incrémente
+         * tv_sec et on soustrait 1 seconde de tv_nsec (voir timespec_add_us).
+         */
+        timespec_add_us(next_period, static_cast<uint64_t>(config_.period_us));
+        
+        // --------------------------------------------------------------------
+        // DÉTECTION DES DÉPASSEMENTS (OVERRUNS)
+        // --------------------------------------------------------------------
+        
+        /*
+         * Si le cycle s'est terminé après la prochaine échéance, celle-ci est
+         * déjà dans le passé : clock_nanosleep() retournerait immédiatement.
+         * 
+         * Avec CATCH_UP (rattrapage), les cycles en retard s'enchaînent sans
+         * dormir, produisant une rafale de cycles qui masque le problème.
+         * Avec SKIP, on saute toutes les échéances déjà passées pour se
+         * recaler sur la grille de périodes ; chaque saut est comptabilisé.
+         */
+        uint64_t next_ns = timespec_to_ns(next_period);
+        if (cycle_end_ns >= next_ns) {
+            uint64_t overrun_ns = cycle_end_ns - next_ns;
+            uint64_t missed = overrun_ns / period_ns + 1;
+            stats.overruns.record_overrun(overrun_ns, missed);
+            
+            // Avec SCHED_DEADLINE, le kernel saute toujours les périodes passées
+            if (config_.overrun_policy == OverrunPolicy::SKIP || edf) {
+                timespec_add_us(next_period, missed * static_cast<uint64_t>(config_.period_us));
+            }
+            realign = edf;
+        } else {
+            stats.overruns.record_on_time();
+        }
+        deadline_ticks = clock.from_ns(timespec_to_ns(next_period));
+        
+        // Mode abort : une lecture getrusage() par cycle (coût d'un appel système)
+        if (rt_memory_guard_abort) {
+            guard.check(i);
+        }
+    }
+    
+    stats.memory = guard.end();
+    if (pmu_on) pmu.disable();
+}
+
+#endif // RT_CORE_H
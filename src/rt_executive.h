@@ -0,0 +1,255 @@
+/**
+ * @file rt_executive.h
+ * @brief Exécutif cyclique multi-cadences sur un seul thread (bibliothèque rt_core)
+ *
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ *
+ * Un contrôleur réel enchaîne plusieurs boucles : courant à 1 kHz, position
+ * à 250 Hz, supervision à 10 Hz. Un thread SCHED_FIFO par boucle coûte un
+ * changement de contexte à chaque réveil et multiplie les CPUs isolés. Un
+ * exécutif cyclique les place toutes sur UN thread et UNE ligne de temps :
+ *
+ * - la trame de base vaut la plus petite période ; le thread se réveille à
+ *   chaque trame (PeriodicTask, clock_nanosleep absolu par défaut) ;
+ * - une tâche de période P est libérée toutes les P / trame trames ;
+ * - dans une trame, les tâches libérées s'exécutent dans l'ordre
+ *   rate-monotonic (la plus courte période d'abord), sans préemption.
+ *
+ * Les périodes doivent être harmoniques (chacune multiple de la
+ * précédente) : la grille se répète alors exactement à chaque
+ * hyperpériode (la plus grande période).
+ *
+ * Sans préemption, une tâche lente retarde les tâches rapides de la trame
+ * suivante si elle déborde de la sienne : la somme des pires temps
+ * d'exécution d'une trame doit tenir dans la trame. Une tâche plus longue
+ * se découpe en étapes exécutées sur plusieurs trames.
+ *
+ * Pour chaque tâche on mesure :
+ * - le temps d'exécution ;
+ * - la gigue de démarrage : instant de démarrage - instant de libération
+ *   (latence de réveil de la trame + tâches plus rapides passées avant) ;
+ * - les dépassements : fin après la libération suivante de la même tâche ;
+ * - les libérations perdues : trames sautées après un dépassement de trame.
+ *
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * CyclicExecutive<std::function<void()>> executive(config);
+ * executive.add_task("courant", 1000, [&] { current_loop.step(); });
+ * executive.add_task("position", 4000, [&] { position_loop.step(); });
+ * executive.add_task("supervision", 100000, [&] { supervisor.step(); });
+ * std::string error;
+ * if (!executive.prepare(error)) { ... }
+ * TaskStats frames = executive.make_frame_stats();
+ * executive.run(first_wake, frames);
+ * @endcode
+ */
+
+#ifndef RT_EXECUTIVE_H
+#define RT_EXECUTIVE_H
+
+#include <stdint.h>
+#include <time.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rt_core.h"
+
+// ============================================================================
+// STATISTIQUES PAR TÂCHE
+// ============================================================================
+
+/**
+ * @brief Mesures d'une tâche de l'exécutif cyclique
+ */
+struct ExecutiveTaskStats {
+    std::string name;                   ///< Nom lisible de la tâche
+    int period_us = 0;                  ///< Période de la tâche (µs)
+    uint64_t divider = 1;               ///< Période / trame de base
+    LatencyHistogram exec_histogram;    ///< Temps d'exécution (ns)
+    LatencyHistogram jitter_histogram;  ///< Démarrage - libération (ns)
+    OverrunStats overruns;              ///< Fin après la libération suivante
+    uint64_t lost_releases = 0;         ///< Libérations tombées dans une trame sautée
+};
+
+// ============================================================================
+// EXÉCUTIF CYCLIQUE
+// ============================================================================
+
+/**
+ * @brief Tâches harmoniques exécutées sur une seule ligne de temps
+ *
+ * @tparam Job Appelable sans argument, un par tâche. Un type concret
+ *             commun (foncteur) garde l'appel direct ; std::function permet
+ *             des tâches hétérogènes au prix d'un appel indirect.
+ *
+ * add_task() et prepare() allouent : à appeler avant la configuration
+ * temps réel. run() n'alloue plus rien.
+ */
+template <typename Job>
+class CyclicExecutive {
+public:
+    /**
+     * @param config Paramètres du thread (politique, CPU, réveil, itérations =
+     *               nombre de trames) ; la période est celle de la trame,
+     *               fixée par prepare()
+     */
+    explicit CyclicExecutive(const RtTaskConfig& config)
+        : config_(config)
+    {
+    }
+
+    /// Enregistre une tâche (avant prepare())
+    void add_task(const std::string& name, int period_us, Job job)
+    {
+        Entry entry;
+        entry.stats.name = name;
+        entry.stats.period_us = period_us;
+        entry.job = std::move(job);
+        tasks_.push_back(std::move(entry));
+    }
+
+    /**
+     * @brief Trie les tâches (rate-monotonic) et vérifie l'harmonie des périodes
+     *
+     * @param error Explication en cas d'échec
+     * @return false si aucune tâche, période invalide ou non harmonique
+     */
+    bool prepare(std::string& error)
+    {
+        if (tasks_.empty()) {
+            error = "aucune tâche enregistrée";
+            return false;
+        }
+        std::stable_sort(tasks_.begin(), tasks_.end(), [](const Entry& a, const Entry& b) {
+            return a.stats.period_us < b.stats.period_us;
+        });
+
+        const int frame_us = tasks_.front().stats.period_us;
+        if (frame_us <= 0) {
+            error = "période de tâche invalide";
+            return false;
+        }
+        for (size_t k = 1; k < tasks_.size(); ++k) {
+            const int previous = tasks_[k - 1].stats.period_us;
+            const int period = tasks_[k].stats.period_us;
+            if (period % previous != 0) {
+                error = "périodes non harmoniques : " + std::to_string(period)
+                      + " µs n'est pas un multiple de " + std::to_string(previous) + " µs";
+                return false;
+            }
+        }
+
+        config_.period_us = frame_us;
+        frame_ns_ = config_.period_ns();
+        for (Entry& entry : tasks_) {
+            ExecutiveTaskStats& stats = entry.stats;
+            stats.divider = static_cast<uint64_t>(stats.period_us / frame_us);
+            stats.exec_histogram.set_deadline_ns(static_cast<uint64_t>(stats.period_us) * 1000);
+            stats.jitter_histogram.set_deadline_ns(static_cast<uint64_t>(stats.period_us) * 1000);
+        }
+        prepared_ = true;
+        return true;
+    }
+
+    /// Statistiques de la trame (réveil, occupation, dépassements), allouées hors boucle
+    TaskStats make_frame_stats() const
+    {
+        TaskStats stats;
+        stats.histogram.set_deadline_ns(config_.deadline_ns());
+        stats.exec_histogram.set_deadline_ns(config_.period_ns());
+        return stats;
+    }
+
+    /**
+     * @brief Exécute config.num_iterations trames
+     *
+     * @param first_wake Instant du premier réveil (CLOCK_MONOTONIC)
+     * @param frame_stats Mesures de la trame : latence de réveil, temps
+     *                    d'exécution de la trame entière, dépassements
+     */
+    void run(struct timespec first_wake, TaskStats& frame_stats)
+    {
+        if (!prepared_) return;
+        first_frame_ = true;
+
+        PeriodicTask frame(config_, [this](const LatencySample& sample) {
+            dispatch(sample);
+        });
+        frame.run(first_wake, frame_stats);
+    }
+
+    int frame_us() const { return config_.period_us; }                   ///< Trame de base (µs)
+    int hyperperiod_us() const { return tasks_.back().stats.period_us; }  ///< Après prepare()
+    size_t task_count() const { return tasks_.size(); }                  ///< Tâches enregistrées
+    const ExecutiveTaskStats& task_stats(size_t k) const { return tasks_[k].stats; }   ///< Ordre RM
+
+private:
+    struct Entry {
+        ExecutiveTaskStats stats;
+        Job job;
+        bool released_once = false;
+        uint64_t last_frame = 0;
+    };
+
+    /**
+     * @brief Travail d'une trame : tâches libérées, dans l'ordre rate-monotonic
+     *
+     * Le numéro de trame est déduit de l'échéance de réveil (réveil - latence)
+     * et non du compteur de cycles : après une trame sautée (politique SKIP),
+     * les libérations restent sur la grille.
+     */
+    void dispatch(const LatencySample& sample)
+    {
+        const TimestampClock& clock = config_.clock;
+        const uint64_t scheduled_ns = sample.timestamp_ns - sample.latency_ns;
+        if (first_frame_) {
+            origin_ns_ = scheduled_ns;
+            first_frame_ = false;
+        }
+        const uint64_t index = (scheduled_ns - origin_ns_ + frame_ns_ / 2) / frame_ns_;
+        const uint64_t frame_start_ns = origin_ns_ + index * frame_ns_;
+
+        for (Entry& entry : tasks_) {
+            ExecutiveTaskStats& stats = entry.stats;
+            if (index % stats.divider != 0) continue;
+
+            if (entry.released_once && index > entry.last_frame + stats.divider) {
+                stats.lost_releases += (index - entry.last_frame) / stats.divider - 1;
+            }
+            entry.released_once = true;
+            entry.last_frame = index;
+
+            uint64_t start_ticks = clock.now();
+            entry.job();
+            uint64_t end_ticks = clock.now();
+
+            uint64_t start_ns = clock.to_ns(start_ticks);
+            uint64_t exec_ns = clock.delta_ns(end_ticks - start_ticks);
+            stats.jitter_histogram.record(start_ns > frame_start_ns ? start_ns - frame_start_ns : 0);
+            stats.exec_histogram.record(exec_ns);
+
+            // Échéance de la tâche : sa libération suivante
+            const uint64_t period_ns = static_cast<uint64_t>(stats.period_us) * 1000;
+            const uint64_t next_release_ns = frame_start_ns + period_ns;
+            const uint64_t end_ns = start_ns + exec_ns;
+            if (end_ns >= next_release_ns) {
+                uint64_t overrun_ns = end_ns - next_release_ns;
+                stats.overruns.record_overrun(overrun_ns, overrun_ns / period_ns + 1);
+            } else {
+                stats.overruns.record_on_time();
+            }
+        }
+    }
+
+    RtTaskConfig config_;
+    std::vector<Entry> tasks_;
+    bool prepared_ = false;
+    uint64_t frame_ns_ = 0;
+    bool first_frame_ = true;
+    uint64_t origin_ns_ = 0;
+};
+
+#endif // RT_EXECUTIVE_H
@@ -0,0 +1,429 @@
+/**
+ * @file rt_export.h
+ * @brief Résultats lisibles par machine : JSON, CSV et exposition Prometheus
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * L'affichage de display_results() (couleurs ANSI, cadres, émojis) est fait
+ * pour un humain ; des tableaux de bord qui l'analysent par expressions
+ * régulières cassent au premier changement de libellé. Ce fichier écrit les
+ * mêmes résultats sous une forme stable :
+ * 
+ * - JSON (--format json) : un document par exécution, avec la configuration,
+ *   l'instantané système, et pour chaque mesure les statistiques exactes, les
+ *   percentiles, les dépassements et les cases non vides de l'histogramme ;
+ * - CSV (--format csv) : les mêmes valeurs en format « long », une ligne
+ *   run,section,clé,valeur, directement chargeable par un tableur ou pandas ;
+ * - Prometheus (--prom-file) : fichier texte au format d'exposition,
+ *   réécrit périodiquement par le thread de rapport et collecté par le
+ *   « textfile collector » de node_exporter.
+ * 
+ * Les latences sont en nanosecondes dans JSON et CSV (entiers exacts) et en
+ * secondes dans Prometheus (unité de base imposée par ses conventions).
+ * 
+ * Rien ici n'est appelé depuis la boucle temps réel : formatage et fichiers
+ * restent dans le thread principal ou le thread de rapport.
+ */
+
+#ifndef RT_EXPORT_H
+#define RT_EXPORT_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fstream>
+#include <iomanip>
+#include <ostream>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rt_core.h"
+#include "rt_window.h"
+
+// ============================================================================
+// FORMATS DE SORTIE
+// ============================================================================
+
+/**
+ * @brief Format des résultats finaux (--format)
+ */
+enum class OutputFormat {
+    TEXT,   ///< Affichage humain (défaut)
+    JSON,   ///< Document JSON sur la sortie standard
+    CSV     ///< Lignes run,section,clé,valeur sur la sortie standard
+};
+
+/**
+ * @brief Convertit un nom de format
+ * 
+ * @return true si le nom est connu (text, json, csv)
+ */
+inline bool parse_output_format(const std::string& name, OutputFormat& format)
+{
+    if (name == "text") {
+        format = OutputFormat::TEXT;
+    } else if (name == "json") {
+        format = OutputFormat::JSON;
+    } else if (name == "csv") {
+        format = OutputFormat::CSV;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Une mesure à exporter (ex. "rt", ou "no_rt" et "rt" pour --compare)
+ */
+struct ExportRun {
+    std::string name;
+    const TaskStats* stats = nullptr;
+};
+
+/**
+ * @brief Contexte de l'exécution : paramètres et configuration système
+ * 
+ * Les paramètres sont des paires clé/valeur déjà formatées ; une valeur
+ * entièrement numérique est écrite en nombre dans le JSON.
+ */
+struct ExportInfo {
+    std::vector<std::pair<std::string, std::string>> config;
+    std::string system_snapshot;   ///< Lignes "clé=valeur" (rt_sysinfo.h)
+};
+
+// ============================================================================
+// ÉCHAPPEMENTS
+// ============================================================================
+
+/// Chaîne JSON entre guillemets (guillemets, barres obliques inverses, contrôles)
+inline std::string json_quote(const std::string& text)
+{
+    std::string quoted = "\"";
+    for (char c : text) {
+        const unsigned char u = static_cast<unsigned char>(c);
+        if (c == '"' || c == '\\') {
+            quoted += '\\';
+            quoted += c;
+        } else if (c == '\n') {
+            quoted += "\\n";
+        } else if (c == '\t') {
+            quoted += "\\t";
+        } else if (u < 0x20) {
+            char escaped[8];
+            snprintf(escaped, sizeof(escaped), "\\u%04x", u);
+            quoted += escaped;
+        } else {
+            quoted += c;
+        }
+    }
+    return quoted + "\"";
+}
+
+/// Valeur JSON : nombre si la chaîne est un entier décimal, chaîne sinon
+inline std::string json_value(const std::string& text)
+{
+    const size_t start = (!text.empty() && text[0] == '-') ? 1 : 0;
+    const bool numeric = text.size() > start && text.size() < 19
+                      && text.find_first_not_of("0123456789", start) == std::string::npos;
+    return numeric ? text : json_quote(text);
+}
+
+/// Champ CSV (RFC 4180) : entre guillemets s'il contient , " ou un saut de ligne
+inline std::string csv_field(const std::string& text)
+{
+    if (text.find_first_of(",\"\n\r") == std::string::npos) return text;
+    std::string quoted = "\"";
+    for (char c : text) {
+        if (c == '"') quoted += '"';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+/// Paires "clé=valeur" de l'instantané système, dans l'ordre
+inline std::vector<std::pair<std::string, std::string>> snapshot_pairs(const std::string& snapshot)
+{
+    std::vector<std::pair<std::string, std::string>> pairs;
+    std::istringstream lines(snapshot);
+    std::string line;
+    while (std::getline(lines, line)) {
+        const size_t equal = line.find('=');
+        if (equal == std::string::npos) continue;
+        pairs.emplace_back(line.substr(0, equal), line.substr(equal + 1));
+    }
+    return pairs;
+}
+
+// ============================================================================
+// JSON
+// ============================================================================
+
+/// Clés des percentiles de STANDARD_PERCENTILES (rt_utils.h), dans le même ordre
+constexpr const char* EXPORT_PERCENTILE_KEYS[] = {"p50", "p90", "p99", "p99_9", "p99_99"};
+
+/**
+ * @brief Objet JSON d'un histogramme : statistiques exactes, percentiles, cases
+ */
+inline void write_json_histogram(std::ostream& out, const LatencyHistogram& histogram,
+                                 const char* indent)
+{
+    const RunningStats& stats = histogram.stats();
+    std::vector<uint64_t> pct = calculate_percentiles(
+        histogram, std::vector<double>(std::begin(STANDARD_PERCENTILES), std::end(STANDARD_PERCENTILES)));
+    
+    out << "{\n"
+        << indent << "  \"count\": " << stats.count() << ",\n"
+        << indent << "  \"min_ns\": " << stats.min_ns() << ",\n"
+        << indent << "  \"max_ns\": " << stats.max_ns() << ",\n"
+        << indent << "  \"mean_ns\": " << stats.mean_ns() << ",\n"
+        << indent << "  \"stddev_ns\": " << stats.stddev_ns() << ",\n"
+        << indent << "  \"deadline_ns\": " << stats.deadline_ns() << ",\n"
+        << indent << "  \"deadline_misses\": " << stats.deadline_misses() << ",\n"
+        << indent << "  \"percentiles_ns\": {";
+    for (size_t k = 0; k < pct.size(); ++k) {
+        out << (k == 0 ? "" : ", ") << "\"" << EXPORT_PERCENTILE_KEYS[k] << "\": " << pct[k];
+    }
+    out << "},\n"
+        << indent << "  \"bins\": [";
+    
+    // Cases non vides uniquement : quelques centaines au plus sur 4352
+    bool first = true;
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        const uint64_t count = histogram.bucket_count_at(i);
+        if (count == 0) continue;
+        out << (first ? "\n" : ",\n") << indent << "    {\"lower_ns\": "
+            << LatencyHistogram::bucket_lower_bound(i) << ", \"width_ns\": "
+            << LatencyHistogram::bucket_width(i) << ", \"count\": " << count << "}";
+        first = false;
+    }
+    out << (first ? "]" : "\n" + std::string(indent) + "  ]") << "\n" << indent << "}";
+}
+
+/**
+ * @brief Document JSON complet d'une exécution
+ * 
+ * @param out Destination (sortie standard en général)
+ * @param info Paramètres et instantané système
+ * @param runs Mesures, dans l'ordre d'affichage
+ */
+inline void write_json_results(std::ostream& out, const ExportInfo& info, const std::vector<ExportRun>& runs)
+{
+    out << std::setprecision(6) << std::fixed;
+    out << "{\n  \"tool\": \"rt_tuto\",\n  \"config\": {";
+    for (size_t k = 0; k < info.config.size(); ++k) {
+        out << (k == 0 ? "\n" : ",\n") << "    " << json_quote(info.config[k].first) << ": "
+            << json_value(info.config[k].second);
+    }
+    out << "\n  },\n  \"system\": {";
+    const auto system = snapshot_pairs(info.system_snapshot);
+    for (size_t k = 0; k < system.size(); ++k) {
+        out << (k == 0 ? "\n" : ",\n") << "    " << json_quote(system[k].first) << ": "
+            << json_quote(system[k].second);
+    }
+    out << (system.empty() ? "" : "\n  ") << "},\n  \"runs\": [";
+    
+    for (size_t r = 0; r < runs.size(); ++r) {
+        const TaskStats& stats = *runs[r].stats;
+        out << (r == 0 ? "\n" : ",\n") << "    {\n"
+            << "      \"name\": " << json_quote(runs[r].name) << ",\n"
+            << "      \"latency\": ";
+        write_json_histogram(out, stats.histogram, "      ");
+        if (!stats.exec_histogram.empty()) {
+            out << ",\n      \"exec\": ";
+            write_json_histogram(out, stats.exec_histogram, "      ");
+        }
+        out << ",\n      \"overruns\": {\"cycles\": " << stats.overruns.cycles()
+            << ", \"overruns\": " << stats.overruns.overruns()
+            << ", \"missed_periods\": " << stats.overruns.missed_periods()
+            << ", \"longest_streak\": " << stats.overruns.longest_streak()
+            << ", \"max_overrun_ns\": " << stats.overruns.max_overrun_ns() << "},\n"
+            << "      \"memory\": {\"minor_faults\": " << stats.memory.minor_faults
+            << ", \"major_faults\": " << stats.memory.major_faults
+            << ", \"allocations\": " << stats.memory.allocations << "}";
+        if (stats.instrument.measured) {
+            out << ",\n      \"instrument\": {\"read_min_ns\": " << stats.instrument.read_min_ns
+                << ", \"read_p50_ns\": " << stats.instrument.read_p50_ns
+                << ", \"read_max_ns\": " << stats.instrument.read_max_ns
+                << ", \"subtracted\": " << (stats.instrument.subtracted ? "true" : "false") << "}";
+        }
+        out << "\n    }";
+    }
+    out << (runs.empty() ? "]" : "\n  ]") << "\n}" << std::endl;
+}
+
+// ============================================================================
+// CSV
+// ============================================================================
+
+/// Lignes CSV d'un histogramme (section = "latency" ou "exec")
+inline void write_csv_histogram(std::ostream& out, const std::string& run, const std::string& section,
+                                const LatencyHistogram& histogram)
+{
+    const RunningStats& stats = histogram.stats();
+    std::vector<uint64_t> pct = calculate_percentiles(
+        histogram, std::vector<double>(std::begin(STANDARD_PERCENTILES), std::end(STANDARD_PERCENTILES)));
+    const std::string prefix = csv_field(run) + "," + section + ",";
+    
+    out << prefix << "count," << stats.count() << "\n"
+        << prefix << "min_ns," << stats.min_ns() << "\n"
+        << prefix << "max_ns," << stats.max_ns() << "\n"
+        << prefix << "mean_ns," << stats.mean_ns() << "\n"
+        << prefix << "stddev_ns," << stats.stddev_ns() << "\n"
+        << prefix << "deadline_ns," << stats.deadline_ns() << "\n"
+        << prefix << "deadline_misses," << stats.deadline_misses() << "\n";
+    for (size_t k = 0; k < pct.size(); ++k) {
+        out << prefix << EXPORT_PERCENTILE_KEYS[k] << "_ns," << pct[k] << "\n";
+    }
+    // Cases : clé = borne inférieure (ns), largeur donnée par LatencyHistogram::bucket_width()
+    for (size_t i = 0; i < LatencyHistogram::BUCKET_COUNT; ++i) {
+        const uint64_t count = histogram.bucket_count_at(i);
+        if (count == 0) continue;
+        out << csv_field(run) << "," << section << "_bin," << LatencyHistogram::bucket_lower_bound(i)
+            << "," << count << "\n";
+    }
+}
+
+/**
+ * @brief Résultats en CSV « long » : run,section,key,value
+ * 
+ * Configuration et système ont un run vide ; les cases d'histogramme sont
+ * dans les sections latency_bin / exec_bin.
+ */
+inline void write_csv_results(std::ostream& out, const ExportInfo& info, const std::vector<ExportRun>& runs)
+{
+    out << std::setprecision(3) << std::fixed;
+    out << "run,section,key,value\n";
+    for (const auto& field : info.config) {
+        out << ",config," << csv_field(field.first) << "," << csv_field(field.second) << "\n";
+    }
+    for (const auto& field : snapshot_pairs(info.system_snapshot)) {
+        out << ",system," << csv_field(field.first) << "," << csv_field(field.second) << "\n";
+    }
+    for (const ExportRun& run : runs) {
+        const TaskStats& stats = *run.stats;
+        write_csv_histogram(out, run.name, "latency", stats.histogram);
+        if (!stats.exec_histogram.empty()) {
+            write_csv_histogram(out, run.name, "exec", stats.exec_histogram);
+        }
+        const std::string prefix = csv_field(run.name) + ",";
+        out << prefix << "overruns,cycles," << stats.overruns.cycles() << "\n"
+            << prefix << "overruns,overruns," << stats.overruns.overruns() << "\n"
+            << prefix << "overruns,missed_periods," << stats.overruns.missed_periods() << "\n"
+            << prefix << "overruns,longest_streak," << stats.overruns.longest_streak() << "\n"
+            << prefix << "overruns,max_overrun_ns," << stats.overruns.max_overrun_ns() << "\n"
+            << prefix << "memory,minor_faults," << stats.memory.minor_faults << "\n"
+            << prefix << "memory,major_faults," << stats.memory.major_faults << "\n"
+            << prefix << "memory,allocations," << stats.memory.allocations << "\n";
+    }
+    out.flush();
+}
+
+// ============================================================================
+// EXPOSITION PROMETHEUS (TEXTFILE COLLECTOR)
+// ============================================================================
+
+/// Bornes des cases Prometheus (µs) : de l'excellent au très mauvais
+constexpr uint64_t PROMETHEUS_BUCKETS_US[] = {5, 10, 20, 50, 100, 200, 500, 1000, 2000, 5000, 10000};
+
+/**
+ * @brief Échantillons de valeur ≤ value_ns, à la précision d'une case près
+ * 
+ * La case qui contient value_ns est comptée entière : l'erreur est au plus
+ * la largeur relative d'une case (< 1 %).
+ */
+inline uint64_t histogram_count_at_or_below(const LatencyHistogram& histogram, uint64_t value_ns)
+{
+    const size_t last = LatencyHistogram::bucket_index(value_ns);
+    uint64_t count = 0;
+    for (size_t i = 0; i <= last; ++i) {
+        count += histogram.bucket_count_at(i);
+    }
+    return count;
+}
+
+/**
+ * @brief Métriques au format d'exposition Prometheus
+ * 
+ * @param out Destination
+ * @param latency Latences reçues par le thread de rapport
+ * @param dropped Échantillons perdus par la file RT → rapport
+ * @param cpu CPU mesuré (étiquette)
+ * @param window Dernière fenêtre fermée en mode --soak (NULL sinon)
+ */
+inline void write_prometheus_metrics(std::ostream& out, const LatencyHistogram& latency, uint64_t dropped,
+                                     int cpu, const WindowSummary* window)
+{
+    const std::string labels = "cpu=\"" + std::to_string(cpu) + "\"";
+    const RunningStats& stats = latency.stats();
+    out << std::setprecision(9) << std::fixed;
+    
+    out << "# HELP rt_tuto_latency_seconds Latence de réveil du thread temps réel.\n"
+        << "# TYPE rt_tuto_latency_seconds histogram\n";
+    for (uint64_t bound_us : PROMETHEUS_BUCKETS_US) {
+        out << "rt_tuto_latency_seconds_bucket{" << labels << ",le=\""
+            << static_cast<double>(bound_us) / 1e6 << "\"} "
+            << histogram_count_at_or_below(latency, bound_us * 1000) << "\n";
+    }
+    out << "rt_tuto_latency_seconds_bucket{" << labels << ",le=\"+Inf\"} " << stats.count() << "\n"
+        << "rt_tuto_latency_seconds_sum{" << labels << "} "
+        << stats.mean_ns() * static_cast<double>(stats.count()) / 1e9 << "\n"
+        << "rt_tuto_latency_seconds_count{" << labels << "} " << stats.count() << "\n";
+    
+    out << "# HELP rt_tuto_latency_max_seconds Pire latence depuis le début de la mesure.\n"
+        << "# TYPE rt_tuto_latency_max_seconds gauge\n"
+        << "rt_tuto_latency_max_seconds{" << labels << "} " << static_cast<double>(stats.max_ns()) / 1e9 << "\n";
+    
+    out << "# HELP rt_tuto_deadline_misses_total Réveils au-delà de la deadline.\n"
+        << "# TYPE rt_tuto_deadline_misses_total counter\n"
+        << "rt_tuto_deadline_misses_total{" << labels << "} " << stats.deadline_misses() << "\n";
+    
+    out << "# HELP rt_tuto_samples_dropped_total Échantillons perdus avant le rapport (file pleine).\n"
+        << "# TYPE rt_tuto_samples_dropped_total counter\n"
+        << "rt_tuto_samples_dropped_total{" << labels << "} " << dropped << "\n";
+    
+    if (window != nullptr) {
+        out << "# HELP rt_tuto_window_latency_seconds Dernière fenêtre fermée du rodage (--soak).\n"
+            << "# TYPE rt_tuto_window_latency_seconds gauge\n"
+            << "rt_tuto_window_latency_seconds{" << labels << ",quantile=\"0.99\"} "
+            << static_cast<double>(window->p99_ns) / 1e9 << "\n"
+            << "rt_tuto_window_latency_seconds{" << labels << ",quantile=\"0.999\"} "
+            << static_cast<double>(window->p999_ns) / 1e9 << "\n"
+            << "rt_tuto_window_latency_seconds{" << labels << ",quantile=\"1\"} "
+            << static_cast<double>(window->max_ns) / 1e9 << "\n";
+    }
+}
+
+/**
+ * @brief Remplace atomiquement un fichier (écriture dans <path>.tmp puis rename)
+ * 
+ * Le textfile collector ne doit jamais lire un fichier à moitié écrit.
+ * 
+ * @param path Fichier final (extension .prom pour node_exporter)
+ * @param content Contenu complet
+ * @param error Explication en cas d'échec
+ * @return true si le fichier a été remplacé
+ */
+inline bool replace_file(const std::string& path, const std::string& content, std::string& error)
+{
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::trunc);
+        file << content;
+        file.flush();
+        if (!file) {
+            error = "écriture de " + tmp + " impossible";
+            return false;
+        }
+    }
+    if (rename(tmp.c_str(), path.c_str()) != 0) {
+        error = "rename(" + path + ") : " + strerror(errno);
+        return false;
+    }
+    return true;
+}
+
+#endif // RT_EXPORT_H
@@ -0,0 +1,311 @@
+/**
+ * @file rt_ftrace.h
+ * @brief Instantané ftrace déclenché par le dépassement d'un seuil de latence
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Un pic de latence isolé ne dit pas POURQUOI le thread s'est réveillé en
+ * retard. Comme l'option -b de cyclictest, ce fichier :
+ * 
+ * 1. active avant la mesure quelques événements du kernel (changements de
+ *    contexte, interruptions, hrtimers) dans le tampon circulaire de ftrace,
+ *    limité au CPU mesuré ;
+ * 2. au premier échantillon au-dessus du seuil, écrit un marqueur dans la
+ *    trace, puis arrête l'enregistrement : le tampon contient alors les
+ *    instants qui précèdent le pic ;
+ * 3. après la mesure, recopie la trace du CPU dans un fichier et restaure
+ *    l'état initial de ftrace.
+ * 
+ * Le déclenchement ne fait que deux write() sur des descripteurs ouverts à
+ * l'avance : aucune allocation, aucune ouverture de fichier dans la boucle.
+ * 
+ * Prérequis : tracefs monté (/sys/kernel/tracing), droits root.
+ */
+
+#ifndef RT_FTRACE_H
+#define RT_FTRACE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Événements activés par défaut (syntaxe "sous-système:événement")
+constexpr const char* DEFAULT_BREAK_EVENTS =
+    "sched:sched_switch,sched:sched_wakeup,"
+    "irq:irq_handler_entry,irq:irq_handler_exit,irq:softirq_entry,"
+    "timer:hrtimer_expire_entry,timer:hrtimer_expire_exit";
+
+/// Fichier de sortie par défaut de la trace kernel
+constexpr const char* DEFAULT_BREAK_FILE = "rt_tuto_break.txt";
+
+/// Points de montage possibles de tracefs
+constexpr const char* TRACEFS_ROOTS[] = {"/sys/kernel/tracing", "/sys/kernel/debug/tracing"};
+
+// ============================================================================
+// INSTANTANÉ FTRACE
+// ============================================================================
+
+/**
+ * @brief Trace kernel armée avant la mesure, figée au premier pic
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * FtraceSnapshot ftrace;
+ * if (ftrace.arm(cpu, DEFAULT_BREAK_EVENTS)) {
+ *     // ... boucle RT : if (latency > seuil) ftrace.trigger(cycle, latency) ...
+ *     if (ftrace.triggered()) ftrace.dump("rt_tuto_break.txt");
+ *     ftrace.disarm();
+ * }
+ * @endcode
+ */
+class FtraceSnapshot {
+public:
+    FtraceSnapshot() = default;
+    FtraceSnapshot(const FtraceSnapshot&) = delete;
+    FtraceSnapshot& operator=(const FtraceSnapshot&) = delete;
+    ~FtraceSnapshot() { disarm(); }
+    
+    /**
+     * @brief Configure ftrace et démarre l'enregistrement
+     * 
+     * @param cpu CPU mesuré (seul CPU enregistré si cpu < 32)
+     * @param events Liste "sous-système:événement" séparée par des virgules
+     * @return true si l'enregistrement a démarré ; sinon error() décrit l'erreur
+     */
+    bool arm(int cpu, const std::string& events)
+    {
+        disarm();
+        cpu_ = cpu;
+        triggered_ = false;
+        
+        for (const char* candidate : TRACEFS_ROOTS) {
+            struct stat st;
+            std::string probe = std::string(candidate) + "/trace_marker";
+            if (stat(probe.c_str(), &st) == 0) {
+                root_ = candidate;
+                break;
+            }
+        }
+        if (root_.empty()) {
+            error_ = "tracefs introuvable (mount -t tracefs nodev /sys/kernel/tracing)";
+            return false;
+        }
+        
+        // État initial, restauré par disarm()
+        saved_tracing_on_ = read_file("tracing_on");
+        saved_cpumask_ = read_file("tracing_cpumask");
+        
+        // Tampon vidé (écriture de "trace"), puis enregistrement limité au CPU mesuré
+        if (!write_file("tracing_on", "0") || !write_file("trace", "")) {
+            disarm();
+            return false;
+        }
+        if (cpu_ >= 0 && cpu_ < 32) {
+            char mask[16];
+            snprintf(mask, sizeof(mask), "%x", 1u << cpu_);
+            if (!write_file("tracing_cpumask", mask)) {
+                disarm();
+                return false;
+            }
+            cpumask_changed_ = true;
+        }
+        
+        size_t start = 0;
+        while (start <= events.size()) {
+            size_t comma = events.find(',', start);
+            if (comma == std::string::npos) comma = events.size();
+            std::string event = events.substr(start, comma - start);
+            start = comma + 1;
+            if (event.empty()) continue;
+            
+            size_t colon = event.find(':');
+            if (colon == std::string::npos) {
+                error_ = "événement invalide (attendu sous-système:événement) : " + event;
+                disarm();
+                return false;
+            }
+            std::string path = "events/" + event.substr(0, colon) + "/" + event.substr(colon + 1) + "/enable";
+            if (!write_file(path, "1")) {
+                disarm();
+                return false;
+            }
+            enabled_events_.push_back(path);
+        }
+        
+        // Descripteurs ouverts maintenant : le déclenchement ne fera que write()
+        marker_fd_ = open((root_ + "/trace_marker").c_str(), O_WRONLY | O_CLOEXEC);
+        on_fd_ = open((root_ + "/tracing_on").c_str(), O_WRONLY | O_CLOEXEC);
+        if (marker_fd_ < 0 || on_fd_ < 0) {
+            error_ = std::string("ouverture de trace_marker/tracing_on : ") + strerror(errno);
+            disarm();
+            return false;
+        }
+        
+        if (!write_file("tracing_on", "1")) {
+            disarm();
+            return false;
+        }
+        armed_ = true;
+        return true;
+    }
+    
+    /**
+     * @brief Marque le pic dans la trace et fige l'enregistrement
+     * 
+     * Appelé depuis la boucle RT : deux write() sur des descripteurs déjà
+     * ouverts, aucun appel qui alloue. Seul le premier appel a un effet.
+     * 
+     * @param cycle Numéro du cycle fautif
+     * @param latency_ns Latence mesurée
+     */
+    void trigger(uint64_t cycle, uint64_t latency_ns)
+    {
+        if (!armed_ || triggered_) return;
+        triggered_ = true;
+        cycle_ = cycle;
+        latency_ns_ = latency_ns;
+        
+        char marker[96];
+        int len = snprintf(marker, sizeof(marker), "rt_tuto: latence %llu ns au cycle %llu\n",
+                           static_cast<unsigned long long>(latency_ns),
+                           static_cast<unsigned long long>(cycle));
+        if (len > 0) {
+            ssize_t ignored = write(marker_fd_, marker, static_cast<size_t>(len));
+            (void)ignored;
+        }
+        ssize_t ignored = write(on_fd_, "0", 1);
+        (void)ignored;
+    }
+    
+    /**
+     * @brief Recopie la trace du CPU mesuré dans un fichier
+     * 
+     * @param path Fichier de destination
+     * @return true si la copie a réussi ; sinon error() décrit l'erreur
+     */
+    bool dump(const std::string& path)
+    {
+        std::string source = root_ + "/trace";
+        if (cpumask_changed_) {
+            source = root_ + "/per_cpu/cpu" + std::to_string(cpu_) + "/trace";
+        }
+        int in = open(source.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in < 0) {
+            error_ = source + " : " + strerror(errno);
+            return false;
+        }
+        int out = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (out < 0) {
+            error_ = path + " : " + strerror(errno);
+            close(in);
+            return false;
+        }
+        
+        bool ok = true;
+        char buffer[65536];
+        ssize_t n;
+        while ((n = read(in, buffer, sizeof(buffer))) > 0) {
+            if (write(out, buffer, static_cast<size_t>(n)) != n) {
+                error_ = path + " : " + strerror(errno);
+                ok = false;
+                break;
+            }
+        }
+        close(in);
+        close(out);
+        return ok;
+    }
+    
+    /// Désactive les événements et restaure l'état initial de ftrace
+    void disarm()
+    {
+        if (marker_fd_ >= 0) close(marker_fd_);
+        if (on_fd_ >= 0) close(on_fd_);
+        marker_fd_ = on_fd_ = -1;
+        
+        if (root_.empty()) return;
+        write_file("tracing_on", "0");
+        for (const std::string& path : enabled_events_) {
+            write_file(path, "0");
+        }
+        enabled_events_.clear();
+        if (cpumask_changed_ && !saved_cpumask_.empty()) {
+            write_file("tracing_cpumask", saved_cpumask_);
+        }
+        cpumask_changed_ = false;
+        if (!saved_tracing_on_.empty()) {
+            write_file("tracing_on", saved_tracing_on_);
+        }
+        root_.clear();
+        armed_ = false;
+    }
+    
+    bool armed() const { return armed_; }                   ///< Enregistrement en cours ?
+    bool triggered() const { return triggered_; }           ///< Seuil franchi ?
+    uint64_t trigger_cycle() const { return cycle_; }       ///< Cycle du franchissement
+    uint64_t trigger_latency_ns() const { return latency_ns_; }   ///< Latence du franchissement
+    const std::string& error() const { return error_; }     ///< Dernière erreur
+
+private:
+    /// Contenu d'un fichier de tracefs, sans le saut de ligne final
+    std::string read_file(const std::string& name) const
+    {
+        std::string content;
+        int fd = open((root_ + "/" + name).c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return content;
+        char buffer[256];
+        ssize_t n = read(fd, buffer, sizeof(buffer) - 1);
+        close(fd);
+        if (n > 0) {
+            content.assign(buffer, static_cast<size_t>(n));
+            while (!content.empty() && (content.back() == '\n' || content.back() == ' ')) {
+                content.pop_back();
+            }
+        }
+        return content;
+    }
+    
+    /// Écrit une valeur dans un fichier de tracefs (O_TRUNC : "trace" vide le tampon)
+    bool write_file(const std::string& name, const std::string& value)
+    {
+        std::string path = root_ + "/" + name;
+        int fd = open(path.c_str(), O_WRONLY | O_TRUNC | O_CLOEXEC);
+        if (fd < 0) {
+            error_ = path + " : " + strerror(errno);
+            return false;
+        }
+        bool ok = value.empty() || write(fd, value.data(), value.size()) == static_cast<ssize_t>(value.size());
+        if (!ok) {
+            error_ = path + " : " + strerror(errno);
+        }
+        close(fd);
+        return ok;
+    }
+    
+    std::string root_;
+    int cpu_ = -1;
+    bool armed_ = false;
+    bool triggered_ = false;
+    bool cpumask_changed_ = false;
+    uint64_t cycle_ = 0;
+    uint64_t latency_ns_ = 0;
+    int marker_fd_ = -1;
+    int on_fd_ = -1;
+    std::string saved_tracing_on_;
+    std::string saved_cpumask_;
+    std::vector<std::string> enabled_events_;
+    std::string error_;
+};
+
+#endif // RT_FTRACE_H
@@ -0,0 +1,267 @@
+/**
+ * @file rt_gpio.h
+ * @brief Broche GPIO pilotée par registres et front d'entrée horodaté (--gpio)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Les latences affichées sont des horodatages logiciels : ce qui se passe
+ * avant le retour de clock_gettime() ou sur le chemin de sortie vers
+ * l'actionneur leur échappe. Une broche basculée à chaque cycle rend la
+ * boucle visible à un analyseur logique ou un oscilloscope, qui la mesure
+ * avec sa propre base de temps :
+ * 
+ * - GpioOutput : /dev/gpiomem projette les registres GPIO du BCM2711 en
+ *   espace utilisateur. Monter ou descendre la broche est UNE écriture en
+ *   mémoire (registres GPSET0/GPCLR0) : aucun appel système dans la boucle.
+ * - GpioEdgeInput : une broche d'entrée reliée à la sortie est demandée au
+ *   kernel (/dev/gpiochipN, ABI v2) avec détection des fronts montants. Le
+ *   kernel horodate le front dans son gestionnaire d'interruption
+ *   (CLOCK_MONOTONIC) ; le thread RT le lit par read() après son réveil.
+ * 
+ * Aller-retour d'un cycle (sortie reliée à l'entrée par un fil) :
+ * 
+ *   t0 écriture GPSET0 ──► t_irq front vu par le kernel ──► t1 read() rendu
+ *      └──── sortie → IRQ ────┘└──────── IRQ → espace utilisateur ───┘
+ * 
+ * Registres : disposition commune aux BCM2835/6/7 et BCM2711 (Raspberry Pi
+ * 1 à 4). Le Raspberry Pi 5 (RP1) a une autre disposition : non supporté.
+ * Prérequis : /dev/gpiomem accessible (groupe gpio ou root).
+ */
+
+#ifndef RT_GPIO_H
+#define RT_GPIO_H
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <linux/gpio.h>
+#include <string>
+
+// ============================================================================
+// CONFIGURATION
+// ============================================================================
+
+/// Registres GPIO projetés par le kernel (sans accès au reste de /dev/mem)
+constexpr const char* GPIO_MEM_DEVICE = "/dev/gpiomem";
+
+/// Contrôleur GPIO principal du Raspberry Pi 4 (broches du connecteur)
+constexpr const char* DEFAULT_GPIO_CHIP = "/dev/gpiochip0";
+
+/// Dernière broche du BCM2711 (GPIO 0 à 57 ; connecteur : 2 à 27)
+constexpr int GPIO_MAX_PIN = 57;
+
+/// Taille projetée : le bloc GPIO tient dans une page
+constexpr size_t GPIO_MAP_SIZE = 4096;
+
+/// Index (mots de 32 bits) des registres utilisés
+constexpr size_t GPIO_REG_FSEL0 = 0x00 / 4;   ///< GPFSEL0..5 : fonction, 3 bits par broche
+constexpr size_t GPIO_REG_SET0 = 0x1C / 4;    ///< GPSET0..1 : 1 = niveau haut
+constexpr size_t GPIO_REG_CLR0 = 0x28 / 4;    ///< GPCLR0..1 : 1 = niveau bas
+constexpr size_t GPIO_REG_LEV0 = 0x34 / 4;    ///< GPLEV0..1 : niveau lu
+
+/// Code de fonction « sortie » dans GPFSELn
+constexpr uint32_t GPIO_FSEL_OUTPUT = 1;
+
+// ============================================================================
+// SORTIE PAR REGISTRES (/dev/gpiomem)
+// ============================================================================
+
+/**
+ * @brief Broche de sortie basculée par écriture directe des registres
+ * 
+ * La fonction d'origine de la broche est restaurée à la fermeture.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * GpioOutput pin;
+ * if (pin.open(17)) {
+ *     // ... boucle RT : pin.set() au réveil, pin.clear() en fin de cycle ...
+ *     pin.close();
+ * }
+ * @endcode
+ */
+class GpioOutput {
+public:
+    GpioOutput() = default;
+    GpioOutput(const GpioOutput&) = delete;
+    GpioOutput& operator=(const GpioOutput&) = delete;
+    ~GpioOutput() { close(); }
+    
+    /**
+     * @brief Projette les registres et passe la broche en sortie, niveau bas
+     * 
+     * @param pin Numéro BCM de la broche (0 à GPIO_MAX_PIN)
+     * @return true si la broche est prête ; sinon error() décrit l'erreur
+     */
+    bool open(int pin)
+    {
+        close();
+        if (pin < 0 || pin > GPIO_MAX_PIN) {
+            error_ = "broche hors limites : " + std::to_string(pin);
+            return false;
+        }
+        int fd = ::open(GPIO_MEM_DEVICE, O_RDWR | O_SYNC | O_CLOEXEC);
+        if (fd < 0) {
+            error_ = std::string(GPIO_MEM_DEVICE) + " : " + strerror(errno);
+            return false;
+        }
+        void* map = mmap(nullptr, GPIO_MAP_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        ::close(fd);   // la projection reste valide
+        if (map == MAP_FAILED) {
+            error_ = std::string("mmap ") + GPIO_MEM_DEVICE + " : " + strerror(errno);
+            return false;
+        }
+        
+        regs_ = static_cast<volatile uint32_t*>(map);
+        pin_ = pin;
+        const size_t bank = static_cast<size_t>(pin) / 32;
+        mask_ = 1u << (static_cast<unsigned>(pin) % 32);
+        set_reg_ = regs_ + GPIO_REG_SET0 + bank;
+        clr_reg_ = regs_ + GPIO_REG_CLR0 + bank;
+        
+        // Niveau bas avant le passage en sortie : pas d'impulsion parasite
+        *clr_reg_ = mask_;
+        volatile uint32_t* fsel = regs_ + GPIO_REG_FSEL0 + static_cast<size_t>(pin) / 10;
+        const unsigned shift = (static_cast<unsigned>(pin) % 10) * 3;
+        saved_function_ = (*fsel >> shift) & 7u;
+        *fsel = (*fsel & ~(7u << shift)) | (GPIO_FSEL_OUTPUT << shift);
+        return true;
+    }
+    
+    /// Remet la broche au niveau bas, dans sa fonction d'origine, et libère la projection
+    void close()
+    {
+        if (regs_ == nullptr) return;
+        *clr_reg_ = mask_;
+        volatile uint32_t* fsel = regs_ + GPIO_REG_FSEL0 + static_cast<size_t>(pin_) / 10;
+        const unsigned shift = (static_cast<unsigned>(pin_) % 10) * 3;
+        *fsel = (*fsel & ~(7u << shift)) | (saved_function_ << shift);
+        munmap(const_cast<uint32_t*>(regs_), GPIO_MAP_SIZE);
+        regs_ = nullptr;
+        pin_ = -1;
+    }
+    
+    /// Niveau haut : une écriture dans GPSETn
+    void set() { *set_reg_ = mask_; }
+    
+    /// Niveau bas : une écriture dans GPCLRn
+    void clear() { *clr_reg_ = mask_; }
+    
+    /// Niveau lu sur la broche (GPLEVn)
+    bool level() const
+    {
+        return (regs_[GPIO_REG_LEV0 + static_cast<size_t>(pin_) / 32] & mask_) != 0;
+    }
+    
+    bool opened() const { return regs_ != nullptr; }       ///< Broche prête ?
+    int pin() const { return pin_; }                       ///< Numéro BCM
+    const std::string& error() const { return error_; }    ///< Dernière erreur
+
+private:
+    volatile uint32_t* regs_ = nullptr;
+    volatile uint32_t* set_reg_ = nullptr;
+    volatile uint32_t* clr_reg_ = nullptr;
+    uint32_t mask_ = 0;
+    uint32_t saved_function_ = 0;
+    int pin_ = -1;
+    std::string error_;
+};
+
+// ============================================================================
+// FRONT D'ENTRÉE HORODATÉ PAR LE KERNEL (/dev/gpiochipN)
+// ============================================================================
+
+/**
+ * @brief Broche d'entrée dont les fronts montants réveillent le thread
+ * 
+ * Le descripteur est ouvert avant la boucle ; chaque attente coûte un
+ * poll() et un read(), le chemin mesuré par l'aller-retour.
+ */
+class GpioEdgeInput {
+public:
+    GpioEdgeInput() = default;
+    GpioEdgeInput(const GpioEdgeInput&) = delete;
+    GpioEdgeInput& operator=(const GpioEdgeInput&) = delete;
+    ~GpioEdgeInput() { close(); }
+    
+    /**
+     * @brief Demande la broche en entrée, tirage au niveau bas, fronts montants
+     * 
+     * @param chip Contrôleur GPIO (ex. /dev/gpiochip0)
+     * @param pin Numéro de la ligne sur ce contrôleur (numéro BCM sur le Pi 4)
+     * @return true si la ligne est prête ; sinon error() décrit l'erreur
+     */
+    bool open(const std::string& chip, int pin)
+    {
+        close();
+        int chip_fd = ::open(chip.c_str(), O_RDWR | O_CLOEXEC);
+        if (chip_fd < 0) {
+            error_ = chip + " : " + strerror(errno);
+            return false;
+        }
+        
+        struct gpio_v2_line_request request;
+        memset(&request, 0, sizeof(request));
+        request.offsets[0] = static_cast<uint32_t>(pin);
+        request.num_lines = 1;
+        strncpy(request.consumer, "rt_tuto", sizeof(request.consumer) - 1);
+        request.config.flags = GPIO_V2_LINE_FLAG_INPUT | GPIO_V2_LINE_FLAG_EDGE_RISING
+                             | GPIO_V2_LINE_FLAG_BIAS_PULL_DOWN;
+        request.event_buffer_size = 16;
+        
+        int err = ioctl(chip_fd, GPIO_V2_GET_LINE_IOCTL, &request);
+        if (err < 0) {
+            error_ = chip + " ligne " + std::to_string(pin) + " : " + strerror(errno);
+        }
+        ::close(chip_fd);
+        if (err < 0) return false;
+        line_fd_ = request.fd;
+        return true;
+    }
+    
+    void close()
+    {
+        if (line_fd_ >= 0) ::close(line_fd_);
+        line_fd_ = -1;
+    }
+    
+    /**
+     * @brief Attend le prochain front montant
+     * 
+     * @param timeout_ms Attente maximale
+     * @param timestamp_ns Instant CLOCK_MONOTONIC du front, pris par le kernel
+     * @return false si aucun front n'est arrivé à temps
+     */
+    bool wait(int timeout_ms, uint64_t& timestamp_ns)
+    {
+        struct pollfd pfd = {line_fd_, POLLIN, 0};
+        if (poll(&pfd, 1, timeout_ms) <= 0) return false;
+        struct gpio_v2_line_event event;
+        if (read(line_fd_, &event, sizeof(event)) != static_cast<ssize_t>(sizeof(event))) return false;
+        timestamp_ns = event.timestamp_ns;
+        return true;
+    }
+    
+    /// Fronts en attente (arrivés hors attente) jetés avant la mesure suivante
+    void drain()
+    {
+        uint64_t ignored;
+        while (wait(0, ignored)) {
+        }
+    }
+    
+    bool opened() const { return line_fd_ >= 0; }          ///< Ligne prête ?
+    const std::string& error() const { return error_; }    ///< Dernière erreur
+
+private:
+    int line_fd_ = -1;
+    std::string error_;
+};
+
+#endif // RT_GPIO_H
@@ -0,0 +1,210 @@
+/**
+ * @file rt_interference.h
+ * @brief Compteurs d'interruptions et de changements de contexte autour de la mesure
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Un CPU isolé n'est jamais totalement silencieux : tick, IPIs, IRQs de
+ * périphériques mal routées, softirqs. Pour expliquer la gigue mesurée, ce
+ * fichier relève avant et après la mesure :
+ * 
+ * - /proc/interrupts : compteur de chaque IRQ pour le CPU mesuré
+ * - /proc/softirqs   : compteur de chaque type de softirq pour ce CPU
+ * - /proc/thread-self/status : changements de contexte volontaires (le
+ *   thread s'endort) et involontaires (il est préempté) du thread RT
+ * 
+ * La différence indique exactement ce qui a interrompu le CPU pendant la
+ * fenêtre de mesure, et donc ce qu'il faut re-router.
+ * 
+ * Les deux relevés lisent des fichiers de /proc (allocations, appels
+ * système) : ils encadrent la boucle temps réel et n'y entrent jamais.
+ */
+
+#ifndef RT_INTERFERENCE_H
+#define RT_INTERFERENCE_H
+
+#include <ctype.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// RELEVÉ DES COMPTEURS
+// ============================================================================
+
+/**
+ * @brief Compteurs d'interférence d'un CPU et d'un thread à un instant donné
+ */
+struct InterferenceSample {
+    bool valid = false;
+    std::map<std::string, uint64_t> irqs;       ///< Source → interruptions sur le CPU
+    std::map<std::string, uint64_t> softirqs;   ///< Type → softirqs sur le CPU
+    uint64_t voluntary_switches = 0;            ///< Le thread s'est endormi
+    uint64_t involuntary_switches = 0;          ///< Le thread a été préempté
+};
+
+/**
+ * @brief Lit un tableau par CPU de /proc (interrupts, softirqs)
+ * 
+ * Première ligne : "CPU0 CPU1 ..." (CPUs en ligne uniquement) ; lignes
+ * suivantes : "<source>: <compteur par CPU> [description]".
+ * 
+ * @param path Fichier à lire
+ * @param cpu CPU dont on garde la colonne
+ * @param describe Ajouter la description (nom du gestionnaire) à la source
+ * @param counters Compteurs lus
+ * @return false si le fichier ou la colonne du CPU est introuvable
+ */
+inline bool read_per_cpu_table(const char* path, int cpu, bool describe,
+                               std::map<std::string, uint64_t>& counters)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file || !std::getline(file, line)) return false;
+    
+    // Position de la colonne "CPU<n>"
+    std::istringstream header(line);
+    std::string column;
+    const std::string wanted = "CPU" + std::to_string(cpu);
+    int index = -1;
+    int ncols = 0;
+    while (header >> column) {
+        if (column == wanted) index = ncols;
+        ++ncols;
+    }
+    if (index < 0) return false;
+    
+    while (std::getline(file, line)) {
+        std::istringstream fields(line);
+        std::string source;
+        if (!(fields >> source) || source.back() != ':') continue;
+        source.pop_back();
+        
+        uint64_t value = 0;
+        int col = 0;
+        std::string token;
+        for (; col < ncols && fields >> token; ++col) {
+            if (token.find_first_not_of("0123456789") != std::string::npos) break;
+            if (col == index) value = strtoull(token.c_str(), nullptr, 10);
+        }
+        if (col <= index) continue;   // Ligne sans colonne par CPU (ERR, MIS)
+        
+        if (describe) {
+            /*
+             * IRQ numérotée : le dernier mot est le nom du gestionnaire
+             * (ex. "arch_timer", "mmc1") ; IRQ nommée (LOC, RES...) : toute
+             * la description ("Local timer interrupts").
+             */
+            std::string rest, word;
+            std::getline(fields, rest);
+            std::istringstream words(rest);
+            std::string description;
+            while (words >> word) {
+                if (isdigit(static_cast<unsigned char>(source[0]))) {
+                    description = word;
+                } else {
+                    description += (description.empty() ? "" : " ") + word;
+                }
+            }
+            if (!description.empty()) source += " " + description;
+        }
+        counters[source] = value;
+    }
+    return true;
+}
+
+/**
+ * @brief Relève les compteurs du CPU mesuré et du thread appelant
+ * 
+ * @param cpu CPU sur lequel tourne le thread RT
+ */
+inline InterferenceSample sample_interference(int cpu)
+{
+    InterferenceSample sample;
+    sample.valid = read_per_cpu_table("/proc/interrupts", cpu, true, sample.irqs);
+    read_per_cpu_table("/proc/softirqs", cpu, false, sample.softirqs);
+    
+    std::ifstream status("/proc/thread-self/status");
+    std::string key;
+    uint64_t value;
+    while (status >> key) {
+        if (key == "voluntary_ctxt_switches:" && status >> value) {
+            sample.voluntary_switches = value;
+        } else if (key == "nonvoluntary_ctxt_switches:" && status >> value) {
+            sample.involuntary_switches = value;
+        }
+    }
+    return sample;
+}
+
+// ============================================================================
+// BILAN DE LA FENÊTRE DE MESURE
+// ============================================================================
+
+/**
+ * @brief Interférences subies par le CPU mesuré pendant la fenêtre
+ */
+struct InterferenceStats {
+    bool measured = false;   ///< Faux en mode multi-threads et --analyze
+    int cpu = -1;
+    std::vector<std::pair<std::string, uint64_t>> irqs;       ///< Sources non nulles, décroissantes
+    std::vector<std::pair<std::string, uint64_t>> softirqs;   ///< Types non nuls, décroissants
+    uint64_t voluntary_switches = 0;
+    uint64_t involuntary_switches = 0;
+    
+    /// Total des IRQs reçues par le CPU
+    uint64_t total_irqs() const
+    {
+        uint64_t total = 0;
+        for (const auto& irq : irqs) total += irq.second;
+        return total;
+    }
+};
+
+/// Différences non nulles, de la plus grande à la plus petite
+inline std::vector<std::pair<std::string, uint64_t>> counter_deltas(
+    const std::map<std::string, uint64_t>& before, const std::map<std::string, uint64_t>& after)
+{
+    std::vector<std::pair<std::string, uint64_t>> deltas;
+    for (const auto& entry : after) {
+        auto it = before.find(entry.first);
+        uint64_t start = it != before.end() ? it->second : 0;
+        if (entry.second > start) {
+            deltas.emplace_back(entry.first, entry.second - start);
+        }
+    }
+    std::sort(deltas.begin(), deltas.end(),
+              [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+                  return a.second > b.second;
+              });
+    return deltas;
+}
+
+/**
+ * @brief Bilan entre deux relevés
+ * 
+ * @param cpu CPU mesuré
+ * @param before Relevé avant la boucle
+ * @param after Relevé après la boucle
+ */
+inline InterferenceStats diff_interference(int cpu, const InterferenceSample& before,
+                                           const InterferenceSample& after)
+{
+    InterferenceStats stats;
+    if (!before.valid || !after.valid) return stats;
+    stats.measured = true;
+    stats.cpu = cpu;
+    stats.irqs = counter_deltas(before.irqs, after.irqs);
+    stats.softirqs = counter_deltas(before.softirqs, after.softirqs);
+    stats.voluntary_switches = after.voluntary_switches - before.voluntary_switches;
+    stats.involuntary_switches = after.involuntary_switches - before.involuntary_switches;
+    return stats;
+}
+
+#endif // RT_INTERFERENCE_H
@@ -0,0 +1,347 @@
+/**
+ * @file rt_ipc.h
+ * @brief Canaux de messagerie entre le thread temps réel et un thread non-RT
+ *
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ *
+ * Un thread RT doit confier ses données à des threads de journalisation ou
+ * de réseau sans hériter de leurs retards. Ce fichier fournit cinq canaux
+ * d'un message (un mot de 64 bits), de même interface send() / receive(),
+ * pour comparer leur coût (--ipc) :
+ *
+ * - pi-mutex : pthread_mutex PTHREAD_PRIO_INHERIT + pthread_cond ; le
+ *              détenteur du verrou hérite de la priorité du thread RT qui
+ *              l'attend (pas d'inversion de priorité non bornée)
+ * - futex    : compteur atomique + FUTEX_WAKE seulement si le récepteur dort
+ * - eventfd  : compteur du kernel, write() / read() bloquant
+ * - spsc     : file SpscRing sans verrou (rt_utils.h), réception par scrutation
+ * - seqlock  : instantané d'une ligne de cache publié par compteur de
+ *              séquence ; le lecteur ne bloque jamais l'écrivain
+ *
+ * Les canaux à scrutation (spsc, seqlock) n'entrent jamais dans le kernel,
+ * mais le récepteur occupe son CPU : les deux threads doivent être sur des
+ * CPUs différents.
+ */
+
+#ifndef RT_IPC_H
+#define RT_IPC_H
+
+#include <pthread.h>
+#include <stdint.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+#include <atomic>
+#include <string>
+
+#include "rt_utils.h"
+
+// ============================================================================
+// PRIMITIVES COMPARÉES
+// ============================================================================
+
+/**
+ * @brief Primitive de messagerie RT → non-RT
+ */
+enum class IpcPrimitive {
+    PI_MUTEX,   ///< Mutex à héritage de priorité + variable de condition
+    FUTEX,      ///< futex(2) direct
+    EVENTFD,    ///< eventfd(2)
+    SPSC,       ///< File sans verrou, réception par scrutation
+    SEQLOCK     ///< Verrou de séquence, réception par scrutation
+};
+
+/// Toutes les primitives, dans l'ordre du comparatif (--ipc all)
+constexpr IpcPrimitive ALL_IPC_PRIMITIVES[] = {
+    IpcPrimitive::PI_MUTEX, IpcPrimitive::FUTEX, IpcPrimitive::EVENTFD,
+    IpcPrimitive::SPSC, IpcPrimitive::SEQLOCK
+};
+
+/// Valeur réservée : demande d'arrêt du thread pair
+constexpr uint64_t IPC_STOP = UINT64_MAX;
+
+/**
+ * @brief Nom d'une primitive (tel qu'accepté par --ipc)
+ */
+inline const char* ipc_primitive_name(IpcPrimitive primitive)
+{
+    switch (primitive) {
+        case IpcPrimitive::FUTEX:   return "futex";
+        case IpcPrimitive::EVENTFD: return "eventfd";
+        case IpcPrimitive::SPSC:    return "spsc";
+        case IpcPrimitive::SEQLOCK: return "seqlock";
+        default:                    return "pi-mutex";
+    }
+}
+
+/**
+ * @brief Convertit un nom de primitive
+ *
+ * @return true si le nom est connu
+ */
+inline bool parse_ipc_primitive(const std::string& name, IpcPrimitive& primitive)
+{
+    for (IpcPrimitive candidate : ALL_IPC_PRIMITIVES) {
+        if (name == ipc_primitive_name(candidate)) {
+            primitive = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Réception par attente active (récepteur et émetteur sur des CPUs distincts)
+inline bool ipc_primitive_polls(IpcPrimitive primitive)
+{
+    return primitive == IpcPrimitive::SPSC || primitive == IpcPrimitive::SEQLOCK;
+}
+
+/**
+ * @brief Pause d'une itération d'attente active
+ *
+ * yield (ARM) / pause (x86) : libère les ressources partagées du cœur et
+ * réduit la consommation sans rendre le CPU au scheduler.
+ */
+inline void cpu_relax()
+{
+#if defined(__aarch64__) || defined(__arm__)
+    __asm__ __volatile__("yield" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+// ============================================================================
+// CANAUX BLOQUANTS
+// ============================================================================
+
+/**
+ * @brief Message unique protégé par un mutex PTHREAD_PRIO_INHERIT
+ */
+class PiMutexChannel {
+public:
+    PiMutexChannel()
+    {
+        pthread_mutexattr_t mattr;
+        pthread_mutexattr_init(&mattr);
+        pthread_mutexattr_setprotocol(&mattr, PTHREAD_PRIO_INHERIT);
+        pthread_mutex_init(&mutex_, &mattr);
+        pthread_mutexattr_destroy(&mattr);
+
+        pthread_condattr_t cattr;
+        pthread_condattr_init(&cattr);
+        pthread_condattr_setclock(&cattr, CLOCK_MONOTONIC);
+        pthread_cond_init(&cond_, &cattr);
+        pthread_condattr_destroy(&cattr);
+    }
+    PiMutexChannel(const PiMutexChannel&) = delete;
+    PiMutexChannel& operator=(const PiMutexChannel&) = delete;
+    ~PiMutexChannel()
+    {
+        pthread_cond_destroy(&cond_);
+        pthread_mutex_destroy(&mutex_);
+    }
+
+    void send(uint64_t value)
+    {
+        pthread_mutex_lock(&mutex_);
+        value_ = value;
+        full_ = true;
+        pthread_cond_signal(&cond_);
+        pthread_mutex_unlock(&mutex_);
+    }
+
+    uint64_t receive()
+    {
+        pthread_mutex_lock(&mutex_);
+        while (!full_) {
+            pthread_cond_wait(&cond_, &mutex_);
+        }
+        uint64_t value = value_;
+        full_ = false;
+        pthread_mutex_unlock(&mutex_);
+        return value;
+    }
+
+private:
+    pthread_mutex_t mutex_;
+    pthread_cond_t cond_;
+    uint64_t value_ = 0;
+    bool full_ = false;
+};
+
+/**
+ * @brief Message unique signalé par futex(2)
+ *
+ * L'émetteur n'entre dans le kernel (FUTEX_WAKE) que si le récepteur a
+ * annoncé qu'il dormait : entre deux threads actifs, l'envoi se réduit à
+ * deux opérations atomiques.
+ */
+class FutexChannel {
+public:
+    FutexChannel() = default;
+    FutexChannel(const FutexChannel&) = delete;
+    FutexChannel& operator=(const FutexChannel&) = delete;
+
+    void send(uint64_t value)
+    {
+        value_.store(value, std::memory_order_relaxed);
+        sequence_.fetch_add(1, std::memory_order_seq_cst);
+        if (waiting_.load(std::memory_order_seq_cst) != 0) {
+            syscall(SYS_futex, futex_word(), FUTEX_WAKE_PRIVATE, 1, nullptr, nullptr, 0);
+        }
+    }
+
+    uint64_t receive()
+    {
+        for (;;) {
+            if (sequence_.load(std::memory_order_acquire) != consumed_) break;
+            // Annonce du sommeil, puis revérification : FUTEX_WAIT ne dort que
+            // si le compteur vaut encore la valeur consommée
+            waiting_.store(1, std::memory_order_seq_cst);
+            if (sequence_.load(std::memory_order_seq_cst) == consumed_) {
+                syscall(SYS_futex, futex_word(), FUTEX_WAIT_PRIVATE, consumed_, nullptr, nullptr, 0);
+            }
+            waiting_.store(0, std::memory_order_relaxed);
+        }
+        consumed_ = sequence_.load(std::memory_order_acquire);
+        return value_.load(std::memory_order_relaxed);
+    }
+
+private:
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "mot futex de 32 bits");
+
+    uint32_t* futex_word() { return reinterpret_cast<uint32_t*>(&sequence_); }
+
+    alignas(64) std::atomic<uint32_t> sequence_{0};
+    std::atomic<uint32_t> waiting_{0};
+    std::atomic<uint64_t> value_{0};
+    uint32_t consumed_ = 0;   ///< Dernière séquence lue (récepteur seul)
+};
+
+/**
+ * @brief Message unique signalé par un eventfd
+ */
+class EventfdChannel {
+public:
+    EventfdChannel() : fd_(eventfd(0, EFD_CLOEXEC)) {}
+    EventfdChannel(const EventfdChannel&) = delete;
+    EventfdChannel& operator=(const EventfdChannel&) = delete;
+    ~EventfdChannel()
+    {
+        if (fd_ >= 0) close(fd_);
+    }
+
+    void send(uint64_t value)
+    {
+        value_.store(value, std::memory_order_release);
+        uint64_t one = 1;
+        ssize_t ignored = write(fd_, &one, sizeof(one));
+        (void)ignored;
+    }
+
+    uint64_t receive()
+    {
+        uint64_t count;
+        while (read(fd_, &count, sizeof(count)) < 0 && errno == EINTR) {}
+        return value_.load(std::memory_order_acquire);
+    }
+
+    bool valid() const { return fd_ >= 0; }   ///< eventfd() a réussi ?
+
+private:
+    int fd_;
+    std::atomic<uint64_t> value_{0};
+};
+
+// ============================================================================
+// CANAUX À SCRUTATION
+// ============================================================================
+
+/**
+ * @brief File SpscRing, réception par attente active
+ */
+class SpscChannel {
+public:
+    SpscChannel() = default;
+    SpscChannel(const SpscChannel&) = delete;
+    SpscChannel& operator=(const SpscChannel&) = delete;
+
+    void send(uint64_t value)
+    {
+        while (!ring_.try_push(value)) {
+            cpu_relax();
+        }
+    }
+
+    uint64_t receive()
+    {
+        uint64_t value;
+        while (!ring_.try_pop(value)) {
+            cpu_relax();
+        }
+        return value;
+    }
+
+private:
+    SpscRing<uint64_t> ring_{64};
+};
+
+/**
+ * @brief Instantané d'une ligne de cache publié par verrou de séquence
+ *
+ * L'écrivain rend le compteur impair, écrit, puis le rend pair : il ne
+ * bloque jamais. Le lecteur recommence si le compteur a changé pendant sa
+ * copie. Convient à un état publié à chaque cycle (consignes, mesures) dont
+ * seul le dernier compte ; ici le lecteur attend chaque nouvelle version.
+ */
+class SeqlockChannel {
+public:
+    static constexpr size_t WORDS = 8;   ///< 64 octets : une ligne de cache
+
+    SeqlockChannel() = default;
+    SeqlockChannel(const SeqlockChannel&) = delete;
+    SeqlockChannel& operator=(const SeqlockChannel&) = delete;
+
+    void send(uint64_t value)
+    {
+        const uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t k = 0; k < WORDS; ++k) {
+            words_[k].store(value + k, std::memory_order_relaxed);
+        }
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    uint64_t receive()
+    {
+        for (;;) {
+            const uint32_t before = sequence_.load(std::memory_order_acquire);
+            if ((before & 1) != 0 || before == seen_) {
+                cpu_relax();
+                continue;
+            }
+            uint64_t copy[WORDS];
+            for (size_t k = 0; k < WORDS; ++k) {
+                copy[k] = words_[k].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (sequence_.load(std::memory_order_relaxed) == before) {
+                seen_ = before;
+                return copy[0];
+            }
+        }
+    }
+
+private:
+    alignas(64) std::atomic<uint32_t> sequence_{0};
+    alignas(64) std::atomic<uint64_t> words_[WORDS] = {};
+    uint32_t seen_ = 0;   ///< Dernière version lue (lecteur seul)
+};
+
+#endif // RT_IPC_H
@@ -0,0 +1,232 @@
+/**
+ * @file rt_memory.h
+ * @brief Pré-chargement mémoire et garde d'allocation du chemin temps réel
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * mlockall(MCL_CURRENT | MCL_FUTURE) verrouille ce qui est projeté, mais ne
+ * crée pas les pages : la pile du thread RT et le tas provoquent encore une
+ * page fault au premier accès, et une croissance de std::vector au milieu
+ * de la boucle appelle malloc(). Ce fichier fournit :
+ * 
+ * - le réglage de malloc (mallopt) pour ne jamais rendre de mémoire au
+ *   système ni utiliser mmap() pour les gros blocs
+ * - le pré-chargement d'une profondeur de pile et d'une réserve de tas
+ * - une garde qui compte (ou refuse) les allocations et les page faults
+ *   pendant la fenêtre de mesure
+ */
+
+#ifndef RT_MEMORY_H
+#define RT_MEMORY_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <malloc.h>
+#include <alloca.h>
+#include <sys/resource.h>
+
+// ============================================================================
+// PRÉ-CHARGEMENT (PREFAULT)
+// ============================================================================
+
+/**
+ * @brief Configure malloc pour un processus temps réel
+ * 
+ * M_TRIM_THRESHOLD = -1 : free() ne rend jamais la mémoire au système, les
+ *                         pages pré-chargées restent projetées (et verrouillées)
+ * M_MMAP_MAX = 0        : les gros blocs viennent du tas, jamais d'un mmap()
+ *                         neuf donc non pré-chargé
+ * 
+ * À appeler avant toute allocation importante, et avant mlockall().
+ */
+inline void configure_malloc_for_rt()
+{
+    mallopt(M_TRIM_THRESHOLD, -1);
+    mallopt(M_MMAP_MAX, 0);
+}
+
+/**
+ * @brief Pré-charge une réserve de tas
+ * 
+ * Alloue, écrit (une fois par page) puis libère un bloc : grâce à
+ * configure_malloc_for_rt(), il reste dans le tas et sert les allocations
+ * suivantes sans page fault.
+ * 
+ * @param bytes Taille de la réserve
+ */
+inline void prefault_heap(size_t bytes)
+{
+    if (bytes == 0) return;
+    
+    char* block = static_cast<char*>(malloc(bytes));
+    if (block == nullptr) return;
+    
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t off = 0; off < bytes; off += page) {
+        block[off] = 1;
+    }
+    // Empêche le compilateur de supprimer les écritures
+    __asm__ __volatile__("" : : "r"(block) : "memory");
+    free(block);
+}
+
+/**
+ * @brief Pré-charge la pile du thread appelant sur une profondeur donnée
+ * 
+ * Doit être appelé par le thread RT lui-même (chaque thread a sa pile),
+ * après mlockall(MCL_FUTURE) pour que les pages créées restent en RAM.
+ * 
+ * @param bytes Profondeur de pile à toucher
+ */
+__attribute__((noinline)) inline void prefault_stack(size_t bytes)
+{
+    if (bytes == 0) return;
+    
+    volatile char* stack = static_cast<volatile char*>(alloca(bytes));
+    const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    for (size_t off = 0; off < bytes; off += page) {
+        stack[off] = 0;
+    }
+}
+
+// ============================================================================
+// GARDE DE LA FENÊTRE DE MESURE
+// ============================================================================
+
+/**
+ * @brief Compteurs de page faults du thread courant
+ */
+struct PageFaultCounters {
+    uint64_t minor = 0;   ///< Page déjà en RAM, seule la table des pages change
+    uint64_t major = 0;   ///< Page lue depuis le stockage (plusieurs ms)
+};
+
+/**
+ * @brief Lit les compteurs de page faults du thread courant (getrusage)
+ */
+inline PageFaultCounters read_thread_faults()
+{
+    struct rusage usage;
+    PageFaultCounters counters;
+    if (getrusage(RUSAGE_THREAD, &usage) == 0) {
+        counters.minor = static_cast<uint64_t>(usage.ru_minflt);
+        counters.major = static_cast<uint64_t>(usage.ru_majflt);
+    }
+    return counters;
+}
+
+/**
+ * @brief Bilan mémoire de la fenêtre de mesure
+ */
+struct MemoryGuardStats {
+    bool measured = false;      ///< Faux si aucune fenêtre n'a été mesurée (--analyze)
+    uint64_t minor_faults = 0;
+    uint64_t major_faults = 0;
+    uint64_t allocations = 0;   ///< Appels à operator new pendant la mesure
+    
+    /// Agrège le bilan d'un autre thread
+    void merge(const MemoryGuardStats& other)
+    {
+        measured = measured || other.measured;
+        minor_faults += other.minor_faults;
+        major_faults += other.major_faults;
+        allocations += other.allocations;
+    }
+};
+
+/// Fenêtre de mesure ouverte pour le thread courant
+inline thread_local bool rt_alloc_window_open = false;
+
+/// Allocations du thread courant pendant la fenêtre
+inline thread_local uint64_t rt_window_allocations = 0;
+
+/// Arrêt immédiat sur allocation ou page fault (--memory-guard abort)
+inline bool rt_memory_guard_abort = false;
+
+/**
+ * @brief Termine le programme avec un message, sans allouer
+ */
+[[noreturn]] inline void rt_memory_guard_fail(const char* what, uint64_t value)
+{
+    char message[160];
+    int len = snprintf(message, sizeof(message),
+                       "\n✗ Garde mémoire : %s %llu pendant la fenêtre de mesure\n",
+                       what, static_cast<unsigned long long>(value));
+    if (len > 0) {
+        ssize_t ignored = write(STDERR_FILENO, message, static_cast<size_t>(len));
+        (void)ignored;
+    }
+    abort();
+}
+
+/**
+ * @brief À appeler à chaque allocation (depuis operator new)
+ */
+inline void rt_note_allocation(size_t size)
+{
+    if (rt_alloc_window_open) {
+        rt_window_allocations++;
+        if (rt_memory_guard_abort) {
+            rt_alloc_window_open = false;
+            rt_memory_guard_fail("allocation (octets) :", size);
+        }
+    }
+}
+
+/**
+ * @brief Fenêtre de mesure : compte allocations et page faults du thread
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * MemoryGuard guard;
+ * guard.begin();
+ * // ... boucle temps réel ...
+ * MemoryGuardStats stats = guard.end();
+ * @endcode
+ */
+class MemoryGuard {
+public:
+    /// Ouvre la fenêtre (après le pré-chargement)
+    void begin()
+    {
+        rt_window_allocations = 0;
+        baseline_ = read_thread_faults();
+        rt_alloc_window_open = true;
+    }
+    
+    /**
+     * @brief Vérification par cycle en mode abort (un appel système getrusage)
+     * 
+     * @param cycle Numéro du cycle, rapporté dans le message
+     */
+    void check(uint64_t cycle) const
+    {
+        PageFaultCounters now = read_thread_faults();
+        if (now.minor != baseline_.minor || now.major != baseline_.major) {
+            rt_memory_guard_fail("page fault au cycle", cycle);
+        }
+    }
+    
+    /// Ferme la fenêtre et retourne son bilan
+    MemoryGuardStats end()
+    {
+        rt_alloc_window_open = false;
+        PageFaultCounters now = read_thread_faults();
+        
+        MemoryGuardStats stats;
+        stats.measured = true;
+        stats.minor_faults = now.minor - baseline_.minor;
+        stats.major_faults = now.major - baseline_.major;
+        stats.allocations = rt_window_allocations;
+        return stats;
+    }
+
+private:
+    PageFaultCounters baseline_;
+};
+
+#endif // RT_MEMORY_H
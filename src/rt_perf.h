@@ -0,0 +1,463 @@
+/**
+ * @file rt_perf.h
+ * @brief Compteurs matériels du PMU (perf_event_open) pour le thread appelant
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Le temps seul ne dit pas pourquoi un code est lent : à durée égale, une
+ * fonction peut exécuter beaucoup d'instructions ou attendre la mémoire.
+ * PerfCounterGroup ouvre plusieurs compteurs (cycles, instructions, défauts
+ * de cache...) dans UN groupe perf : le kernel les active et les arrête
+ * ensemble, et un seul read() les relève tous au même instant.
+ * 
+ * Disponibilité :
+ * - le Cortex-A72 du Raspberry Pi 4 expose son PMU sous Raspberry Pi OS et
+ *   Ubuntu (armv8_cortex_a72) ;
+ * - une machine virtuelle n'a souvent aucun compteur matériel ;
+ * - /proc/sys/kernel/perf_event_paranoid ≤ 2 suffit pour compter en espace
+ *   utilisateur ; compter aussi le kernel demande ≤ 1 (ou root).
+ * 
+ * Un compteur refusé est marqué indisponible et vaut 0, les autres restent
+ * utilisables : le programme mesure toujours le temps.
+ * 
+ * LECTURE EN ESPACE UTILISATEUR (read_fast) :
+ * Chaque compteur expose une page perf_event_mmap_page. Si le kernel
+ * l'autorise (cap_user_rdpmc), le compteur se lit par une instruction :
+ * rdpmc sur x86, mrs pmevcntr<n>_el0 / pmccntr_el0 sur ARMv8 (sysctl
+ * kernel.perf_user_access=1, kernel ≥ 5.17). Quelques dizaines de ns, sans
+ * appel système : assez pour relever les compteurs à chaque période de la
+ * boucle RT (PmuStats). Les compteurs logiciels (changements de contexte)
+ * n'ont pas de registre : un read() de groupe les complète.
+ */
+
+#ifndef RT_PERF_H
+#define RT_PERF_H
+
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#include <string>
+#include <vector>
+
+#include "rt_utils.h"
+
+/**
+ * @brief Un événement à compter
+ */
+struct PerfEventSpec {
+    const char* name;   ///< Nom court affiché ("cycles", "instructions")
+    uint32_t type;      ///< PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE ou PERF_TYPE_SOFTWARE
+    uint64_t config;    ///< Événement dans ce type (PERF_COUNT_HW_CPU_CYCLES...)
+};
+
+/// Cycles et instructions : le minimum pour un coût par opération
+constexpr PerfEventSpec PERF_CYCLES_INSTRUCTIONS[] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+};
+
+/// Compteurs relevés à chaque cycle de la boucle RT (option --pmu)
+constexpr size_t PMU_EVENT_COUNT = 6;
+
+/// Config PERF_TYPE_HW_CACHE : cache, opération, résultat
+constexpr uint64_t perf_cache_config(uint64_t cache, uint64_t op, uint64_t result)
+{
+    return cache | (op << 8) | (result << 16);
+}
+
+/**
+ * @brief Événements de PmuStats, dans l'ordre des colonnes du rapport
+ * 
+ * « L2 » : l'événement générique LL n'existe pas sur ARMv8 (PMUv3) ; on y
+ * compte l'événement architectural L2D_CACHE_REFILL (0x17), qui est bien le
+ * L2 partagé du Cortex-A72. Ailleurs, le dernier niveau de cache.
+ */
+constexpr PerfEventSpec PMU_CYCLE_EVENTS[PMU_EVENT_COUNT] = {
+    {"cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"L1D miss", PERF_TYPE_HW_CACHE,
+     perf_cache_config(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+#if defined(__aarch64__)
+    {"L2 miss", PERF_TYPE_RAW, 0x17},
+#else
+    {"L2 miss", PERF_TYPE_HW_CACHE,
+     perf_cache_config(PERF_COUNT_HW_CACHE_LL, PERF_COUNT_HW_CACHE_OP_READ, PERF_COUNT_HW_CACHE_RESULT_MISS)},
+#endif
+    {"branch miss", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"ctx switch", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+/**
+ * @brief Lit le compteur matériel d'indice index (perf_event_mmap_page::index - 1)
+ * 
+ * N'est valide que si le kernel a accordé cap_user_rdpmc pour ce compteur.
+ */
+inline uint64_t read_pmu_register(uint32_t index)
+{
+    uint64_t value = 0;
+#if defined(__aarch64__)
+    // Les registres PMEVCNTR<n>_EL0 sont nommés dans l'instruction : un cas par compteur
+#define RT_PMEVCNTR_CASE(n) \
+    case n: __asm__ __volatile__("mrs %0, pmevcntr" #n "_el0" : "=r"(value)); break;
+    switch (index) {
+        RT_PMEVCNTR_CASE(0)  RT_PMEVCNTR_CASE(1)  RT_PMEVCNTR_CASE(2)  RT_PMEVCNTR_CASE(3)
+        RT_PMEVCNTR_CASE(4)  RT_PMEVCNTR_CASE(5)  RT_PMEVCNTR_CASE(6)  RT_PMEVCNTR_CASE(7)
+        RT_PMEVCNTR_CASE(8)  RT_PMEVCNTR_CASE(9)  RT_PMEVCNTR_CASE(10) RT_PMEVCNTR_CASE(11)
+        RT_PMEVCNTR_CASE(12) RT_PMEVCNTR_CASE(13) RT_PMEVCNTR_CASE(14) RT_PMEVCNTR_CASE(15)
+        RT_PMEVCNTR_CASE(16) RT_PMEVCNTR_CASE(17) RT_PMEVCNTR_CASE(18) RT_PMEVCNTR_CASE(19)
+        RT_PMEVCNTR_CASE(20) RT_PMEVCNTR_CASE(21) RT_PMEVCNTR_CASE(22) RT_PMEVCNTR_CASE(23)
+        RT_PMEVCNTR_CASE(24) RT_PMEVCNTR_CASE(25) RT_PMEVCNTR_CASE(26) RT_PMEVCNTR_CASE(27)
+        RT_PMEVCNTR_CASE(28) RT_PMEVCNTR_CASE(29) RT_PMEVCNTR_CASE(30)
+        case 31: __asm__ __volatile__("mrs %0, pmccntr_el0" : "=r"(value)); break;   // Compteur de cycles
+        default: break;
+    }
+#undef RT_PMEVCNTR_CASE
+#elif defined(__x86_64__) || defined(__i386__)
+    value = __builtin_ia32_rdpmc(static_cast<int>(index));
+#else
+    (void)index;
+#endif
+    return value;
+}
+
+/**
+ * @brief Groupe de compteurs perf du thread appelant
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * PerfCounterGroup perf;
+ * perf.open(PERF_CYCLES_INSTRUCTIONS, 2, true);
+ * perf.reset();
+ * perf.enable();
+ * ... code mesuré ...
+ * perf.disable();
+ * uint64_t values[2];
+ * perf.read(values);   // values[0] = cycles, values[1] = instructions
+ * @endcode
+ */
+class PerfCounterGroup {
+public:
+    static constexpr size_t MAX_EVENTS = 8;   ///< Taille maximale d'un groupe
+    
+    PerfCounterGroup()
+    {
+        for (size_t k = 0; k < MAX_EVENTS; ++k) {
+            fds_[k] = -1;
+            slots_[k] = -1;
+        }
+    }
+    PerfCounterGroup(const PerfCounterGroup&) = delete;
+    PerfCounterGroup& operator=(const PerfCounterGroup&) = delete;
+    ~PerfCounterGroup() { close(); }
+    
+    /**
+     * @brief Ouvre les compteurs du thread appelant, sur tous les CPUs
+     * 
+     * Le groupe est créé arrêté : enable() démarre le comptage.
+     * 
+     * @param specs Événements, le premier ouvert devient le chef du groupe
+     * @param count Nombre d'événements (au plus MAX_EVENTS)
+     * @param user_only true : cycles passés dans le kernel exclus
+     *                  (perf_event_paranoid 2 suffit)
+     * @param pinned true : le groupe reste en permanence sur le PMU (jamais
+     *               multiplexé) et chaque compteur est projeté pour
+     *               read_fast()
+     * @return true si au moins un compteur est ouvert ; sinon error() décrit
+     *         le premier refus
+     */
+    bool open(const PerfEventSpec* specs, size_t count, bool user_only, bool pinned = false)
+    {
+        close();
+        count_ = count < MAX_EVENTS ? count : MAX_EVENTS;
+        for (size_t k = 0; k < count_; ++k) {
+            struct perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = specs[k].type;
+            attr.config = specs[k].config;
+            attr.disabled = leader() < 0 ? 1 : 0;   // Seul le chef pilote le groupe
+            attr.pinned = pinned && leader() < 0 ? 1 : 0;
+            attr.exclude_kernel = user_only ? 1 : 0;
+#if defined(__aarch64__)
+            attr.config1 = pinned ? 0x2 : 0;   // PMUv3 : accès EL0 demandé (format « rdpmc »)
+#endif
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED
+                             | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            
+            long fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader(), PERF_FLAG_FD_CLOEXEC);
+            if (fd < 0) {
+                if (error_.empty()) {
+                    error_ = std::string(specs[k].name) + " : " + strerror(errno);
+                }
+                continue;
+            }
+            slots_[k] = static_cast<int>(opened_);
+            fds_[opened_] = static_cast<int>(fd);
+            
+            // Page de lecture en espace utilisateur (facultative : repli sur read())
+            if (pinned) {
+                void* page = mmap(NULL, static_cast<size_t>(sysconf(_SC_PAGESIZE)), PROT_READ, MAP_SHARED,
+                                  static_cast<int>(fd), 0);
+                if (page != MAP_FAILED) {
+                    pages_[opened_] = static_cast<const perf_event_mmap_page*>(page);
+                }
+            }
+            ++opened_;
+        }
+        return opened_ > 0;
+    }
+    
+    /// Ferme tous les compteurs
+    void close()
+    {
+        for (size_t k = 0; k < MAX_EVENTS; ++k) {
+            if (pages_[k] != nullptr) {
+                munmap(const_cast<perf_event_mmap_page*>(pages_[k]), static_cast<size_t>(sysconf(_SC_PAGESIZE)));
+            }
+            if (fds_[k] >= 0) ::close(fds_[k]);
+            fds_[k] = -1;
+            slots_[k] = -1;
+            pages_[k] = nullptr;
+        }
+        opened_ = 0;
+        count_ = 0;
+    }
+    
+    void reset() { group_ioctl(PERF_EVENT_IOC_RESET); }     ///< Remet tous les compteurs à zéro
+    void enable() { group_ioctl(PERF_EVENT_IOC_ENABLE); }   ///< Démarre le comptage
+    void disable() { group_ioctl(PERF_EVENT_IOC_DISABLE); } ///< Arrête le comptage
+    
+    /**
+     * @brief Relève tous les compteurs en un appel système
+     * 
+     * Si le kernel a dû partager le PMU avec d'autres groupes (multiplexage),
+     * les comptes sont extrapolés à la durée d'activation.
+     * 
+     * @param values values[k] = compte de specs[k] (0 si indisponible)
+     * @return false si le groupe n'est pas ouvert ou la lecture échoue
+     */
+    bool read(uint64_t* values) const
+    {
+        for (size_t k = 0; k < count_; ++k) values[k] = 0;
+        if (opened_ == 0) return false;
+        
+        // Format PERF_FORMAT_GROUP : nr, time_enabled, time_running, valeurs
+        uint64_t buffer[3 + MAX_EVENTS];
+        ssize_t bytes = ::read(fds_[0], buffer, sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) return false;
+        
+        const uint64_t nr = buffer[0];
+        const uint64_t enabled = buffer[1];
+        const uint64_t running = buffer[2];
+        const double scale = running > 0 && running < enabled
+                           ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+        for (size_t k = 0; k < count_; ++k) {
+            if (slots_[k] < 0 || static_cast<uint64_t>(slots_[k]) >= nr) continue;
+            const uint64_t raw = buffer[3 + slots_[k]];
+            values[k] = scale == 1.0 ? raw : static_cast<uint64_t>(static_cast<double>(raw) * scale);
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Relève les compteurs sans appel système quand c'est possible
+     * 
+     * Compteurs matériels accordés en espace utilisateur : lecture du
+     * registre, protégée par le compteur de séquence de leur page. Les
+     * autres (logiciels, accès refusé) sont complétés par un read() de
+     * groupe. Les comptes ne sont pas extrapolés : le groupe doit être
+     * ouvert avec pinned.
+     * 
+     * @param values values[k] = compte de specs[k] (0 si indisponible)
+     * @return false si un read() nécessaire a échoué
+     */
+    bool read_fast(uint64_t* values) const
+    {
+        bool need_syscall = false;
+        for (size_t k = 0; k < count_; ++k) {
+            values[k] = 0;
+            if (slots_[k] < 0) continue;
+            if (!read_user(pages_[static_cast<size_t>(slots_[k])], values[k])) need_syscall = true;
+        }
+        if (!need_syscall) return true;
+        
+        uint64_t buffer[3 + MAX_EVENTS];
+        ssize_t bytes = ::read(fds_[0], buffer, sizeof(buffer));
+        if (bytes < static_cast<ssize_t>(3 * sizeof(uint64_t))) return false;
+        for (size_t k = 0; k < count_; ++k) {
+            if (slots_[k] < 0 || static_cast<uint64_t>(slots_[k]) >= buffer[0]) continue;
+            if (!user_readable(k)) values[k] = buffer[3 + static_cast<size_t>(slots_[k])];
+        }
+        return true;
+    }
+    
+    /// specs[k] se lit sans appel système (groupe actif, cap_user_rdpmc accordé) ?
+    bool user_readable(size_t k) const
+    {
+        if (!available(k)) return false;
+        const perf_event_mmap_page* page = pages_[static_cast<size_t>(slots_[k])];
+        return page != nullptr && page->cap_user_rdpmc && page->index != 0;
+    }
+    
+    size_t size() const { return count_; }                                ///< Événements demandés
+    size_t opened() const { return opened_; }                             ///< Compteurs ouverts
+    bool available(size_t k) const { return k < count_ && slots_[k] >= 0; }   ///< specs[k] ouvert ?
+    const std::string& error() const { return error_; }                   ///< Premier refus
+
+private:
+    int leader() const { return opened_ > 0 ? fds_[0] : -1; }
+    
+    /**
+     * @brief Lecture d'un compteur par sa page (protocole de perf_event.h)
+     * 
+     * Le kernel incrémente lock avant et après chaque mise à jour de la page
+     * (migration, changement de contexte) : on recommence si la lecture l'a
+     * chevauchée.
+     * 
+     * @return false si le compteur n'est pas lisible en espace utilisateur
+     */
+    static bool read_user(const volatile perf_event_mmap_page* page, uint64_t& value)
+    {
+        if (page == nullptr) return false;
+        uint32_t sequence;
+        do {
+            sequence = page->lock;
+            __asm__ __volatile__("" ::: "memory");
+            const uint32_t index = page->index;
+            if (!page->cap_user_rdpmc || index == 0) return false;
+            
+            // Le registre a pmc_width bits : extension de signe avant d'ajouter l'offset
+            const uint32_t shift = 64 - page->pmc_width;
+            const int64_t pmc = static_cast<int64_t>(read_pmu_register(index - 1) << shift) >> shift;
+            value = static_cast<uint64_t>(page->offset + pmc);
+            __asm__ __volatile__("" ::: "memory");
+        } while (page->lock != sequence);
+        return true;
+    }
+    
+    void group_ioctl(unsigned long request)
+    {
+        if (opened_ > 0) ioctl(fds_[0], request, PERF_IOC_FLAG_GROUP);
+    }
+    
+    int fds_[MAX_EVENTS];       ///< Descripteurs ouverts, chef en tête
+    int slots_[MAX_EVENTS];     ///< Position de specs[k] dans la lecture de groupe (-1 = refusé)
+    const perf_event_mmap_page* pages_[MAX_EVENTS] = {};   ///< Pages projetées (pinned), par position
+    size_t count_ = 0;
+    size_t opened_ = 0;
+    std::string error_;
+};
+
+// ============================================================================
+// CORRÉLATION COMPTEURS / LATENCE (option --pmu)
+// ============================================================================
+
+/**
+ * @brief Sommes des compteurs par bande de latence
+ * 
+ * Une bande regroupe 16 cases de LatencyHistogram (8 bandes par octave,
+ * ±6 %) : le rapport retrouve les cycles du p99.9 sans garder chaque
+ * cycle. Mémoire fixe (~20 Ko), enregistrement en O(1) sans allocation.
+ */
+class CounterCorrelation {
+public:
+    static constexpr size_t BAND_SHIFT = 4;
+    static constexpr size_t BAND_COUNT = (LatencyHistogram::BUCKET_COUNT >> BAND_SHIFT) + 1;
+    
+    /// Bande d'une durée
+    static size_t band_of(uint64_t value_ns) { return LatencyHistogram::bucket_index(value_ns) >> BAND_SHIFT; }
+    
+    /// Alloue les sommes (avant la boucle RT)
+    void prepare()
+    {
+        counts_.assign(BAND_COUNT, 0);
+        sums_.assign(BAND_COUNT * PMU_EVENT_COUNT, 0);
+    }
+    
+    /// Ajoute un cycle de durée value_ns et ses compteurs (deltas[PMU_EVENT_COUNT])
+    void record(uint64_t value_ns, const uint64_t* deltas)
+    {
+        const size_t band = band_of(value_ns);
+        ++counts_[band];
+        for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) {
+            sums_[band * PMU_EVENT_COUNT + k] += deltas[k];
+        }
+    }
+    
+    /// Agrège les cycles d'un autre thread
+    void merge(const CounterCorrelation& other)
+    {
+        if (other.counts_.empty()) return;
+        if (counts_.empty()) prepare();
+        for (size_t b = 0; b < BAND_COUNT; ++b) counts_[b] += other.counts_[b];
+        for (size_t i = 0; i < sums_.size(); ++i) sums_[i] += other.sums_[i];
+    }
+    
+    /**
+     * @brief Moyennes par cycle des compteurs sur les bandes [first, last[
+     * 
+     * @param means means[PMU_EVENT_COUNT], rempli si des cycles y tombent
+     * @return Nombre de cycles des bandes
+     */
+    uint64_t means_between(size_t first, size_t last, double* means) const
+    {
+        uint64_t cycles = 0;
+        uint64_t sums[PMU_EVENT_COUNT] = {};
+        for (size_t b = first; b < last && b < counts_.size(); ++b) {
+            cycles += counts_[b];
+            for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) sums[k] += sums_[b * PMU_EVENT_COUNT + k];
+        }
+        for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) {
+            means[k] = cycles > 0 ? static_cast<double>(sums[k]) / static_cast<double>(cycles) : 0.0;
+        }
+        return cycles;
+    }
+
+private:
+    std::vector<uint64_t> counts_;   ///< Cycles par bande
+    std::vector<uint64_t> sums_;     ///< Sommes [bande][compteur]
+};
+
+/**
+ * @brief Compteurs PMU d'une tâche périodique, corrélés à ses cycles
+ * 
+ * Chaque cycle reçoit les compteurs écoulés depuis la fin du précédent :
+ * sommeil, chemin de réveil du kernel (compté si le kernel l'autorise),
+ * puis travail du cycle. Ils sont rangés deux fois : par latence de réveil
+ * (retards d'ordonnancement) et par temps d'exécution (pollution de cache).
+ */
+struct PmuStats {
+    bool measured = false;          ///< Faux si --pmu absent ou aucun compteur ouvert
+    bool user_read = false;         ///< Compteurs matériels lus sans appel système
+    bool user_only = false;         ///< Kernel exclu (perf_event_paranoid) : chemin de réveil non compté
+    bool available[PMU_EVENT_COUNT] = {};   ///< Compteur ouvert ?
+    std::string error;              ///< Premier refus (compteur indisponible)
+    uint64_t cycles = 0;            ///< Cycles enregistrés
+    CounterCorrelation by_latency;  ///< Par latence de réveil
+    CounterCorrelation by_exec;     ///< Par temps d'exécution
+    
+    /// Agrège les résultats d'un autre thread
+    void merge(const PmuStats& other)
+    {
+        if (!other.measured) return;
+        if (!measured) {
+            *this = other;
+            return;
+        }
+        user_read = user_read && other.user_read;
+        user_only = user_only || other.user_only;
+        for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) available[k] = available[k] && other.available[k];
+        cycles += other.cycles;
+        by_latency.merge(other.by_latency);
+        by_exec.merge(other.by_exec);
+    }
+};
+
+#endif // RT_PERF_H
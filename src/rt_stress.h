@@ -0,0 +1,434 @@
+/**
+ * @file rt_stress.h
+ * @brief Générateur de charge de fond pour mesurer la latence sous stress
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Sur un système au repos, les latences mesurées sont optimistes. Ce fichier
+ * fournit des threads de charge SCHED_OTHER, placés sur les CPUs non isolés
+ * (0 et 1 sur le Raspberry Pi), qui reproduisent les perturbations typiques
+ * d'un système chargé :
+ * 
+ * - memcpy  : copies de tampons plus grands que le cache L2 (1 Mo sur
+ *             Cortex-A72) → pollution du cache partagé et du bus mémoire
+ * - syscall : rafale d'appels système courts → entrées/sorties du kernel,
+ *             verrous internes, ordonnanceur sollicité en permanence
+ * - io      : écritures + fsync() sur la carte SD → interruptions du
+ *             contrôleur SD, writeback, travail dans les workqueues
+ * 
+ * Les threads sont créés, surveillés et arrêtés par le programme lui-même :
+ * une seule commande donne la latence pire cas sous charge.
+ * 
+ * CacheAggressor est un voisin bruyant plus ciblé : un tampon de taille
+ * choisie parcouru ligne de cache par ligne de cache, pour mesurer à partir
+ * de quelle empreinte il dégrade le temps d'exécution du thread RT via le
+ * cache L2 partagé (--cache-sweep).
+ */
+
+#ifndef RT_STRESS_H
+#define RT_STRESS_H
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// TYPES DE CHARGE
+// ============================================================================
+
+/**
+ * @brief Nature d'un thread de charge
+ */
+enum class StressKind {
+    MEMCPY,    ///< Copies mémoire qui débordent du cache L2
+    SYSCALL,   ///< Appels système en boucle
+    IO         ///< Écritures synchronisées sur le système de fichiers
+};
+
+/// Taille des tampons de copie : 8 × le cache L2 du Cortex-A72
+constexpr size_t STRESS_MEMCPY_BYTES = 8 * 1024 * 1024;
+
+/// Taille d'un bloc d'écriture ; fsync() tous les STRESS_IO_BLOCKS blocs
+constexpr size_t STRESS_IO_BLOCK_BYTES = 256 * 1024;
+constexpr size_t STRESS_IO_BLOCKS = 16;
+
+/**
+ * @brief Nom lisible d'un type de charge
+ */
+inline const char* stress_kind_name(StressKind kind)
+{
+    switch (kind) {
+        case StressKind::MEMCPY:  return "memcpy";
+        case StressKind::SYSCALL: return "syscall";
+        default:                  return "io";
+    }
+}
+
+// ============================================================================
+// GÉNÉRATEUR DE CHARGE
+// ============================================================================
+
+/**
+ * @brief Threads de charge SCHED_OTHER, un de chaque type par CPU de service
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * StressGenerator stress;
+ * if (stress.start({0, 1}, ".")) {
+ *     // ... mesure temps réel sur les CPUs isolés ...
+ *     stress.stop();
+ * }
+ * @endcode
+ */
+class StressGenerator {
+public:
+    /**
+     * @brief État d'un thread de charge
+     */
+    struct Worker {
+        StressGenerator* owner = nullptr;
+        StressKind kind = StressKind::MEMCPY;
+        int cpu = 0;
+        std::string io_path;            ///< Fichier temporaire (type IO)
+        std::atomic<uint64_t> ops{0};   ///< Octets copiés/écrits ou appels système
+        pthread_t thread {};
+    };
+    
+    StressGenerator() = default;
+    StressGenerator(const StressGenerator&) = delete;
+    StressGenerator& operator=(const StressGenerator&) = delete;
+    ~StressGenerator() { stop(); }
+    
+    /**
+     * @brief Démarre un thread de chaque type sur chacun des CPUs donnés
+     * 
+     * Les threads sont explicitement SCHED_OTHER : créés depuis un thread
+     * SCHED_FIFO, ils hériteraient sinon de sa priorité temps réel.
+     * 
+     * @param cpus CPUs de service (non isolés) recevant la charge
+     * @param io_dir Répertoire des fichiers temporaires (sur la carte SD)
+     * @return true si tous les threads ont démarré ; sinon error() décrit l'erreur
+     */
+    bool start(const std::vector<int>& cpus, const std::string& io_dir)
+    {
+        stop();
+        finished_.clear();
+        stop_.store(false, std::memory_order_relaxed);
+        
+        const StressKind kinds[] = {StressKind::MEMCPY, StressKind::SYSCALL, StressKind::IO};
+        for (int cpu : cpus) {
+            for (StressKind kind : kinds) {
+                std::unique_ptr<Worker> worker(new Worker);
+                worker->owner = this;
+                worker->kind = kind;
+                worker->cpu = cpu;
+                if (kind == StressKind::IO) {
+                    worker->io_path = io_dir + "/.rt_stress_" + std::to_string(getpid())
+                                    + "_cpu" + std::to_string(cpu) + ".tmp";
+                }
+                
+                pthread_attr_t attr;
+                pthread_attr_init(&attr);
+                pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+                pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+                
+                struct sched_param param;
+                param.sched_priority = 0;
+                pthread_attr_setschedparam(&attr, &param);
+                
+                cpu_set_t cpuset;
+                CPU_ZERO(&cpuset);
+                CPU_SET(static_cast<size_t>(cpu), &cpuset);
+                pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+                
+                int err = pthread_create(&worker->thread, &attr, worker_main, worker.get());
+                pthread_attr_destroy(&attr);
+                
+                if (err != 0) {
+                    error_ = std::string("pthread_create: ") + strerror(err);
+                    stop();
+                    return false;
+                }
+                workers_.push_back(std::move(worker));
+            }
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Arrête et attend tous les threads, supprime les fichiers temporaires
+     */
+    void stop()
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& worker : workers_) {
+            pthread_join(worker->thread, NULL);
+            if (!worker->io_path.empty()) {
+                unlink(worker->io_path.c_str());
+            }
+        }
+        for (auto& worker : workers_) {
+            finished_.push_back({worker->kind, worker->cpu, worker->ops.load()});
+        }
+        workers_.clear();
+    }
+    
+    /**
+     * @brief Travail réalisé par un thread (disponible après stop())
+     */
+    struct Summary {
+        StressKind kind;
+        int cpu;
+        uint64_t ops;   ///< Octets (MEMCPY, IO) ou appels système (SYSCALL)
+    };
+    
+    const std::vector<Summary>& summaries() const { return finished_; }   ///< Bilan par thread
+    size_t running_threads() const { return workers_.size(); }            ///< Threads actifs
+    const std::string& error() const { return error_; }                   ///< Dernière erreur
+
+private:
+    static void* worker_main(void* arg)
+    {
+        Worker* worker = static_cast<Worker*>(arg);
+        switch (worker->kind) {
+            case StressKind::MEMCPY:  run_memcpy(*worker);  break;
+            case StressKind::SYSCALL: run_syscall(*worker); break;
+            case StressKind::IO:      run_io(*worker);      break;
+        }
+        return nullptr;
+    }
+    
+    bool stopping() const { return stop_.load(std::memory_order_relaxed); }
+    
+    /// Copies aller-retour entre deux tampons de STRESS_MEMCPY_BYTES
+    static void run_memcpy(Worker& worker)
+    {
+        std::vector<uint8_t> a(STRESS_MEMCPY_BYTES, 0x5A);
+        std::vector<uint8_t> b(STRESS_MEMCPY_BYTES, 0xA5);
+        while (!worker.owner->stopping()) {
+            memcpy(b.data(), a.data(), a.size());
+            memcpy(a.data(), b.data(), b.size());
+            worker.ops.fetch_add(2 * STRESS_MEMCPY_BYTES, std::memory_order_relaxed);
+        }
+    }
+    
+    /// Appels système courts : getppid (sans cache vDSO), write, sched_yield
+    static void run_syscall(Worker& worker)
+    {
+        int fd = open("/dev/null", O_WRONLY);
+        char byte = 0;
+        while (!worker.owner->stopping()) {
+            for (int i = 0; i < 1000; ++i) {
+                syscall(SYS_getppid);
+                if (fd >= 0 && write(fd, &byte, 1) < 0) break;
+                sched_yield();
+            }
+            worker.ops.fetch_add(3000, std::memory_order_relaxed);
+        }
+        if (fd >= 0) close(fd);
+    }
+    
+    /// Écritures de STRESS_IO_BLOCKS blocs puis fsync(), en réécrivant le même fichier
+    static void run_io(Worker& worker)
+    {
+        int fd = open(worker.io_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0600);
+        if (fd < 0) {
+            return;
+        }
+        std::vector<uint8_t> block(STRESS_IO_BLOCK_BYTES, 0xC3);
+        while (!worker.owner->stopping()) {
+            for (size_t i = 0; i < STRESS_IO_BLOCKS && !worker.owner->stopping(); ++i) {
+                if (write(fd, block.data(), block.size()) < 0) break;
+                worker.ops.fetch_add(block.size(), std::memory_order_relaxed);
+            }
+            fsync(fd);
+            if (lseek(fd, 0, SEEK_SET) < 0) break;
+        }
+        close(fd);
+    }
+    
+    std::atomic<bool> stop_{false};
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<Summary> finished_;
+    std::string error_;
+};
+
+// ============================================================================
+// AGRESSEUR DE CACHE À EMPREINTE CONTRÔLÉE
+// ============================================================================
+
+/// Plage des empreintes balayées par défaut (--cache-sweep), en Ko
+constexpr int DEFAULT_AGGRESSOR_MIN_KB = 32;
+constexpr int DEFAULT_AGGRESSOR_MAX_KB = 64 * 1024;
+
+/// Pas du parcours : une écriture par ligne de cache (64 octets sur Cortex-A72)
+constexpr size_t AGGRESSOR_LINE_BYTES = 64;
+
+/**
+ * @brief Threads qui lisent et écrivent en boucle un tampon de taille donnée
+ * 
+ * Un tampon plus petit que le L1 (32 Ko) reste privé au cœur agresseur ;
+ * au-delà, il occupe le L2 partagé (1 Mo sur le Raspberry Pi 4) et en
+ * chasse les lignes du thread RT ; au-delà du L2, il sature aussi le bus
+ * mémoire. Chaque ligne est lue puis réécrite : les lignes modifiées
+ * doivent être réécrites en mémoire lors de leur éviction.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * CacheAggressor aggressor;
+ * if (aggressor.start({0}, 4 * 1024 * 1024)) {   // 4 Mo sur le CPU 0
+ *     // ... mesure du temps d'exécution du thread RT ...
+ *     aggressor.stop();
+ * }
+ * @endcode
+ */
+class CacheAggressor {
+public:
+    CacheAggressor() = default;
+    CacheAggressor(const CacheAggressor&) = delete;
+    CacheAggressor& operator=(const CacheAggressor&) = delete;
+    ~CacheAggressor() { stop(); }
+    
+    /**
+     * @brief Démarre un thread SCHED_OTHER par CPU, chacun avec son tampon
+     * 
+     * Retourne une fois tous les tampons alloués et parcourus une première
+     * fois : la mesure commence sur un cache déjà pollué.
+     * 
+     * @param cpus CPUs des agresseurs
+     * @param bytes Empreinte de chaque agresseur
+     * @return true si tous les threads ont démarré ; sinon error() décrit l'erreur
+     */
+    bool start(const std::vector<int>& cpus, size_t bytes)
+    {
+        stop();
+        stop_.store(false, std::memory_order_relaxed);
+        bytes_touched_ = 0;
+        
+        for (int cpu : cpus) {
+            std::unique_ptr<Worker> worker(new Worker);
+            worker->owner = this;
+            worker->bytes = std::max(bytes, AGGRESSOR_LINE_BYTES);
+            
+            pthread_attr_t attr;
+            pthread_attr_init(&attr);
+            pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+            pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+            
+            struct sched_param param;
+            param.sched_priority = 0;
+            pthread_attr_setschedparam(&attr, &param);
+            
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(static_cast<size_t>(cpu), &cpuset);
+            pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+            
+            int err = pthread_create(&worker->thread, &attr, worker_main, worker.get());
+            pthread_attr_destroy(&attr);
+            
+            if (err != 0) {
+                error_ = std::string("pthread_create: ") + strerror(err);
+                stop();
+                return false;
+            }
+            workers_.push_back(std::move(worker));
+        }
+        
+        for (auto& worker : workers_) {
+            while (!worker->ready.load(std::memory_order_acquire)) {
+                struct timespec pause = {0, 1000000};
+                clock_nanosleep(CLOCK_MONOTONIC, 0, &pause, NULL);
+            }
+            if (worker->failed.load(std::memory_order_relaxed)) {
+                error_ = "mmap: impossible d'allouer le tampon de " + std::to_string(bytes / 1024) + " Ko";
+                stop();
+                return false;
+            }
+        }
+        return true;
+    }
+    
+    /// Arrête et attend les threads ; libère leurs tampons
+    void stop()
+    {
+        stop_.store(true, std::memory_order_relaxed);
+        for (auto& worker : workers_) {
+            pthread_join(worker->thread, NULL);
+            bytes_touched_ += worker->ops.load();
+        }
+        workers_.clear();
+    }
+    
+    uint64_t bytes_touched() const { return bytes_touched_; }   ///< Octets parcourus (après stop())
+    const std::string& error() const { return error_; }         ///< Dernière erreur
+
+private:
+    struct Worker {
+        CacheAggressor* owner = nullptr;
+        size_t bytes = 0;
+        std::atomic<uint64_t> ops{0};      ///< Octets parcourus
+        std::atomic<bool> ready{false};    ///< Tampon alloué et parcouru une fois
+        std::atomic<bool> failed{false};   ///< mmap() du tampon refusé
+        pthread_t thread {};
+    };
+    
+    /*
+     * Tampon obtenu par mmap() et non par malloc : malloc est réglé pour le
+     * thread RT (M_MMAP_MAX = 0) et ne doit pas grossir le tas verrouillé de
+     * 64 Mo par agresseur. MCL_FUTURE verrouille et pré-charge les pages.
+     */
+    static void* worker_main(void* arg)
+    {
+        Worker* worker = static_cast<Worker*>(arg);
+        const size_t bytes = worker->bytes;
+        void* mapping = mmap(NULL, bytes, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE, -1, 0);
+        if (mapping == MAP_FAILED) {
+            worker->failed.store(true, std::memory_order_relaxed);
+            worker->ready.store(true, std::memory_order_release);
+            return nullptr;
+        }
+        uint8_t* buffer = static_cast<uint8_t*>(mapping);
+        memset(buffer, 0x3C, bytes);
+        
+        uint8_t sum = 0;
+        bool first = true;
+        while (!worker->owner->stop_.load(std::memory_order_relaxed)) {
+            for (size_t i = 0; i < bytes; i += AGGRESSOR_LINE_BYTES) {
+                sum = static_cast<uint8_t>(sum + buffer[i]);
+                buffer[i] = sum;
+            }
+            worker->ops.fetch_add(bytes, std::memory_order_relaxed);
+            if (first) {
+                worker->ready.store(true, std::memory_order_release);
+                first = false;
+            }
+        }
+        // Résultat publié : le parcours ne peut pas être éliminé par le compilateur
+        worker->owner->sink_.fetch_add(sum, std::memory_order_relaxed);
+        munmap(mapping, bytes);
+        return nullptr;
+    }
+    
+    std::atomic<bool> stop_{false};
+    std::atomic<uint64_t> sink_{0};
+    std::vector<std::unique_ptr<Worker>> workers_;
+    uint64_t bytes_touched_ = 0;
+    std::string error_;
+};
+
+#endif // RT_STRESS_H
@@ -0,0 +1,353 @@
+/**
+ * @file rt_sysinfo.h
+ * @brief Instantané de la configuration système et validation avant mesure
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Une latence mesurée n'a de sens qu'avec la configuration qui l'a produite.
+ * Ce fichier relit, avant la mesure, les réglages qui influencent la
+ * latence sur les CPUs mesurés :
+ * 
+ * - kernel : version (uname) et PREEMPT_RT (/sys/kernel/realtime)
+ * - isolation : /sys/devices/system/cpu/isolated, nohz_full et rcu_nocbs
+ *   (/sys/devices/system/cpu/nohz_full, /proc/cmdline)
+ * - fréquence : gouverneur cpufreq et fréquence courante de chaque CPU mesuré
+ * - ordonnanceur : limitation RT (sched_rt_runtime_us / sched_rt_period_us)
+ *   et limite RLIMIT_RTPRIO
+ * - interruptions : IRQs dont l'affinité effective inclut un CPU mesuré
+ * 
+ * validate_snapshot() signale les réglages qui dégradent la latence ;
+ * snapshot_to_text() produit des lignes "clé=valeur" embarquées dans le
+ * journal et dans la trace binaire, pour comparer des mesures entre machines.
+ */
+
+#ifndef RT_SYSINFO_H
+#define RT_SYSINFO_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/resource.h>
+#include <sys/utsname.h>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// ============================================================================
+// LECTURE DES FICHIERS DU SYSTÈME
+// ============================================================================
+
+/**
+ * @brief Contenu d'un fichier de /proc ou /sys, sans le saut de ligne final
+ * 
+ * @param path Chemin du fichier
+ * @param content Contenu lu
+ * @return false si le fichier n'existe pas ou n'est pas lisible
+ */
+inline bool read_sys_file(const std::string& path, std::string& content)
+{
+    std::ifstream file(path);
+    if (!file) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    content = buffer.str();
+    while (!content.empty() && (content.back() == '\n' || content.back() == ' ')) {
+        content.pop_back();
+    }
+    return true;
+}
+
+/**
+ * @brief Convertit une liste de CPUs au format du kernel ("2-3,5")
+ * 
+ * @return CPUs listés (vide si la liste est vide ou invalide)
+ */
+inline std::vector<int> parse_kernel_cpu_list(const std::string& text)
+{
+    std::vector<int> cpus;
+    std::stringstream stream(text);
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        if (item.empty()) continue;
+        size_t dash = item.find('-');
+        char* end = nullptr;
+        long first = strtol(item.c_str(), &end, 10);
+        long last = first;
+        if (dash != std::string::npos) {
+            last = strtol(item.c_str() + dash + 1, &end, 10);
+        }
+        for (long cpu = first; cpu <= last && cpu - first < 4096; ++cpu) {
+            cpus.push_back(static_cast<int>(cpu));
+        }
+    }
+    return cpus;
+}
+
+/// Un CPU appartient-il à une liste au format du kernel ?
+inline bool cpu_in_list(const std::string& list, int cpu)
+{
+    std::vector<int> cpus = parse_kernel_cpu_list(list);
+    return std::find(cpus.begin(), cpus.end(), cpu) != cpus.end();
+}
+
+/**
+ * @brief Valeur d'un paramètre de la ligne de commande du kernel
+ * 
+ * @return Valeur de "name=valeur" (vide si absent)
+ */
+inline std::string kernel_cmdline_value(const std::string& cmdline, const std::string& name)
+{
+    std::stringstream stream(cmdline);
+    std::string token;
+    const std::string prefix = name + "=";
+    while (stream >> token) {
+        if (token.compare(0, prefix.size(), prefix) == 0) {
+            return token.substr(prefix.size());
+        }
+    }
+    return "";
+}
+
+// ============================================================================
+// INSTANTANÉ
+// ============================================================================
+
+/**
+ * @brief Réglages de fréquence d'un CPU mesuré
+ */
+struct CpuFrequencyInfo {
+    int cpu = 0;
+    std::string governor;      ///< Gouverneur cpufreq (vide = pas de cpufreq)
+    long cur_khz = 0;          ///< Fréquence courante
+    long max_khz = 0;          ///< Fréquence maximale autorisée
+};
+
+/**
+ * @brief IRQ dont l'affinité effective inclut un CPU mesuré
+ */
+struct IrqOnCpu {
+    int irq = 0;
+    std::string name;          ///< Gestionnaire(s) enregistré(s), ex. "mmc1"
+    std::string affinity;      ///< Liste des CPUs (format du kernel)
+};
+
+/**
+ * @brief Configuration système relevée avant la mesure
+ */
+struct SystemSnapshot {
+    std::string hostname;
+    std::string kernel_release;             ///< uname -r
+    std::string kernel_version;             ///< uname -v
+    std::string realtime;                   ///< /sys/kernel/realtime (vide = absent)
+    std::string cmdline;                    ///< /proc/cmdline
+    std::string isolated;                   ///< CPUs isolés (isolcpus)
+    std::string nohz_full;                  ///< CPUs sans tick
+    std::string rcu_nocbs;                  ///< CPUs sans callbacks RCU
+    long rt_runtime_us = 0;                 ///< -1 = pas de limitation RT
+    long rt_period_us = 0;
+    long rtprio_limit = 0;                  ///< RLIMIT_RTPRIO (soft)
+    std::vector<int> target_cpus;           ///< CPUs mesurés
+    std::vector<CpuFrequencyInfo> frequencies;
+    std::vector<IrqOnCpu> irqs;
+    
+    /// Kernel PREEMPT_RT ?
+    bool preempt_rt() const
+    {
+        return realtime == "1" || kernel_version.find("PREEMPT_RT") != std::string::npos;
+    }
+};
+
+/**
+ * @brief Relève la configuration système pour les CPUs mesurés
+ * 
+ * À appeler avant la mesure : lit quelques dizaines de fichiers.
+ * 
+ * @param target_cpus CPUs sur lesquels tournent les threads RT
+ */
+inline SystemSnapshot capture_system_snapshot(const std::vector<int>& target_cpus)
+{
+    SystemSnapshot snap;
+    snap.target_cpus = target_cpus;
+    
+    struct utsname uts;
+    if (uname(&uts) == 0) {
+        snap.hostname = uts.nodename;
+        snap.kernel_release = uts.release;
+        snap.kernel_version = uts.version;
+    }
+    read_sys_file("/sys/kernel/realtime", snap.realtime);
+    read_sys_file("/proc/cmdline", snap.cmdline);
+    read_sys_file("/sys/devices/system/cpu/isolated", snap.isolated);
+    if (!read_sys_file("/sys/devices/system/cpu/nohz_full", snap.nohz_full) || snap.nohz_full == "(null)") {
+        snap.nohz_full = kernel_cmdline_value(snap.cmdline, "nohz_full");
+    }
+    snap.rcu_nocbs = kernel_cmdline_value(snap.cmdline, "rcu_nocbs");
+    
+    std::string value;
+    if (read_sys_file("/proc/sys/kernel/sched_rt_runtime_us", value)) snap.rt_runtime_us = atol(value.c_str());
+    if (read_sys_file("/proc/sys/kernel/sched_rt_period_us", value)) snap.rt_period_us = atol(value.c_str());
+    
+    struct rlimit limit;
+    if (getrlimit(RLIMIT_RTPRIO, &limit) == 0) {
+        snap.rtprio_limit = limit.rlim_cur == RLIM_INFINITY ? 99 : static_cast<long>(limit.rlim_cur);
+    }
+    
+    for (int cpu : target_cpus) {
+        CpuFrequencyInfo info;
+        info.cpu = cpu;
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/";
+        read_sys_file(base + "scaling_governor", info.governor);
+        if (read_sys_file(base + "scaling_cur_freq", value)) info.cur_khz = atol(value.c_str());
+        if (read_sys_file(base + "scaling_max_freq", value)) info.max_khz = atol(value.c_str());
+        snap.frequencies.push_back(info);
+    }
+    
+    /*
+     * /proc/irq/<n>/ : effective_affinity_list donne les CPUs qui traitent
+     * réellement l'IRQ (smp_affinity_list n'est que le souhait). Les
+     * sous-répertoires portent le nom des gestionnaires enregistrés.
+     */
+    DIR* dir = opendir("/proc/irq");
+    if (dir != nullptr) {
+        struct dirent* entry;
+        while ((entry = readdir(dir)) != nullptr) {
+            char* end = nullptr;
+            long irq = strtol(entry->d_name, &end, 10);
+            if (end == entry->d_name || *end != '\0') continue;
+            
+            const std::string base = std::string("/proc/irq/") + entry->d_name + "/";
+            std::string affinity;
+            if (!read_sys_file(base + "effective_affinity_list", affinity) || affinity.empty()) {
+                if (!read_sys_file(base + "smp_affinity_list", affinity)) continue;
+            }
+            bool hits = false;
+            for (int cpu : target_cpus) {
+                hits = hits || cpu_in_list(affinity, cpu);
+            }
+            if (!hits) continue;
+            
+            IrqOnCpu hit;
+            hit.irq = static_cast<int>(irq);
+            hit.affinity = affinity;
+            DIR* handlers = opendir(base.c_str());
+            if (handlers != nullptr) {
+                struct dirent* handler;
+                while ((handler = readdir(handlers)) != nullptr) {
+                    if (handler->d_type == DT_DIR && handler->d_name[0] != '.') {
+                        if (!hit.name.empty()) hit.name += ",";
+                        hit.name += handler->d_name;
+                    }
+                }
+                closedir(handlers);
+            }
+            snap.irqs.push_back(hit);
+        }
+        closedir(dir);
+        std::sort(snap.irqs.begin(), snap.irqs.end(),
+                  [](const IrqOnCpu& a, const IrqOnCpu& b) { return a.irq < b.irq; });
+    }
+    return snap;
+}
+
+// ============================================================================
+// VALIDATION ET SÉRIALISATION
+// ============================================================================
+
+/**
+ * @brief Réglages qui vont dégrader la latence mesurée
+ * 
+ * @param snap Instantané relevé
+ * @param priority Priorité RT demandée (comparée à RLIMIT_RTPRIO hors root)
+ * @return Un message par problème (vide = configuration conforme)
+ */
+inline std::vector<std::string> validate_snapshot(const SystemSnapshot& snap, int priority)
+{
+    std::vector<std::string> warnings;
+    
+    if (!snap.preempt_rt()) {
+        warnings.push_back("kernel sans PREEMPT_RT (" + snap.kernel_release + ")");
+    }
+    for (int cpu : snap.target_cpus) {
+        const std::string name = "CPU " + std::to_string(cpu);
+        if (!cpu_in_list(snap.isolated, cpu)) {
+            warnings.push_back(name + " non isolé (isolcpus, /sys/devices/system/cpu/isolated = '"
+                               + snap.isolated + "')");
+        }
+        if (!cpu_in_list(snap.nohz_full, cpu)) {
+            warnings.push_back(name + " absent de nohz_full : le tick périodique reste actif");
+        }
+        if (!cpu_in_list(snap.rcu_nocbs, cpu)) {
+            warnings.push_back(name + " absent de rcu_nocbs : callbacks RCU exécutés sur ce CPU");
+        }
+    }
+    for (const CpuFrequencyInfo& info : snap.frequencies) {
+        const std::string name = "CPU " + std::to_string(info.cpu);
+        if (!info.governor.empty() && info.governor != "performance") {
+            warnings.push_back(name + " : gouverneur cpufreq '" + info.governor
+                               + "' (préférer 'performance')");
+        }
+        if (info.max_khz > 0 && info.cur_khz > 0 && info.cur_khz < info.max_khz) {
+            warnings.push_back(name + " : " + std::to_string(info.cur_khz / 1000) + " MHz sur "
+                               + std::to_string(info.max_khz / 1000) + " MHz possibles");
+        }
+    }
+    if (snap.rt_runtime_us >= 0 && snap.rt_runtime_us < snap.rt_period_us) {
+        warnings.push_back("limitation RT active : " + std::to_string(snap.rt_runtime_us) + " µs sur "
+                           + std::to_string(snap.rt_period_us)
+                           + " µs (sched_rt_runtime_us=-1 pour la désactiver)");
+    }
+    if (!snap.irqs.empty()) {
+        std::string list;
+        for (size_t k = 0; k < snap.irqs.size() && k < 6; ++k) {
+            if (!list.empty()) list += ", ";
+            list += std::to_string(snap.irqs[k].irq);
+            if (!snap.irqs[k].name.empty()) list += " " + snap.irqs[k].name;
+        }
+        if (snap.irqs.size() > 6) list += ", ...";
+        warnings.push_back(std::to_string(snap.irqs.size()) + " IRQ(s) routée(s) vers les CPUs mesurés ("
+                           + list + ")");
+    }
+    if (geteuid() != 0 && snap.rtprio_limit < priority) {
+        warnings.push_back("RLIMIT_RTPRIO = " + std::to_string(snap.rtprio_limit)
+                           + " < priorité " + std::to_string(priority) + " (ulimit -r)");
+    }
+    return warnings;
+}
+
+/**
+ * @brief Instantané au format "clé=valeur", une ligne par réglage
+ * 
+ * Format stable, embarqué dans le journal (préfixé par "# ") et dans la
+ * trace binaire (après l'en-tête).
+ */
+inline std::string snapshot_to_text(const SystemSnapshot& snap)
+{
+    std::ostringstream text;
+    text << "host=" << snap.hostname << "\n"
+         << "kernel.release=" << snap.kernel_release << "\n"
+         << "kernel.version=" << snap.kernel_version << "\n"
+         << "kernel.preempt_rt=" << (snap.preempt_rt() ? 1 : 0) << "\n"
+         << "kernel.cmdline=" << snap.cmdline << "\n"
+         << "cpu.isolated=" << snap.isolated << "\n"
+         << "cpu.nohz_full=" << snap.nohz_full << "\n"
+         << "cpu.rcu_nocbs=" << snap.rcu_nocbs << "\n"
+         << "sched.rt_runtime_us=" << snap.rt_runtime_us << "\n"
+         << "sched.rt_period_us=" << snap.rt_period_us << "\n"
+         << "rlimit.rtprio=" << snap.rtprio_limit << "\n";
+    for (const CpuFrequencyInfo& info : snap.frequencies) {
+        const std::string key = "cpu" + std::to_string(info.cpu) + ".";
+        text << key << "governor=" << info.governor << "\n"
+             << key << "cur_khz=" << info.cur_khz << "\n"
+             << key << "max_khz=" << info.max_khz << "\n";
+    }
+    for (const IrqOnCpu& irq : snap.irqs) {
+        text << "irq." << irq.irq << "=" << irq.name << " [" << irq.affinity << "]\n";
+    }
+    return text.str();
+}
+
+#endif // RT_SYSINFO_H
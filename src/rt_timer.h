@@ -0,0 +1,270 @@
+/**
+ * @file rt_timer.h
+ * @brief Mécanismes de réveil périodique interchangeables
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * clock_nanosleep(TIMER_ABSTIME) est le réveil de référence, mais pour des
+ * périodes inférieures à 100 µs d'autres chemins peuvent avoir moins de
+ * gigue. Ce fichier les rend interchangeables derrière une même interface
+ * wait_until(échéance) :
+ * 
+ * - nanosleep : clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME)
+ * - timerfd   : timerfd armé en absolu, réveil par read() bloquant
+ * - signal    : timer_create() POSIX, signal temps réel dirigé vers le
+ *               thread (SIGEV_THREAD_ID), attendu par sigwaitinfo()
+ * - hybrid    : sommeil jusqu'à N µs avant l'échéance, puis attente active
+ *               sur l'horloge de mesure (TimestampClock) jusqu'à l'échéance
+ * - busy      : attente active sur toute la période (le CPU n'est jamais
+ *               rendu : CPU isolé indispensable)
+ * 
+ * Toutes les échéances sont absolues : les dépassements de période (SKIP
+ * ou CATCH_UP) se comportent de la même façon quel que soit le mécanisme.
+ */
+
+#ifndef RT_TIMER_H
+#define RT_TIMER_H
+
+#include <time.h>
+#include <signal.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <sys/timerfd.h>
+#include <sys/syscall.h>
+#include <string>
+
+#include "rt_utils.h"
+#include "rt_clock.h"
+
+#ifndef sigev_notify_thread_id
+#define sigev_notify_thread_id _sigev_un._tid   // Absent des en-têtes de la glibc
+#endif
+
+// ============================================================================
+// MÉCANISMES DE RÉVEIL
+// ============================================================================
+
+/**
+ * @brief Mécanisme utilisé pour attendre l'échéance de chaque cycle
+ */
+enum class TimerBackend {
+    NANOSLEEP,   ///< clock_nanosleep absolu (défaut)
+    TIMERFD,     ///< timerfd + read()
+    SIGNAL,      ///< timer_create + sigwaitinfo()
+    HYBRID,      ///< Sommeil puis attente active
+    BUSY         ///< Attente active pure
+};
+
+/// Tous les mécanismes, dans l'ordre du comparatif (--timer all)
+constexpr TimerBackend ALL_TIMER_BACKENDS[] = {
+    TimerBackend::NANOSLEEP, TimerBackend::TIMERFD, TimerBackend::SIGNAL,
+    TimerBackend::HYBRID, TimerBackend::BUSY
+};
+
+/**
+ * @brief Nom d'un mécanisme (tel qu'accepté par --timer)
+ */
+inline const char* timer_backend_name(TimerBackend backend)
+{
+    switch (backend) {
+        case TimerBackend::TIMERFD: return "timerfd";
+        case TimerBackend::SIGNAL:  return "signal";
+        case TimerBackend::HYBRID:  return "hybrid";
+        case TimerBackend::BUSY:    return "busy";
+        default:                    return "nanosleep";
+    }
+}
+
+/**
+ * @brief Convertit un nom de mécanisme
+ * 
+ * @return true si le nom est connu
+ */
+inline bool parse_timer_backend(const std::string& name, TimerBackend& backend)
+{
+    for (TimerBackend candidate : ALL_TIMER_BACKENDS) {
+        if (name == timer_backend_name(candidate)) {
+            backend = candidate;
+            return true;
+        }
+    }
+    return false;
+}
+
+// ============================================================================
+// ATTENTE D'UNE ÉCHÉANCE ABSOLUE
+// ============================================================================
+
+/**
+ * @brief Attend des échéances absolues (CLOCK_MONOTONIC) avec le mécanisme choisi
+ * 
+ * open() doit être appelé par le thread qui attendra : le signal du
+ * mécanisme SIGNAL est dirigé vers ce thread précis.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * PeriodicWaiter waiter;
+ * if (!waiter.open(TimerBackend::TIMERFD, 0)) { ... waiter.error() ... }
+ * for (;;) {
+ *     waiter.wait_until(next_period);
+ *     // ... cycle ...
+ *     timespec_add_us(next_period, period_us);
+ * }
+ * @endcode
+ */
+class PeriodicWaiter {
+public:
+    PeriodicWaiter() = default;
+    PeriodicWaiter(const PeriodicWaiter&) = delete;
+    PeriodicWaiter& operator=(const PeriodicWaiter&) = delete;
+    ~PeriodicWaiter() { close(); }
+    
+    /**
+     * @brief Prépare le mécanisme (descripteur, timer POSIX, masque de signaux)
+     * 
+     * @param backend Mécanisme de réveil
+     * @param spin_us Mode HYBRID : durée d'attente active avant l'échéance
+     * @param clock Horloge scrutée par l'attente active (nullptr = CLOCK_MONOTONIC) ;
+     *              doit rester valide tant que le mécanisme est ouvert
+     * @return true en cas de succès ; sinon error() décrit l'erreur
+     */
+    bool open(TimerBackend backend, int spin_us, const TimestampClock* clock = nullptr)
+    {
+        close();
+        backend_ = backend;
+        spin_ns_ = static_cast<uint64_t>(spin_us) * 1000;
+        clock_ = clock != nullptr ? clock : &default_clock_;
+        
+        if (backend_ == TimerBackend::TIMERFD) {
+            fd_ = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC);
+            if (fd_ < 0) {
+                return fail("timerfd_create");
+            }
+        } else if (backend_ == TimerBackend::SIGNAL) {
+            /*
+             * Le signal est bloqué puis attendu de façon synchrone par
+             * sigwaitinfo() : pas de gestionnaire asynchrone, pas de
+             * contraintes async-signal-safe, et un réveil aussi direct
+             * qu'un appel système bloquant.
+             */
+            signo_ = SIGRTMIN;
+            sigemptyset(&sigset_);
+            sigaddset(&sigset_, signo_);
+            sigset_t previous;
+            int err = pthread_sigmask(SIG_BLOCK, &sigset_, &previous);
+            if (err != 0) {
+                errno = err;
+                return fail("pthread_sigmask");
+            }
+            // Débloqué par close(), même si timer_create() échoue, sauf s'il l'était déjà avant
+            signal_blocked_ = sigismember(&previous, signo_) == 0;
+            
+            struct sigevent sev;
+            memset(&sev, 0, sizeof(sev));
+            sev.sigev_notify = SIGEV_THREAD_ID;
+            sev.sigev_signo = signo_;
+            sev.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+            if (timer_create(CLOCK_MONOTONIC, &sev, &timer_) != 0) {
+                return fail("timer_create");
+            }
+            timer_created_ = true;
+        }
+        return true;
+    }
+    
+    /**
+     * @brief Attend l'échéance absolue donnée
+     * 
+     * Retour immédiat si l'échéance est déjà passée (dépassement).
+     */
+    void wait_until(const struct timespec& deadline)
+    {
+        switch (backend_) {
+            case TimerBackend::TIMERFD: {
+                struct itimerspec spec = {};
+                spec.it_value = deadline;
+                timerfd_settime(fd_, TFD_TIMER_ABSTIME, &spec, NULL);
+                uint64_t expirations;
+                while (read(fd_, &expirations, sizeof(expirations)) < 0 && errno == EINTR) {}
+                break;
+            }
+            case TimerBackend::SIGNAL: {
+                struct itimerspec spec = {};
+                spec.it_value = deadline;
+                timer_settime(timer_, TIMER_ABSTIME, &spec, NULL);
+                siginfo_t info;
+                while (sigwaitinfo(&sigset_, &info) < 0 && errno == EINTR) {}
+                break;
+            }
+            case TimerBackend::HYBRID: {
+                // Sommeil jusqu'à spin_ns avant l'échéance : le réveil du kernel
+                // a le temps d'arriver, la fin de l'attente est une boucle serrée
+                uint64_t deadline_ns = timespec_to_ns(deadline);
+                if (deadline_ns > spin_ns_) {
+                    struct timespec wake = ns_to_timespec(deadline_ns - spin_ns_);
+                    clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &wake, NULL);
+                }
+                spin_until(deadline_ns);
+                break;
+            }
+            case TimerBackend::BUSY:
+                spin_until(timespec_to_ns(deadline));
+                break;
+            default:
+                clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+                break;
+        }
+    }
+    
+    /// Libère le descripteur ou le timer POSIX
+    void close()
+    {
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        if (timer_created_) {
+            timer_delete(timer_);
+            timer_created_ = false;
+        }
+        if (signal_blocked_) {
+            pthread_sigmask(SIG_UNBLOCK, &sigset_, NULL);
+            signal_blocked_ = false;
+        }
+    }
+    
+    TimerBackend backend() const { return backend_; }     ///< Mécanisme actif
+    const std::string& error() const { return error_; }   ///< Dernière erreur
+
+private:
+    /// Attente active : échéance convertie une fois, puis lectures brutes de l'horloge
+    void spin_until(uint64_t deadline_ns) const
+    {
+        const uint64_t deadline = clock_->from_ns(deadline_ns);
+        while (clock_->now() < deadline) {}
+    }
+    
+    bool fail(const char* what)
+    {
+        error_ = std::string(what) + ": " + strerror(errno);
+        close();
+        return false;
+    }
+    
+    TimerBackend backend_ = TimerBackend::NANOSLEEP;
+    uint64_t spin_ns_ = 0;
+    TimestampClock default_clock_;
+    const TimestampClock* clock_ = &default_clock_;
+    int fd_ = -1;
+    timer_t timer_ {};
+    bool timer_created_ = false;
+    bool signal_blocked_ = false;   ///< SIGRTMIN bloqué par open(), à débloquer
+    int signo_ = 0;
+    sigset_t sigset_ {};
+    std::string error_;
+};
+
+#endif // RT_TIMER_H
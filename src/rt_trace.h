@@ -0,0 +1,395 @@
+/**
+ * @file rt_trace.h
+ * @brief Fichier de trace binaire des échantillons de latence
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Ce fichier contient :
+ * - Le format du fichier de trace (en-tête + tableau d'enregistrements)
+ * - Un écrivain à base de mmap pré-chargé et verrouillé en RAM : enregistrer
+ *   un échantillon coûte un simple store mémoire dans la boucle temps réel
+ * - Un lecteur pour l'analyse a posteriori (rt_tuto --analyze <fichier>)
+ * 
+ * FORMAT DU FICHIER (little-endian, natif Raspberry Pi / x86_64) :
+ * @code
+ *   +--------------------------+  offset 0
+ *   | TraceFileHeader          |  magic, version, période, CPU, priorité,
+ *   |                          |  nombre d'enregistrements, uname du kernel
+ *   +--------------------------+  offset sizeof(TraceFileHeader)
+ *   | Métadonnées (optionnel)  |  texte "clé=valeur" terminé par '\0'
+ *   |                          |  (configuration système, rt_sysinfo.h)
+ *   +--------------------------+  offset header_size
+ *   | TraceRecord[0]           |  instant de réveil (ns) + latence (ns)
+ *   | TraceRecord[1]           |
+ *   | ...                      |
+ *   +--------------------------+
+ * @endcode
+ */
+
+#ifndef RT_TRACE_H
+#define RT_TRACE_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/utsname.h>
+#include <string>
+#include <algorithm>
+
+// ============================================================================
+// FORMAT DU FICHIER DE TRACE
+// ============================================================================
+
+/// Signature en tête de fichier
+#define RT_TRACE_MAGIC "RTTRACE"
+
+/// Version du format (à incrémenter à chaque changement incompatible)
+constexpr uint32_t RT_TRACE_VERSION = 1;
+
+/**
+ * @brief En-tête du fichier de trace
+ * 
+ * header_size permet d'ajouter des informations après l'en-tête dans une
+ * version future sans casser les lecteurs existants : les enregistrements
+ * commencent toujours à l'offset header_size.
+ */
+struct TraceFileHeader {
+    char magic[8];              ///< RT_TRACE_MAGIC
+    uint32_t version;           ///< RT_TRACE_VERSION
+    uint32_t header_size;       ///< Offset du premier enregistrement
+    uint32_t record_size;       ///< sizeof(TraceRecord)
+    uint32_t period_us;         ///< Période de la tâche (µs)
+    int32_t cpu;                ///< CPU de la mesure
+    int32_t priority;           ///< Priorité SCHED_FIFO
+    uint64_t record_count;      ///< Nombre d'enregistrements valides
+    uint64_t start_ns;          ///< Premier réveil prévu (CLOCK_MONOTONIC, ns)
+    char sysname[65];           ///< uname -s
+    char nodename[65];          ///< uname -n
+    char release[65];           ///< uname -r (doit contenir 'rt' ou 'realtime')
+    char kernel_version[65];    ///< uname -v
+    char machine[65];           ///< uname -m
+};
+
+/**
+ * @brief Enregistrement d'un cycle (12 octets, sans remplissage)
+ * 
+ * La latence est saturée à ~4,29 s (UINT32_MAX ns), largement au-delà de
+ * toute valeur significative pour une tâche périodique.
+ */
+struct __attribute__((packed)) TraceRecord {
+    uint64_t timestamp_ns;      ///< Instant de réveil mesuré (CLOCK_MONOTONIC)
+    uint32_t latency_ns;        ///< Latence de réveil (ns)
+};
+
+// ============================================================================
+// ÉCRIVAIN (CÔTÉ TEMPS RÉEL)
+// ============================================================================
+
+/**
+ * @brief Écrit les échantillons dans un fichier projeté en mémoire
+ * 
+ * POURQUOI mmap ?
+ * Un write() par cycle serait un appel système dans la boucle RT. Ici, le
+ * fichier est dimensionné et projeté en mémoire AVANT la mesure, chaque page
+ * est touchée (pré-chargement) puis verrouillée avec mlock() : pendant la
+ * boucle, enregistrer un échantillon n'est qu'une écriture en RAM, sans
+ * page fault. Le kernel recopie les pages sur disque en arrière-plan.
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * TraceWriter trace;
+ * if (trace.open("run.trace", 10000, header)) {
+ *     trace.record(now_ns, latency_ns);   // dans la boucle RT
+ *     trace.close();                      // après la boucle
+ * }
+ * @endcode
+ */
+class TraceWriter {
+public:
+    TraceWriter() = default;
+    TraceWriter(const TraceWriter&) = delete;
+    TraceWriter& operator=(const TraceWriter&) = delete;
+    ~TraceWriter() { close(); }
+    
+    /**
+     * @brief Crée le fichier, le projette en mémoire et le pré-charge
+     * 
+     * @param path Chemin du fichier (écrasé s'il existe)
+     * @param capacity Nombre maximal d'enregistrements
+     * @param header En-tête (magic, version, tailles et uname sont remplis ici)
+     * @param metadata Texte libre stocké entre l'en-tête et les enregistrements
+     * @return true en cas de succès ; sinon error() décrit l'erreur
+     */
+    bool open(const std::string& path, uint64_t capacity, const TraceFileHeader& header,
+              const std::string& metadata = std::string())
+    {
+        close();
+        
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (fd_ < 0) {
+            return fail("open");
+        }
+        
+        capacity_ = capacity;
+        
+        // Enregistrements alignés sur 8 octets après les métadonnées
+        data_offset_ = sizeof(TraceFileHeader);
+        if (!metadata.empty()) {
+            data_offset_ += (metadata.size() + 1 + 7) & ~static_cast<size_t>(7);
+        }
+        size_ = data_offset_ + static_cast<size_t>(capacity) * sizeof(TraceRecord);
+        
+        if (ftruncate(fd_, static_cast<off_t>(size_)) != 0) {
+            return fail("ftruncate");
+        }
+        
+        void* addr = mmap(NULL, size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (addr == MAP_FAILED) {
+            return fail("mmap");
+        }
+        base_ = static_cast<uint8_t*>(addr);
+        
+        // Pré-chargement : toucher chaque page pour créer les pages du cache
+        // de fichier maintenant, et non au premier accès dans la boucle RT
+        const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        for (size_t off = 0; off < size_; off += page) {
+            base_[off] = 0;
+        }
+        
+        if (mlock(base_, size_) != 0) {
+            return fail("mlock");
+        }
+        
+        header_ = reinterpret_cast<TraceFileHeader*>(base_);
+        records_ = reinterpret_cast<TraceRecord*>(base_ + data_offset_);
+        count_ = 0;
+        
+        *header_ = header;
+        memcpy(header_->magic, RT_TRACE_MAGIC, sizeof(RT_TRACE_MAGIC));
+        header_->version = RT_TRACE_VERSION;
+        header_->header_size = static_cast<uint32_t>(data_offset_);
+        header_->record_size = static_cast<uint32_t>(sizeof(TraceRecord));
+        header_->record_count = 0;
+        
+        struct utsname uts;
+        if (uname(&uts) == 0) {
+            copy_field(header_->sysname, uts.sysname);
+            copy_field(header_->nodename, uts.nodename);
+            copy_field(header_->release, uts.release);
+            copy_field(header_->kernel_version, uts.version);
+            copy_field(header_->machine, uts.machine);
+        }
+        if (!metadata.empty()) {
+            memcpy(base_ + sizeof(TraceFileHeader), metadata.data(), metadata.size());
+        }
+        
+        return true;
+    }
+    
+    /**
+     * @brief Enregistre un cycle - un store en mémoire, aucun appel système
+     * 
+     * Les enregistrements au-delà de la capacité sont ignorés.
+     */
+    void record(uint64_t timestamp_ns, uint64_t latency_ns)
+    {
+        if (count_ < capacity_) {
+            TraceRecord& r = records_[count_++];
+            r.timestamp_ns = timestamp_ns;
+            r.latency_ns = latency_ns > UINT32_MAX ? UINT32_MAX
+                                                   : static_cast<uint32_t>(latency_ns);
+        }
+    }
+    
+    /**
+     * @brief Finalise l'en-tête, ajuste la taille du fichier et le ferme
+     * 
+     * À appeler APRÈS la boucle temps réel (msync et ftruncate sont des
+     * appels système potentiellement longs).
+     */
+    void close()
+    {
+        if (base_ != nullptr) {
+            header_->record_count = count_;
+            msync(base_, size_, MS_SYNC);
+            munlock(base_, size_);
+            munmap(base_, size_);
+            base_ = nullptr;
+            header_ = nullptr;
+            records_ = nullptr;
+            
+            // Retirer la partie non utilisée (test interrompu ou plus court)
+            if (ftruncate(fd_, static_cast<off_t>(data_offset_ + count_ * sizeof(TraceRecord))) != 0) {
+                error_ = std::string("ftruncate: ") + strerror(errno);
+            }
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+    
+    bool is_open() const { return base_ != nullptr; }       ///< Trace active ?
+    uint64_t count() const { return count_; }                ///< Enregistrements écrits
+    const std::string& error() const { return error_; }      ///< Dernière erreur
+
+private:
+    bool fail(const char* what)
+    {
+        error_ = std::string(what) + ": " + strerror(errno);
+        if (base_ != nullptr) {
+            munmap(base_, size_);
+            base_ = nullptr;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+        return false;
+    }
+    
+    static void copy_field(char (&dst)[65], const char* src)
+    {
+        const size_t length = strnlen(src, sizeof(dst) - 1);
+        memcpy(dst, src, length);
+        dst[length] = '\0';
+    }
+    
+    int fd_ = -1;
+    uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    size_t data_offset_ = sizeof(TraceFileHeader);   ///< = header_size
+    TraceFileHeader* header_ = nullptr;
+    TraceRecord* records_ = nullptr;
+    uint64_t capacity_ = 0;
+    uint64_t count_ = 0;
+    std::string error_;
+};
+
+// ============================================================================
+// LECTEUR (ANALYSE A POSTERIORI)
+// ============================================================================
+
+/**
+ * @brief Ouvre un fichier de trace en lecture via mmap
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * TraceReader reader;
+ * if (reader.open("run.trace")) {
+ *     for (uint64_t i = 0; i < reader.count(); ++i) {
+ *         histogram.record(reader.record(i).latency_ns);
+ *     }
+ * }
+ * @endcode
+ */
+class TraceReader {
+public:
+    TraceReader() = default;
+    TraceReader(const TraceReader&) = delete;
+    TraceReader& operator=(const TraceReader&) = delete;
+    ~TraceReader() { close(); }
+    
+    /**
+     * @brief Ouvre et valide un fichier de trace
+     * 
+     * @param path Chemin du fichier
+     * @return true si le fichier est une trace valide ; sinon error() décrit l'erreur
+     */
+    bool open(const std::string& path)
+    {
+        close();
+        
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            error_ = std::string("open: ") + strerror(errno);
+            return false;
+        }
+        
+        struct stat st;
+        if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(TraceFileHeader)) {
+            error_ = "fichier trop court pour être une trace";
+            ::close(fd);
+            return false;
+        }
+        size_ = static_cast<size_t>(st.st_size);
+        
+        void* addr = mmap(NULL, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // La projection reste valide après close()
+        if (addr == MAP_FAILED) {
+            error_ = std::string("mmap: ") + strerror(errno);
+            return false;
+        }
+        base_ = static_cast<const uint8_t*>(addr);
+        
+        const TraceFileHeader* h = header();
+        if (memcmp(h->magic, RT_TRACE_MAGIC, sizeof(RT_TRACE_MAGIC)) != 0) {
+            return fail("signature invalide (pas un fichier de trace rt_tuto)");
+        }
+        if (h->version != RT_TRACE_VERSION) {
+            return fail("version de format non supportée");
+        }
+        if (h->record_size != sizeof(TraceRecord) || h->header_size < sizeof(TraceFileHeader)
+            || h->header_size > size_) {
+            return fail("taille d'en-tête ou d'enregistrement incohérente");
+        }
+        
+        // Ne jamais lire au-delà du fichier, même si record_count est faux
+        uint64_t available = (size_ - h->header_size) / sizeof(TraceRecord);
+        count_ = std::min(h->record_count, available);
+        records_ = reinterpret_cast<const TraceRecord*>(base_ + h->header_size);
+        
+        return true;
+    }
+    
+    /// Libère la projection
+    void close()
+    {
+        if (base_ != nullptr) {
+            munmap(const_cast<uint8_t*>(base_), size_);
+            base_ = nullptr;
+            records_ = nullptr;
+            count_ = 0;
+        }
+    }
+    
+    const TraceFileHeader* header() const
+    {
+        return reinterpret_cast<const TraceFileHeader*>(base_);
+    }
+    
+    /// Métadonnées stockées entre l'en-tête et les enregistrements (vide si aucune)
+    std::string metadata() const
+    {
+        const size_t offset = sizeof(TraceFileHeader);
+        const size_t size = header()->header_size - offset;
+        const char* text = reinterpret_cast<const char*>(base_ + offset);
+        return std::string(text, strnlen(text, size));
+    }
+    
+    uint64_t count() const { return count_; }                         ///< Enregistrements lisibles
+    const TraceRecord& record(uint64_t i) const { return records_[i]; }  ///< i-ème enregistrement
+    const std::string& error() const { return error_; }               ///< Dernière erreur
+
+private:
+    bool fail(const char* what)
+    {
+        error_ = what;
+        close();
+        return false;
+    }
+    
+    const uint8_t* base_ = nullptr;
+    size_t size_ = 0;
+    const TraceRecord* records_ = nullptr;
+    uint64_t count_ = 0;
+    std::string error_;
+};
+
+#endif // RT_TRACE_H
@@ -40,8 +40,31 @@
  * UTILISATION
  * ============================================================================
  * 
- *   sudo ./rt_tuto            # Démonstration complète des APIs RT
- *   ./rt_tuto --help          # Afficher l'aide
+ *   sudo ./rt_tuto                          # Démonstration complète des APIs RT
+ *   sudo ./rt_tuto --period 250 --cpu 3     # Période et CPU personnalisés
+ *   sudo ./rt_tuto --cpus 2,3               # Un thread RT par CPU isolé
+ *   sudo ./rt_tuto --trace run.trace        # Enregistre les échantillons
+ *   sudo ./rt_tuto --workload fir:2048      # Charge de calcul à chaque cycle
+ *   sudo ./rt_tuto --stress --duration 60   # Mesure sous charge (CPUs 0/1)
+ *   sudo ./rt_tuto --soak                   # Rodage sans limite, résumé par minute/heure
+ *   sudo ./rt_tuto --compare                # Comparaison sans RT / avec RT
+ *   sudo ./rt_tuto --sweep                  # Effet de chaque réglage RT isolé
+ *   sudo ./rt_tuto --policy deadline        # Réservation EDF (SCHED_DEADLINE)
+ *   sudo ./rt_tuto --memory-guard abort     # Arrêt sur allocation/page fault
+ *   sudo ./rt_tuto --timer all --period 100 # Comparatif des mécanismes de réveil
+ *   sudo ./rt_tuto --clock cntvct           # Horodatage par le compteur ARM (RPi 4)
+ *   sudo ./rt_tuto --subtract-overhead      # Latences nettes du coût de l'instrument
+ *   sudo ./rt_tuto --pmu --workload fir:2048 # Compteurs PMU des cycles de la queue
+ *   sudo ./rt_tuto --break-on 100           # Trace kernel figée au premier pic > 100 µs
+ *   sudo ./rt_tuto --task 1000:fir --task 4000 --task 100000  # Tâches multi-cadences
+ *   sudo ./rt_tuto --ipc all --peer-cpu 3   # Coût des primitives de messagerie RT → non-RT
+ *   sudo ./rt_tuto --cache-sweep            # Temps d'exécution RT vs empreinte d'un voisin
+ *   sudo ./rt_tuto --gpio 17                # Broche basculée à chaque cycle (analyseur logique)
+ *   sudo ./rt_tuto --gpio 17 --gpio-input 27 # Aller-retour sortie → IRQ → espace utilisateur
+ *   sudo ./rt_tuto --format json > run.json # Résultats JSON (affichage sur stderr)
+ *   ./rt_tuto --analyze run.trace           # Relit et analyse une trace
+ *   sudo ./rt_tuto --baseline ref.trace --max-p99 50  # Porte de CI (code 2)
+ *   ./rt_tuto --help                        # Afficher l'aide (toutes les options)
  * 
  * ============================================================================
  */
@@ -58,6 +81,8 @@
 #include <errno.h>        // Codes d'erreur
 #include <string.h>       // strerror()
 #include <unistd.h>       // getopt(), sysconf()
+#include <sys/syscall.h>  // syscall(SYS_sched_setattr) pour SCHED_DEADLINE
+#include <signal.h>       // sigaction() : arrêt propre du mode --soak
 
 // Headers C++ standard
 #include <iostream>       // Sortie console
@@ -65,327 +90,2536 @@
 #include <vector>         // Stockage des latences
 #include <cmath>          // sqrt() pour l'écart-type
 #include <algorithm>      // min_element(), max_element()
+#include <string>         // Analyse des arguments
+#include <cstdlib>        // strtol()
+#include <climits>        // INT_MAX
+#include <atomic>         // Arrêt du thread de rapport
+#include <fstream>        // Journal des échantillons (--log)
+#include <sstream>        // Instantané système ligne à ligne
+#include <memory>         // std::unique_ptr
+#include <utility>        // std::pair
 
-// Header utilitaire local
+// Headers utilitaires locaux
 #include "rt_utils.h"
+#include "rt_core.h"
+#include "rt_executive.h"
+#include "rt_trace.h"
+#include "rt_workload.h"
+#include "rt_stress.h"
+#include "rt_memory.h"
+#include "rt_timer.h"
+#include "rt_clock.h"
+#include "rt_ftrace.h"
+#include "rt_sysinfo.h"
+#include "rt_interference.h"
+#include "rt_ipc.h"
+#include "rt_window.h"
+#include "rt_export.h"
+#include "rt_baseline.h"
+#include "rt_gpio.h"
 
 // ============================================================================
 // CONSTANTES DE CONFIGURATION
 // ============================================================================
 
 /**
- * PÉRIODE DE LA TÂCHE PÉRIODIQUE
+ * CPU DE SERVICE POUR LE THREAD DE RAPPORT (valeur par défaut, option --report-cpu)
  * 
- * Pour une application temps réel typique (contrôle, robotique), une période
- * de 1 ms (1000 µs) est courante. Plus la période est courte, plus les
- * contraintes de latence sont strictes.
+ * Les CPUs 0 et 1 ne sont pas isolés : ils accueillent le thread non-RT qui
+ * formate la progression et écrit les fichiers, loin du cœur mesuré.
  */
-constexpr int PERIOD_US = 1000;  // 1000 µs = 1 ms
+constexpr int DEFAULT_REPORT_CPU = 0;
 
 /**
- * NOMBRE D'ITÉRATIONS
+ * CAPACITÉ DE LA FILE D'ÉCHANTILLONS RT → RAPPORT
  * 
- * Pour une démonstration pédagogique, 1000 itérations (1 seconde) suffisent.
- * Pour des tests de stress réels, utilisez cyclictest avec des millions
- * d'itérations.
+ * 16384 échantillons (~384 Ko) absorbent plus d'une seconde de blocage du
+ * thread de rapport (écriture sur carte SD par exemple) à 10 kHz.
  */
-constexpr int NUM_ITERATIONS = 1000;
+constexpr size_t SAMPLE_RING_CAPACITY = 16384;
 
 /**
- * PRIORITÉ TEMPS RÉEL
+ * MONTÉE EN CHARGE AVANT LA MESURE (option --stress)
  * 
- * Sous Linux, les priorités SCHED_FIFO vont de 1 (plus basse) à 99 (plus haute).
- * Une priorité de 80 est suffisante pour la plupart des applications tout en
- * laissant de la marge pour d'éventuels threads critiques du système.
+ * Les threads de charge ont besoin d'un instant pour remplir les caches, la
+ * file d'écriture de la carte SD et les workqueues : sans cette attente, les
+ * premiers cycles seraient mesurés sur un système encore calme.
  */
-constexpr int RT_PRIORITY = 80;
+constexpr int STRESS_WARMUP_MS = 500;
+
+/// Dégradation du p99 d'exécution tolérée face à un agresseur (--cache-sweep)
+constexpr double CACHE_SWEEP_TOLERANCE = 1.10;
+
+/**
+ * BUDGET SCHED_DEADLINE ESTIMÉ (option --policy deadline sans --runtime)
+ * 
+ * La charge est exécutée DEADLINE_CALIBRATION_RUNS fois avant la mesure ;
+ * le budget (runtime) vaut 1,25 × le pire temps observé plus une marge fixe
+ * couvrant le réveil, la mesure et la publication de l'échantillon.
+ */
+constexpr int DEADLINE_CALIBRATION_RUNS = 50;
+constexpr int DEADLINE_RUNTIME_MARGIN_US = 50;
+
+/**
+ * RÉSERVE DE TAS PRÉ-CHARGÉE (option --prefault-heap)
+ * 
+ * Réserve de tas pré-chargée au démarrage : elle absorbe les allocations
+ * tardives (histogrammes des threads, tampons des charges). La profondeur de
+ * pile touchée par chaque thread RT (--prefault-stack) est définie dans
+ * rt_core.h.
+ */
+constexpr int DEFAULT_PREFAULT_HEAP_KB = 8192;
+
+/**
+ * FENÊTRES DU MODE RODAGE (options --soak, --soak-window)
+ * 
+ * Une ligne de résumé par fenêtre courte (une minute par défaut) et par
+ * fenêtre longue (SOAK_LONG_WINDOW_FACTOR fenêtres courtes : une heure).
+ * Les anneaux gardent la dernière heure de minutes et 72 h d'heures : de
+ * quoi dater un pic sur tout un rodage, à mémoire constante.
+ */
+constexpr int DEFAULT_SOAK_WINDOW_S = 60;
+constexpr int SOAK_LONG_WINDOW_FACTOR = 60;
+constexpr size_t SOAK_SHORT_WINDOWS = 60;
+constexpr size_t SOAK_LONG_WINDOWS = 72;
+
+/**
+ * RÉÉCRITURE DU FICHIER PROMETHEUS (option --prom-file)
+ * 
+ * Le thread de rapport réécrit le fichier chaque seconde : bien plus souvent
+ * que l'intervalle de collecte habituel (15 s), pour un coût négligeable.
+ */
+constexpr int PROM_WRITE_INTERVAL_MS = 1000;
+
+/**
+ * CODE DE SORTIE D'UNE RÉGRESSION (options --baseline et --max-*)
+ * 
+ * Distinct de 1 (erreur de configuration ou d'exécution) : la CI distingue
+ * « la mesure a échoué » de « la mesure a réussi et révèle une régression ».
+ */
+constexpr int EXIT_REGRESSION = 2;
+
+/**
+ * @brief Tâche de l'exécutif multi-cadences (option --task période[:charge])
+ */
+struct RateTaskSpec {
+    int period_us = 0;       ///< Période de la tâche (µs)
+    WorkloadSpec workload;   ///< Travail de la tâche (défaut: aucun)
+};
+
+/**
+ * @brief Paramètres d'exécution du test, modifiables en ligne de commande
+ * 
+ * Permet de balayer plusieurs configurations (période, priorité, CPU) avec
+ * un seul binaire déployé, sans recompiler. Les paramètres de la tâche
+ * périodique elle-même (période, politique, CPU, réveil...) sont ceux de
+ * RtTaskConfig (rt_core.h) ; s'y ajoutent ceux de l'outil de mesure.
+ */
+struct RtConfig : RtTaskConfig {
+    std::vector<int> cpus;                   ///< Mode multi-threads : un thread par CPU (vide = désactivé)
+    int report_cpu = DEFAULT_REPORT_CPU;     ///< CPU du thread de rapport (non-RT)
+    std::string log_path;                    ///< Journal texte des échantillons (vide = aucun)
+    std::string trace_path;                  ///< Trace binaire des échantillons (vide = aucune)
+    WorkloadSpec workload;                   ///< Charge exécutée à chaque cycle (défaut: aucune)
+    bool stress = false;                     ///< Charge de fond sur les CPUs de service
+    std::vector<int> stress_cpus;            ///< CPUs de la charge de fond (vide = 0 et 1)
+    std::string stress_dir = ".";            ///< Répertoire des écritures de la charge io
+    int prefault_heap_kb = DEFAULT_PREFAULT_HEAP_KB;    ///< Réserve de tas pré-chargée
+    int break_on_us = 0;                     ///< Seuil de l'instantané ftrace (µs, 0 = désactivé)
+    std::string break_events = DEFAULT_BREAK_EVENTS;   ///< Événements kernel enregistrés
+    std::string break_file = DEFAULT_BREAK_FILE;       ///< Destination de la trace kernel
+    std::string system_snapshot;             ///< Configuration système "clé=valeur" (rt_sysinfo.h)
+    std::vector<RateTaskSpec> tasks;         ///< Exécutif multi-cadences (vide = désactivé)
+    std::vector<IpcPrimitive> ipc;           ///< Banc de messagerie (vide = désactivé)
+    int peer_cpu = DEFAULT_REPORT_CPU;       ///< CPU du thread pair du banc --ipc
+    int peer_priority = 0;                   ///< Priorité SCHED_FIFO du pair (0 = SCHED_OTHER)
+    bool cache_sweep = false;                ///< Balayage de l'empreinte d'un agresseur de cache
+    std::vector<int> aggressor_cpus;         ///< CPUs des agresseurs (vide = CPU du rapport)
+    int aggressor_min_kb = DEFAULT_AGGRESSOR_MIN_KB;   ///< Plus petite empreinte balayée
+    int aggressor_max_kb = DEFAULT_AGGRESSOR_MAX_KB;   ///< Plus grande empreinte balayée
+    bool soak = false;                       ///< Rodage : sans limite de cycles, résumé par fenêtre
+    int soak_window_s = DEFAULT_SOAK_WINDOW_S;   ///< Durée d'une fenêtre courte (s)
+    std::string prom_path;                   ///< Fichier Prometheus du thread de rapport (vide = aucun)
+    int gpio_pin = -1;                       ///< Broche basculée à chaque cycle (-1 = aucune)
+    int gpio_input_pin = -1;                 ///< Entrée reliée à gpio_pin : aller-retour (-1 = aucune)
+    std::string gpio_chip = DEFAULT_GPIO_CHIP;   ///< Contrôleur de la broche d'entrée
+};
+
+/**
+ * @brief Résultats d'une exécution de la tâche périodique
+ * 
+ * Statistiques de la tâche (TaskStats, rt_core.h) et interférences du CPU
+ * mesuré. merge() est celui de TaskStats : les interférences, propres à un
+ * CPU, ne sont pas agrégées.
+ */
+struct TaskResults : TaskStats {
+    InterferenceStats interference;    ///< IRQs, softirqs et préemptions (mode mono-thread)
+};
+
+/**
+ * @brief Destinations des mesures de la boucle périodique
+ * 
+ * Tout est alloué AVANT la boucle temps réel ; les pointeurs optionnels
+ * valent NULL lorsque la fonctionnalité correspondante est désactivée.
+ */
+struct LoopOutputs {
+    TaskResults results;                       ///< Toujours alimentés
+    SpscRing<LatencySample>* ring = nullptr;   ///< Vers le thread de rapport
+    TraceWriter* trace = nullptr;              ///< Trace binaire (mmap)
+    FtraceSnapshot* ftrace = nullptr;          ///< Trace kernel figée au premier pic (--break-on)
+    const std::atomic<bool>* stop = nullptr;   ///< Arrêt demandé par signal (--soak)
+    GpioOutput* gpio = nullptr;                ///< Broche basculée à chaque cycle (--gpio)
+};
+
+// ============================================================================
+// ARRÊT PROPRE SUR SIGNAL (--soak)
+// ============================================================================
+
+/*
+ * Un rodage de plusieurs jours s'arrête par Ctrl-C ou par systemctl stop :
+ * le gestionnaire ne fait que lever un drapeau (seule action sûre dans un
+ * gestionnaire de signal), lu par la boucle RT à chaque cycle. La mesure se
+ * termine alors normalement : résultats finaux, retour en SCHED_OTHER et
+ * munlockall() par la fin de main(). Un second signal tue le processus
+ * (SA_RESETHAND) si l'arrêt propre reste bloqué.
+ */
+std::atomic<bool> g_stop_requested{false};
+volatile sig_atomic_t g_stop_signal = 0;
+
+static_assert(std::atomic<bool>::is_always_lock_free, "drapeau utilisable dans un gestionnaire de signal");
+
+void handle_stop_signal(int signum)
+{
+    g_stop_signal = signum;
+    g_stop_requested.store(true, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Installe le gestionnaire de SIGINT et SIGTERM
+ * 
+ * @return false si sigaction() échoue
+ */
+bool install_stop_handlers()
+{
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = handle_stop_signal;
+    action.sa_flags = static_cast<int>(SA_RESETHAND);   // 0x80000000 : constante non signée
+    sigemptyset(&action.sa_mask);
+    return sigaction(SIGINT, &action, NULL) == 0 && sigaction(SIGTERM, &action, NULL) == 0;
+}
+
+// ============================================================================
+// FONCTIONS DE CONFIGURATION TEMPS RÉEL
+// ============================================================================
+
+/**
+ * @brief Estime le budget SCHED_DEADLINE à partir de la charge configurée
+ * 
+ * Exécute la charge à froid (avant mlockall et sans priorité) : le pire
+ * temps observé est pessimiste, ce qui convient pour un budget.
+ * 
+ * @param config Paramètres d'exécution (charge, deadline)
+ * @return Budget en µs, borné par la deadline effective
+ */
+int estimate_deadline_runtime_us(const RtConfig& config)
+{
+    uint64_t worst_ns = 0;
+    
+    SyntheticWorkload workload;
+    workload.init(config.workload);
+    if (workload.active()) {
+        for (int i = 0; i < DEADLINE_CALIBRATION_RUNS; ++i) {
+            struct timespec start, end;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            workload.run();
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            worst_ns = std::max(worst_ns, timespec_diff_ns(start, end));
+        }
+    }
+    
+    uint64_t runtime_us = worst_ns * 5 / 4 / 1000 + DEADLINE_RUNTIME_MARGIN_US;
+    return static_cast<int>(std::min(runtime_us, config.deadline_ns() / 1000));
+}
+
+
+// ============================================================================
+// FONCTION DE DÉMONSTRATION DE TÂCHE PÉRIODIQUE
+// ============================================================================
+
+/**
+ * @brief Boucle périodique temps réel : attente, mesure, période suivante
+ * 
+ * Cœur de la mesure, partagé par le mode mono-thread (run_periodic_task) et
+ * par les threads du mode multi-CPU (run_multi_threaded). La boucle est celle
+ * de PeriodicTask (rt_core.h) ; le travail de chaque cycle est ici la
+ * publication de l'échantillon puis la charge synthétique.
+ * 
+ * @param config Paramètres d'exécution (période, nombre d'itérations)
+ * @param next_period Instant du premier réveil (CLOCK_MONOTONIC)
+ * @param workload Charge exécutée après chaque réveil (déjà initialisée)
+ * @param out Histogrammes et destinations optionnelles des échantillons
+ */
+void periodic_loop(const RtConfig& config, struct timespec next_period,
+                   SyntheticWorkload& workload, LoopOutputs& out)
+{
+    const uint64_t break_ns = static_cast<uint64_t>(config.break_on_us) * 1000;
+    
+    // Sans charge, le temps d'exécution du cycle ne serait que celui de la publication
+    RtTaskConfig task_config = config;
+    task_config.measure_exec = workload.active();
+    
+    PeriodicTask task(task_config, [&](const LatencySample& sample) {
+        // --soak : SIGINT / SIGTERM reçu, fin de la mesure après ce réveil
+        if (out.stop != nullptr && out.stop->load(std::memory_order_relaxed)) {
+            return false;
+        }
+        
+        // --gpio : front montant au réveil, visible à l'analyseur logique (un store, pas d'appel système)
+        if (out.gpio != nullptr) {
+            out.gpio->set();
+        }
+        
+        /*
+         * Publication de l'échantillon vers le thread de rapport et la trace
+         * binaire : quelques stores en mémoire, AUCUNE E/S. Le thread RT ne
+         * touche jamais à std::cout (verrou iostream + appel système write()).
+         */
+        if (out.ring != nullptr) {
+            out.ring->try_push(sample);
+        }
+        if (out.trace != nullptr) {
+            out.trace->record(sample.timestamp_ns, sample.latency_ns);
+        }
+        
+        /*
+         * --break-on : au premier pic, marqueur dans la trace kernel puis
+         * arrêt de l'enregistrement (deux write()), et fin de la mesure comme
+         * cyclictest -b. Le tampon ftrace contient ce qui a précédé le pic.
+         */
+        if (out.ftrace != nullptr && sample.latency_ns > break_ns) {
+            out.ftrace->trigger(sample.cycle, sample.latency_ns);
+            if (out.gpio != nullptr) {
+                out.gpio->clear();   // pas de broche laissée au niveau haut
+            }
+            return false;
+        }
+        
+        // Le travail utile d'une boucle de contrôle se place ici
+        if (workload.active()) {
+            workload.run();
+        }
+        
+        // Front descendant en fin de cycle : la largeur d'impulsion est le temps d'exécution
+        if (out.gpio != nullptr) {
+            out.gpio->clear();
+        }
+        return true;
+    });
+    task.run(next_period, out.results);
+}
+
+// ============================================================================
+// THREAD DE RAPPORT NON-RT (PROGRESSION ET FICHIERS)
+// ============================================================================
+
+/**
+ * @brief Contexte du thread de rapport
+ * 
+ * Consommateur unique de la file alimentée par la boucle temps réel : il
+ * réalise tout le formatage, l'affichage de la progression et l'écriture
+ * du journal, sur un CPU de service et en SCHED_OTHER.
+ */
+struct SampleReporter {
+    SpscRing<LatencySample> ring{SAMPLE_RING_CAPACITY};
+    std::atomic<bool> stop{false};   ///< Demande d'arrêt (fin de la boucle RT)
+    int total_iterations = 0;
+    int progress_interval = 100;     ///< Affichage tous les N cycles
+    std::ofstream log;               ///< Journal texte (si ouvert)
+    RunningStats live;               ///< Statistiques en direct (côté rapport)
+    RollingWindows* short_windows = nullptr;   ///< --soak : fenêtres courtes (sinon NULL)
+    RollingWindows* long_windows = nullptr;    ///< --soak : fenêtres longues
+    uint64_t dropped_seen = 0;       ///< Pertes de la file déjà imputées aux fenêtres
+    std::string prom_path;           ///< --prom-file (vide = désactivé)
+    std::unique_ptr<LatencyHistogram> prom_latency;   ///< Latences exposées à Prometheus
+    int cpu = 0;                     ///< CPU mesuré (étiquette des métriques)
+    uint64_t prom_next_ns = 0;       ///< Prochaine réécriture du fichier
+    std::string prom_error;          ///< Premier échec d'écriture
+    pthread_t thread {};
+};
+
+/**
+ * @brief Réécrit le fichier Prometheus si l'intervalle est écoulé (ou si force)
+ */
+void write_prometheus_file(SampleReporter& reporter, bool force)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    const uint64_t now_ns = timespec_to_ns(now);
+    if (!force && now_ns < reporter.prom_next_ns) return;
+    reporter.prom_next_ns = now_ns + static_cast<uint64_t>(PROM_WRITE_INTERVAL_MS) * 1000000;
+    
+    const WindowSummary* window = nullptr;
+    if (reporter.short_windows != nullptr && reporter.short_windows->closed() > 0) {
+        window = &reporter.short_windows->last();
+    }
+    std::ostringstream metrics;
+    write_prometheus_metrics(metrics, *reporter.prom_latency, reporter.ring.dropped(), reporter.cpu, window);
+    
+    std::string error;
+    if (!replace_file(reporter.prom_path, metrics.str(), error) && reporter.prom_error.empty()) {
+        reporter.prom_error = error;
+    }
+}
+
+/**
+ * @brief Affiche la ligne compacte d'une fenêtre fermée (--soak)
+ * 
+ * Exemple : "  ▸ 01:23:00  n=60000  min 3.1  moy 7.9  p99 14.2  p99.9 21.7
+ *            max 38.4 µs  manquées 0"
+ * L'instant est celui de la fin de la fenêtre, depuis le début de la mesure.
+ * 
+ * @param window Résumé de la fenêtre
+ * @param window_ns Durée de la fenêtre
+ * @param long_window Fenêtre longue (mise en évidence)
+ */
+void print_window_line(const WindowSummary& window, uint64_t window_ns, bool long_window)
+{
+    // Fin de la fenêtre, ou dernier échantillon si la mesure s'est arrêtée avant
+    const uint64_t end_ns = std::min((window.index + 1) * window_ns, window.end_ns + 999999999);
+    const uint64_t end_s = end_ns / 1000000000;
+    std::ostringstream elapsed;
+    elapsed << std::setfill('0') << std::setw(2) << end_s / 3600 << ':'
+            << std::setw(2) << end_s / 60 % 60 << ':' << std::setw(2) << end_s % 60;
+    
+    const bool alert = window.deadline_misses > 0 || window.dropped > 0;
+    const char* color = long_window ? COLOR_CYAN : (alert ? COLOR_YELLOW : "");
+    std::cout << color << (long_window ? "  ■ " : "  ▸ ") << elapsed.str()
+              << std::fixed << std::setprecision(1)
+              << "  n=" << window.count
+              << "  min " << static_cast<double>(window.min_ns) / 1000.0
+              << "  moy " << window.mean_ns / 1000.0
+              << "  p99 " << static_cast<double>(window.p99_ns) / 1000.0
+              << "  p99.9 " << static_cast<double>(window.p999_ns) / 1000.0
+              << "  max " << static_cast<double>(window.max_ns) / 1000.0 << " µs"
+              << "  manquées " << window.deadline_misses;
+    if (window.dropped > 0) {
+        std::cout << "  perdus " << window.dropped;
+    }
+    std::cout << (color[0] != '\0' ? COLOR_RESET : "") << std::endl;
+}
+
+/**
+ * @brief Impute l'échantillon à ses fenêtres et affiche celles qui se ferment
+ */
+void report_window_sample(SampleReporter& reporter, const LatencySample& sample)
+{
+    // Échantillons perdus par la file depuis le précédent : fenêtre courante
+    const uint64_t dropped = reporter.ring.dropped();
+    if (dropped != reporter.dropped_seen) {
+        reporter.short_windows->add_dropped(dropped - reporter.dropped_seen);
+        reporter.long_windows->add_dropped(dropped - reporter.dropped_seen);
+        reporter.dropped_seen = dropped;
+    }
+    
+    if (reporter.short_windows->record(sample.timestamp_ns, sample.latency_ns)) {
+        print_window_line(reporter.short_windows->last(), reporter.short_windows->window_ns(), false);
+    }
+    if (reporter.long_windows->record(sample.timestamp_ns, sample.latency_ns)) {
+        print_window_line(reporter.long_windows->last(), reporter.long_windows->window_ns(), true);
+    }
+}
+
+/**
+ * @brief Traite un échantillon : progression et journal
+ */
+void report_sample(SampleReporter& reporter, const LatencySample& sample)
+{
+    reporter.live.add(sample.latency_ns);
+    if (reporter.prom_latency) {
+        reporter.prom_latency->record(sample.latency_ns);
+    }
+    
+    if (reporter.log.is_open()) {
+        reporter.log << sample.cycle << ' ' << sample.timestamp_ns << ' '
+                     << sample.latency_ns << '\n';
+    }
+    
+    if (reporter.short_windows != nullptr) {
+        report_window_sample(reporter, sample);
+    } else if ((sample.cycle + 1) % static_cast<uint64_t>(reporter.progress_interval) == 0) {
+        std::cout << "  Cycle " << std::setw(4) << (sample.cycle + 1) << "/" << reporter.total_iterations 
+                  << " - Latence courante: " << std::setw(5) << (sample.latency_ns / 1000) 
+                  << " µs (moy: " << std::setw(5) << static_cast<uint64_t>(reporter.live.mean_ns()) / 1000
+                  << " µs, max: " << std::setw(5) << reporter.live.max_ns() / 1000
+                  << " µs, deadlines manquées: " << reporter.live.deadline_misses() << ")" << std::endl;
+    }
+}
+
+/**
+ * @brief Point d'entrée du thread de rapport
+ * 
+ * Vide la file par lots, puis dort 1 ms : ce thread n'est pas temps réel,
+ * seule la capacité de la file compte pour ne rien perdre.
+ */
+void* reporter_thread_main(void* arg)
+{
+    SampleReporter* reporter = static_cast<SampleReporter*>(arg);
+    LatencySample sample;
+    
+    for (;;) {
+        bool stopping = reporter->stop.load(std::memory_order_acquire);
+        
+        while (reporter->ring.try_pop(sample)) {
+            report_sample(*reporter, sample);
+        }
+        
+        if (reporter->prom_latency) {
+            write_prometheus_file(*reporter, false);
+        }
+        
+        // Arrêt seulement après avoir vidé la file une dernière fois
+        if (stopping) break;
+        
+        struct timespec pause = {0, 1000000};  // 1 ms
+        nanosleep(&pause, NULL);
+    }
+    
+    // --soak : fenêtres en cours fermées avec ce qu'elles ont reçu
+    if (reporter->short_windows != nullptr) {
+        if (reporter->short_windows->flush()) {
+            print_window_line(reporter->short_windows->last(), reporter->short_windows->window_ns(), false);
+        }
+        if (reporter->long_windows->flush()) {
+            print_window_line(reporter->long_windows->last(), reporter->long_windows->window_ns(), true);
+        }
+    }
+    
+    if (reporter->prom_latency) {
+        write_prometheus_file(*reporter, true);
+    }
+    if (reporter->log.is_open()) {
+        reporter->log.flush();
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Démarre le thread de rapport sur un CPU de service
+ * 
+ * @param reporter Contexte (doit rester valide jusqu'à stop_reporter())
+ * @param config Paramètres d'exécution (CPU de service, journal)
+ * @return true si le thread a démarré
+ */
+bool start_reporter(SampleReporter& reporter, const RtConfig& config)
+{
+    reporter.total_iterations = config.num_iterations;
+    reporter.live.set_deadline_ns(config.deadline_ns());
+    reporter.progress_interval = std::max(1, config.num_iterations / 10);
+    reporter.cpu = config.cpu;
+    if (!config.prom_path.empty()) {
+        reporter.prom_path = config.prom_path;
+        reporter.prom_latency.reset(new LatencyHistogram(config.deadline_ns()));
+    }
+    
+    if (!config.log_path.empty()) {
+        reporter.log.open(config.log_path);
+        if (!reporter.log) {
+            std::cerr << COLOR_RED << "  ✗ Impossible d'ouvrir " << config.log_path
+                      << COLOR_RESET << std::endl;
+            return false;
+        }
+        // Configuration système en commentaire : le journal se suffit à lui-même
+        std::istringstream snapshot(config.system_snapshot);
+        std::string line;
+        while (std::getline(snapshot, line)) {
+            reporter.log << "# " << line << "\n";
+        }
+        reporter.log << "# cycle timestamp_ns latency_ns\n";
+    }
+    
+    /*
+     * Le thread appelant est déjà SCHED_FIFO : sans PTHREAD_EXPLICIT_SCHED,
+     * le thread de rapport hériterait de sa priorité temps réel et de son
+     * affinité sur le CPU isolé. On force SCHED_OTHER sur un CPU de service.
+     */
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, SCHED_OTHER);
+    
+    struct sched_param param;
+    param.sched_priority = 0;
+    pthread_attr_setschedparam(&attr, &param);
+    
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<size_t>(config.report_cpu), &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+    
+    int err = pthread_create(&reporter.thread, &attr, reporter_thread_main, &reporter);
+    pthread_attr_destroy(&attr);
+    
+    if (err != 0) {
+        std::cerr << COLOR_RED << "  ✗ Création du thread de rapport impossible : "
+                  << strerror(err) << COLOR_RESET << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Arrête le thread de rapport après avoir vidé la file
+ */
+void stop_reporter(SampleReporter& reporter)
+{
+    reporter.stop.store(true, std::memory_order_release);
+    pthread_join(reporter.thread, NULL);
+    
+    if (reporter.ring.dropped() > 0) {
+        std::cout << COLOR_YELLOW << "  ⚠ " << reporter.ring.dropped()
+                  << " échantillon(s) non rapporté(s) (file pleine)" << COLOR_RESET << std::endl;
+    }
+    if (!reporter.prom_error.empty()) {
+        std::cout << COLOR_YELLOW << "  ⚠ Fichier Prometheus : " << reporter.prom_error
+                  << COLOR_RESET << std::endl;
+    } else if (!reporter.prom_path.empty()) {
+        std::cout << "  • Métriques Prometheus : " << reporter.prom_path << std::endl;
+    }
+}
+
+// ============================================================================
+// TRACE BINAIRE DES ÉCHANTILLONS (--trace / --analyze)
+// ============================================================================
+
+/**
+ * @brief Ouvre la trace binaire si un chemin est configuré
+ * 
+ * Le fichier est dimensionné pour config.num_iterations enregistrements,
+ * projeté en mémoire, pré-chargé et verrouillé AVANT la boucle RT.
+ * 
+ * @param trace Écrivain à ouvrir
+ * @param path Chemin du fichier (vide = pas de trace)
+ * @param config Paramètres d'exécution recopiés dans l'en-tête
+ * @param start Premier réveil prévu
+ * @return true si la trace est active
+ */
+bool open_trace(TraceWriter& trace, const std::string& path,
+                const RtConfig& config, const struct timespec& start)
+{
+    if (path.empty()) {
+        return false;
+    }
+    
+    TraceFileHeader header {};
+    header.period_us = static_cast<uint32_t>(config.period_us);
+    header.cpu = config.cpu;
+    header.priority = config.priority;
+    header.start_ns = timespec_to_ns(start);
+    
+    if (!trace.open(path, static_cast<uint64_t>(config.num_iterations), header, config.system_snapshot)) {
+        std::cerr << COLOR_YELLOW << "  ⚠ Trace " << path << " désactivée : "
+                  << trace.error() << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    std::cout << "  • Trace binaire : " << path << std::endl;
+    return true;
+}
+
+/**
+ * @brief Ferme la trace binaire (après la boucle RT)
+ */
+void close_trace(TraceWriter& trace)
+{
+    if (trace.is_open()) {
+        uint64_t count = trace.count();
+        trace.close();
+        std::cout << "  • " << count << " enregistrement(s) écrit(s) dans la trace" << std::endl;
+    }
+}
+
+// ============================================================================
+// CHARGE DE FOND (--stress)
+// ============================================================================
+
+/**
+ * @brief Démarre les threads de charge et attend la montée en charge
+ * 
+ * @param stress Générateur à démarrer
+ * @param config Paramètres d'exécution (CPUs de charge, CPUs mesurés)
+ * @return true si la charge est active
+ */
+bool start_stress(StressGenerator& stress, const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_YELLOW 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║              CHARGE DE FOND (--stress)                       ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    /*
+     * Sur chaque CPU de service : un thread memcpy (cache L2 et bus mémoire),
+     * un thread syscall (entrées dans le kernel) et un thread io (carte SD).
+     * Tous sont SCHED_OTHER : ils ne préemptent jamais la tâche temps réel,
+     * mais perturbent tout ce qu'elle partage avec eux.
+     */
+    if (!stress.start(config.stress_cpus, config.stress_dir)) {
+        std::cerr << COLOR_RED << "  ✗ Démarrage de la charge impossible : "
+                  << stress.error() << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    const std::vector<int>& measured = config.cpus.empty() ? std::vector<int>{config.cpu} : config.cpus;
+    for (int cpu : config.stress_cpus) {
+        std::cout << "  • CPU " << cpu << " : memcpy (" << STRESS_MEMCPY_BYTES / (1024 * 1024)
+                  << " Mo), syscall, io (" << config.stress_dir << ")";
+        if (std::find(measured.begin(), measured.end(), cpu) != measured.end()) {
+            std::cout << "  " << COLOR_YELLOW << "⚠ CPU également mesuré" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+    
+    std::cout << "  • " << stress.running_threads() << " thread(s) SCHED_OTHER, montée en charge ("
+              << STRESS_WARMUP_MS << " ms)..." << std::endl;
+    struct timespec warmup = {0, static_cast<long>(STRESS_WARMUP_MS) * 1000000};
+    nanosleep(&warmup, NULL);
+    return true;
+}
+
+/**
+ * @brief Arrête la charge de fond et affiche le travail réalisé
+ */
+void stop_stress(StressGenerator& stress)
+{
+    if (stress.running_threads() == 0) {
+        return;
+    }
+    stress.stop();
+    
+    std::cout << "\nCharge de fond réalisée :" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const StressGenerator::Summary& summary : stress.summaries()) {
+        std::cout << "  • CPU " << summary.cpu << " " << std::setw(8) << stress_kind_name(summary.kind) << " : ";
+        if (summary.kind == StressKind::SYSCALL) {
+            std::cout << summary.ops << " appels système" << std::endl;
+        } else {
+            std::cout << static_cast<double>(summary.ops) / (1024.0 * 1024.0)
+                      << (summary.kind == StressKind::MEMCPY ? " Mo copiés" : " Mo écrits") << std::endl;
+        }
+    }
+}
+
+/**
+ * @brief Recopie la trace kernel après un pic et restaure ftrace (--break-on)
+ * 
+ * @param ftrace Instantané armé par run_periodic_task (ou inactif)
+ * @param config Fichier de destination
+ */
+void report_break(FtraceSnapshot& ftrace, const RtConfig& config)
+{
+    if (!ftrace.armed()) return;
+    
+    if (ftrace.triggered()) {
+        std::cout << "\n" << COLOR_RED << "⚡ Seuil de " << config.break_on_us
+                  << " µs franchi au cycle " << ftrace.trigger_cycle() << " (latence "
+                  << static_cast<double>(ftrace.trigger_latency_ns()) / 1000.0 << " µs) : mesure arrêtée"
+                  << COLOR_RESET << std::endl;
+        if (ftrace.dump(config.break_file)) {
+            std::cout << "  ✓ Trace kernel : " << config.break_file
+                      << " (chercher \"rt_tuto: latence\" et remonter)" << std::endl;
+        } else {
+            std::cerr << COLOR_YELLOW << "  ⚠ Trace kernel non écrite : " << ftrace.error()
+                      << COLOR_RESET << std::endl;
+        }
+    } else {
+        std::cout << "\n  ✓ Aucun pic au-dessus de " << config.break_on_us
+                  << " µs : pas de trace kernel" << std::endl;
+    }
+    ftrace.disarm();
+}
+
+/**
+ * @brief Bilan du rodage : fenêtres longues conservées et pire fenêtre courte
+ * 
+ * @param short_windows Fenêtres courtes (fermées par le thread de rapport)
+ * @param long_windows Fenêtres longues
+ * @param results Mesure globale du thread RT (exacte, même si la file a perdu
+ *                des échantillons)
+ */
+void print_soak_summary(const RollingWindows& short_windows, const RollingWindows& long_windows,
+                        const TaskResults& results)
+{
+    std::cout << "\n" << COLOR_BLUE << "Bilan du rodage" << COLOR_RESET;
+    if (g_stop_signal != 0) {
+        std::cout << " (arrêt demandé par " << (g_stop_signal == SIGINT ? "SIGINT" : "SIGTERM")
+                  << " après " << results.histogram.count() << " cycles)";
+    }
+    std::cout << " :" << std::endl;
+    
+    if (long_windows.size() > 0) {
+        std::cout << "  Fenêtres de " << long_windows.window_ns() / 1000000000 << " s (les "
+                  << long_windows.size() << " dernières) :" << std::endl;
+        for (size_t k = 0; k < long_windows.size(); ++k) {
+            print_window_line(long_windows.at(k), long_windows.window_ns(), true);
+        }
+    }
+    if (short_windows.closed() > 0) {
+        std::cout << "  Pire fenêtre de " << short_windows.window_ns() / 1000000000 << " s sur "
+                  << short_windows.closed() << " :" << std::endl;
+        print_window_line(short_windows.worst(), short_windows.window_ns(), false);
+    }
+    std::cout << "  Pire latence globale : " << std::fixed << std::setprecision(1)
+              << static_cast<double>(results.histogram.max_ns()) / 1000.0 << " µs sur "
+              << results.histogram.count() << " cycles" << std::endl;
+}
+
+/**
+ * @brief Exécute une tâche périodique temps réel et mesure les latences
+ * 
+ * Cette fonction démontre comment implémenter une boucle périodique temps réel
+ * avec mesure de latence. C'est le modèle de base pour toute application RT.
+ * 
+ * @param config Paramètres d'exécution (période, nombre d'itérations)
+ * @return Histogramme des latences (taille mémoire constante) et dépassements
+ */
+TaskResults run_periodic_task(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║              EXÉCUTION TÂCHE PÉRIODIQUE                      ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    std::cout << "Paramètres :" << std::endl;
+    std::cout << "  • Période     : " << config.period_us << " µs" << std::endl;
+    if (config.num_iterations > 0) {
+        std::cout << "  • Itérations  : " << config.num_iterations << std::endl;
+    } else {
+        std::cout << "  • Itérations  : sans limite (arrêt par Ctrl-C ou SIGTERM)" << std::endl;
+    }
+    std::cout << "  • Politique   : " << policy_name(sched_getscheduler(0)) << std::endl;
+    std::cout << "  • Réveil      : " << timer_backend_name(config.timer) << std::endl;
+    std::cout << "  • Horodatage  : " << config.clock.describe() << std::endl;
+    if (config.num_iterations > 0) {
+        std::cout << "  • Durée totale: ~"
+                  << (static_cast<uint64_t>(config.period_us) * static_cast<uint64_t>(config.num_iterations) / 1000000)
+                  << " seconde(s)" << std::endl;
+    }
+    std::cout << std::endl;
+    
+    // Histogrammes pré-alloués (taille fixe) : aucune allocation pendant la
+    // boucle, quelle que soit la durée du test. Le temps d'exécution de la
+    // charge est comparé à la période (budget du cycle).
+    LoopOutputs out;
+    out.results.histogram.set_deadline_ns(config.deadline_ns());
+    out.results.exec_histogram.set_deadline_ns(static_cast<uint64_t>(config.period_us) * 1000);
+    
+    // Données de la charge allouées et écrites ici, après mlockall()
+    SyntheticWorkload workload;
+    workload.init(config.workload);
+    if (workload.active()) {
+        std::cout << "  • Charge par cycle : " << workload.describe() << "\n" << std::endl;
+    }
+    
+    // Thread de rapport non-RT : l'affichage se fait hors de la boucle RT
+    // (alloué sur le tas : la file occupe ~384 Ko)
+    auto reporter = std::make_unique<SampleReporter>();
+    
+    // --soak : fenêtres glissantes tenues par le thread de rapport (mémoire constante)
+    std::unique_ptr<RollingWindows> short_windows;
+    std::unique_ptr<RollingWindows> long_windows;
+    if (config.soak) {
+        const uint64_t window_ns = static_cast<uint64_t>(config.soak_window_s) * 1000000000;
+        short_windows.reset(new RollingWindows(window_ns, SOAK_SHORT_WINDOWS, config.deadline_ns()));
+        long_windows.reset(new RollingWindows(window_ns * SOAK_LONG_WINDOW_FACTOR, SOAK_LONG_WINDOWS,
+                                              config.deadline_ns()));
+        reporter->short_windows = short_windows.get();
+        reporter->long_windows = long_windows.get();
+        out.stop = &g_stop_requested;
+    }
+    
+    bool reporting = start_reporter(*reporter, config);
+    if (!reporting) {
+        std::cerr << COLOR_YELLOW << "  ⚠ Pas de progression en direct" << COLOR_RESET << std::endl;
+    }
+    
+    // ========================================================================
+    // INITIALISATION DE L'HORLOGE
+    // ========================================================================
+    
+    /*
+     * struct timespec : Structure POSIX pour représenter un instant
+     *   tv_sec  : secondes
+     *   tv_nsec : nanosecondes (0 à 999,999,999)
+     * 
+     * CLOCK_MONOTONIC :
+     *   - Horloge monotone croissante
+     *   - NON affectée par NTP ou changements d'heure
+     *   - Idéale pour mesurer des intervalles
+     * 
+     * Alternative CLOCK_REALTIME :
+     *   - Temps réel (wall clock)
+     *   - PEUT sauter (NTP, ajustements)
+     *   - À ÉVITER pour les mesures de latence
+     */
+    struct timespec next_period;
+    clock_gettime(CLOCK_MONOTONIC, &next_period);
+    
+    // Trace binaire optionnelle : fichier pré-chargé et verrouillé en RAM
+    TraceWriter trace;
+    if (open_trace(trace, config.trace_path, config, next_period)) {
+        out.trace = &trace;
+    }
+    
+    // Trace kernel armée avant la boucle, figée au premier pic (--break-on)
+    FtraceSnapshot ftrace;
+    if (config.break_on_us > 0) {
+        if (ftrace.arm(config.cpu, config.break_events)) {
+            out.ftrace = &ftrace;
+            std::cout << "  • Trace kernel armée sur CPU " << config.cpu << " (seuil "
+                      << config.break_on_us << " µs)\n" << std::endl;
+        } else {
+            std::cerr << COLOR_YELLOW << "  ⚠ --break-on ignoré : " << ftrace.error()
+                      << COLOR_RESET << std::endl;
+        }
+    }
+    
+    // Broche de sortie projetée avant la boucle (--gpio)
+    GpioOutput gpio;
+    if (config.gpio_pin >= 0) {
+        if (gpio.open(config.gpio_pin)) {
+            out.gpio = &gpio;
+            std::cout << "  • GPIO " << config.gpio_pin << " : haut au réveil, bas en fin de cycle ("
+                      << GPIO_MEM_DEVICE << ")\n" << std::endl;
+        } else {
+            std::cerr << COLOR_YELLOW << "  ⚠ --gpio ignoré : " << gpio.error()
+                      << COLOR_RESET << std::endl;
+        }
+    }
+    
+    std::cout << "Démarrage de la boucle périodique..." << std::endl;
+    if (config.soak) {
+        std::cout << "(Une ligne par fenêtre de " << config.soak_window_s << " s, ■ toutes les "
+                  << SOAK_LONG_WINDOW_FACTOR << " fenêtres, par le thread de rapport, CPU "
+                  << config.report_cpu << ")\n" << std::endl;
+    } else {
+        std::cout << "(Affichage tous les " << reporter->progress_interval
+                  << " cycles par le thread de rapport, CPU " << config.report_cpu << ")\n" << std::endl;
+    }
+    
+    // ========================================================================
+    // BOUCLE PÉRIODIQUE TEMPS RÉEL
+    // ========================================================================
+    
+    out.ring = reporting ? &reporter->ring : nullptr;
+    
+    // Compteurs d'interférence relevés juste avant et juste après la boucle
+    InterferenceSample interference_start = sample_interference(config.cpu);
+    periodic_loop(config, next_period, workload, out);
+    out.results.interference = diff_interference(config.cpu, interference_start,
+                                                 sample_interference(config.cpu));
+    
+    if (reporting) {
+        stop_reporter(*reporter);
+    }
+    close_trace(trace);
+    gpio.close();
+    report_break(ftrace, config);
+    if (config.soak) {
+        print_soak_summary(*short_windows, *long_windows, out.results);
+    }
+    
+    std::cout << "\n" << COLOR_GREEN << "✓ Tâche périodique terminée" << COLOR_RESET << std::endl;
+    
+    return std::move(out.results);
+}
+
+// ============================================================================
+// MODE COMPARAISON : SANS RT PUIS AVEC RT (--compare)
+// ============================================================================
+
+/**
+ * @brief Exécute la même tâche périodique sans puis avec la configuration RT
+ * 
+ * Phase 1 : le processus tel qu'il a été lancé - SCHED_OTHER, aucun affinage,
+ *           mémoire non verrouillée.
+ * Phase 2 : configure_realtime() (mlockall + SCHED_FIFO + affinage) puis la
+ *           même boucle, avec les mêmes paramètres et la même charge.
+ * 
+ * Les deux phases s'enchaînent dans le même processus et sous la même
+ * charge de fond : seule la configuration temps réel change.
+ * 
+ * @param config Paramètres d'exécution communs aux deux phases
+ * @param no_rt Résultats de la phase sans RT
+ * @param rt Résultats de la phase avec RT
+ * @return true si les deux phases ont été exécutées
+ */
+bool run_comparison(const RtConfig& config, TaskResults& no_rt, TaskResults& rt)
+{
+    std::cout << "\n" << COLOR_YELLOW << "▶ Phase 1/2 : sans temps réel "
+              << "(SCHED_OTHER, sans affinage, sans mlockall)" << COLOR_RESET << std::endl;
+    
+    // Fichiers distincts pour la phase sans RT : <fichier>.nort
+    RtConfig no_rt_config = config;
+    if (!config.log_path.empty()) no_rt_config.log_path += ".nort";
+    if (!config.trace_path.empty()) no_rt_config.trace_path += ".nort";
+    no_rt = run_periodic_task(no_rt_config);
+    
+    std::cout << "\n" << COLOR_YELLOW << "▶ Phase 2/2 : avec temps réel "
+              << "(SCHED_FIFO, CPU " << config.cpu << ", mlockall)" << COLOR_RESET << std::endl;
+    
+    if (!configure_realtime(config)) {
+        return false;
+    }
+    rt = run_periodic_task(config);
+    return true;
+}
+
+// ============================================================================
+// PASSES DE MESURE SILENCIEUSES (BALAYAGES ET COMPARATIFS)
+// ============================================================================
+
+/**
+ * @brief Exécute la boucle périodique sans affichage ni fichier
+ * 
+ * Brique commune des modes qui enchaînent plusieurs mesures (--sweep,
+ * --timer all) : pas de thread de rapport, pas de trace, seulement les
+ * histogrammes et les compteurs.
+ * 
+ * @param config Paramètres de la passe
+ * @param workload Charge déjà initialisée
+ * @return Résultats de la passe
+ */
+TaskResults run_quiet_pass(const RtConfig& config, SyntheticWorkload& workload)
+{
+    LoopOutputs out;
+    out.results.histogram.set_deadline_ns(config.deadline_ns());
+    out.results.exec_histogram.set_deadline_ns(static_cast<uint64_t>(config.period_us) * 1000);
+    
+    struct timespec next_period;
+    clock_gettime(CLOCK_MONOTONIC, &next_period);
+    timespec_add_us(next_period, static_cast<uint64_t>(config.period_us));
+    periodic_loop(config, next_period, workload, out);
+    return std::move(out.results);
+}
+
+// ============================================================================
+// MODE COMPARATIF DES MÉCANISMES DE RÉVEIL (--timer all)
+// ============================================================================
+
+/**
+ * @brief Mesure chaque mécanisme de réveil puis affiche le comparatif
+ * 
+ * Appelée après configure_realtime() : tous les mécanismes sont mesurés
+ * sur le même CPU, avec la même politique et la même charge, l'un après
+ * l'autre (config.num_iterations cycles chacun).
+ * 
+ * @param config Paramètres d'exécution communs
+ */
+void run_timer_comparison(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           COMPARATIF DES MÉCANISMES DE RÉVEIL                ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    SyntheticWorkload workload;
+    workload.init(config.workload);
+    
+    std::vector<TaskResults> results;
+    for (TimerBackend backend : ALL_TIMER_BACKENDS) {
+        std::cout << "  • " << timer_backend_name(backend) << "..." << std::endl;
+        RtConfig pass = config;
+        pass.timer = backend;
+        results.push_back(run_quiet_pass(pass, workload));
+    }
+    
+    // Le plus faible p99.9 désigne le chemin de réveil le plus régulier
+    size_t best = 0;
+    std::vector<LatencyPercentiles> pct;
+    for (size_t i = 0; i < results.size(); ++i) {
+        pct.push_back(calculate_percentiles(results[i].histogram));
+        if (pct[i].p999_ns < pct[best].p999_ns) best = i;
+    }
+    
+    std::cout << "\n  Mécanisme │      Min      Moy      p99    p99.9      Max  Dépass." << std::endl;
+    std::cout << "  ──────────┼──────────────────────────────────────────────────────" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (size_t i = 0; i < results.size(); ++i) {
+        const LatencyHistogram& histogram = results[i].histogram;
+        std::cout << "  " << std::left << std::setw(9) << timer_backend_name(ALL_TIMER_BACKENDS[i])
+                  << std::right << " │ "
+                  << std::setw(8) << static_cast<double>(histogram.min_ns()) / 1000.0
+                  << std::setw(9) << histogram.stats().mean_ns() / 1000.0
+                  << std::setw(9) << static_cast<double>(pct[i].p99_ns) / 1000.0
+                  << std::setw(9) << static_cast<double>(pct[i].p999_ns) / 1000.0
+                  << std::setw(9) << static_cast<double>(histogram.max_ns()) / 1000.0
+                  << std::setw(9) << results[i].overruns.overruns();
+        if (i == best) {
+            std::cout << "  " << COLOR_GREEN << "← plus faible gigue" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << "  (latences en µs, " << config.num_iterations << " cycles par mécanisme, hybrid : "
+              << config.spin_us << " µs d'attente active)" << std::endl;
+    std::cout << "\n  Les mécanismes à attente active (hybrid, busy) occupent le CPU : à réserver" << std::endl;
+    std::cout << "  à un CPU isolé." << std::endl;
+}
+
+// ============================================================================
+// MODE EXÉCUTIF MULTI-CADENCES (--task)
+// ============================================================================
+
+/**
+ * @brief Travail d'une tâche de l'exécutif : une charge synthétique
+ * 
+ * Foncteur concret (et non std::function) : l'appel reste direct dans la
+ * boucle de l'exécutif.
+ */
+struct WorkloadJob {
+    SyntheticWorkload* workload = nullptr;
+    
+    void operator()() const
+    {
+        workload->run();
+    }
+};
+
+/**
+ * @brief Exécute les tâches --task sur un seul thread et affiche leur bilan
+ * 
+ * Appelée après configure_realtime() : un seul thread SCHED_FIFO, une seule
+ * ligne de temps (la trame de base, plus petite période), les tâches
+ * libérées à chaque trame exécutées dans l'ordre rate-monotonic.
+ * 
+ * @param config Paramètres validés (config.period_us = trame de base)
+ * @return false si les périodes ne sont pas harmoniques
+ */
+bool run_executive(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           EXÉCUTIF CYCLIQUE MULTI-CADENCES                   ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // Données des charges allouées et pré-chargées avant la boucle
+    std::vector<SyntheticWorkload> workloads(config.tasks.size());
+    CyclicExecutive<WorkloadJob> executive(config);
+    for (size_t k = 0; k < config.tasks.size(); ++k) {
+        workloads[k].init(config.tasks[k].workload);
+        std::string name = std::to_string(1000000 / config.tasks[k].period_us) + " Hz "
+                         + workload_name(config.tasks[k].workload.type);
+        executive.add_task(name, config.tasks[k].period_us, WorkloadJob{&workloads[k]});
+    }
+    
+    std::string error;
+    if (!executive.prepare(error)) {
+        std::cerr << COLOR_RED << "  ✗ " << error << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    std::cout << "  • Trame de base   : " << executive.frame_us() << " µs" << std::endl;
+    std::cout << "  • Hyperpériode    : " << executive.hyperperiod_us() << " µs" << std::endl;
+    std::cout << "  • Trames mesurées : " << config.num_iterations << std::endl;
+    std::cout << "  • Tâches (ordre rate-monotonic) :" << std::endl;
+    for (size_t k = 0; k < executive.task_count(); ++k) {
+        const ExecutiveTaskStats& task = executive.task_stats(k);
+        std::cout << "      " << k + 1 << ". " << std::left << std::setw(16) << task.name << std::right
+                  << " période " << task.period_us << " µs (1 trame sur " << task.divider << ")" << std::endl;
+    }
+    std::cout << std::endl;
+    
+    TaskStats frames = executive.make_frame_stats();
+    struct timespec first_wake;
+    clock_gettime(CLOCK_MONOTONIC, &first_wake);
+    timespec_add_us(first_wake, static_cast<uint64_t>(config.period_us));
+    executive.run(first_wake, frames);
+    
+    // Bilan par tâche : exécution, gigue de démarrage, dépassements
+    std::cout << "  Tâche            │  Exéc moy  Exéc max   Gigue p99  Gigue max  Dépass.  Perdues" << std::endl;
+    std::cout << "  ─────────────────┼────────────────────────────────────────────────────────────" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    bool late = false;
+    for (size_t k = 0; k < executive.task_count(); ++k) {
+        const ExecutiveTaskStats& task = executive.task_stats(k);
+        LatencyPercentiles jitter = calculate_percentiles(task.jitter_histogram);
+        std::cout << "  " << std::left << std::setw(16) << task.name << std::right << " │ "
+                  << std::setw(9) << task.exec_histogram.stats().mean_ns() / 1000.0
+                  << std::setw(10) << static_cast<double>(task.exec_histogram.max_ns()) / 1000.0
+                  << std::setw(12) << static_cast<double>(jitter.p99_ns) / 1000.0
+                  << std::setw(11) << static_cast<double>(task.jitter_histogram.max_ns()) / 1000.0
+                  << std::setw(9) << task.overruns.overruns()
+                  << std::setw(9) << task.lost_releases << std::endl;
+        late = late || task.overruns.overruns() > 0 || task.lost_releases > 0;
+    }
+    std::cout << "  (durées en µs ; gigue = démarrage - libération, échéance = libération suivante)"
+              << std::endl;
+    
+    // Trame : réveil du thread et occupation (somme des tâches de la trame)
+    LatencyPercentiles wake = calculate_percentiles(frames.histogram);
+    double busy_pct = 100.0 * static_cast<double>(frames.exec_histogram.max_ns())
+                    / static_cast<double>(static_cast<uint64_t>(config.period_us) * 1000);
+    std::cout << "\nTrame de base :" << std::endl;
+    std::cout << "  • Réveil          : p99 " << static_cast<double>(wake.p99_ns) / 1000.0
+              << " µs, max " << static_cast<double>(frames.histogram.max_ns()) / 1000.0 << " µs" << std::endl;
+    std::cout << "  • Occupation max  : " << std::setprecision(2) << busy_pct << " % de la trame" << std::endl;
+    std::cout << "  • Trames en retard: " << frames.overruns.overruns()
+              << " (" << frames.overruns.missed_periods() << " trames sautées)" << std::endl;
+    std::cout << "  • Allocations     : " << frames.memory.allocations
+              << ", page faults : " << frames.memory.minor_faults + frames.memory.major_faults << std::endl;
+    
+    if (late) {
+        std::cout << "\n  " << COLOR_YELLOW << "⚠ Échéances manquées : réveil tardif de la trame (voir Réveil) ou"
+                  << "\n    travaux trop longs (sans préemption, la somme des tâches d'une trame doit"
+                  << "\n    tenir dans la trame : découper les tâches longues)."
+                  << COLOR_RESET << std::endl;
+    } else {
+        std::cout << "\n  " << COLOR_GREEN << "✓ Toutes les tâches ont respecté leur échéance" << COLOR_RESET << std::endl;
+    }
+    return true;
+}
+
+// ============================================================================
+// MODE BANC D'ESSAI DE MESSAGERIE RT → NON-RT (--ipc)
+// ============================================================================
+
+/**
+ * @brief Mesures d'une primitive de messagerie
+ */
+struct IpcResults {
+    IpcPrimitive primitive = IpcPrimitive::PI_MUTEX;
+    bool measured = false;
+    LatencyHistogram send_cost;    ///< Durée de send() côté RT
+    LatencyHistogram one_way;      ///< Envoi RT → réception par le pair
+    LatencyHistogram round_trip;   ///< Envoi RT → réponse du pair reçue
+    TaskStats rt;                  ///< Réveil et mémoire du thread RT
+};
+
+/**
+ * @brief Contexte du thread pair (récepteur non-RT)
+ */
+template <typename Channel>
+struct IpcPeer {
+    Channel* ping = nullptr;              ///< RT → pair
+    Channel* pong = nullptr;              ///< Pair → RT
+    const TimestampClock* clock = nullptr;
+    LatencyHistogram* one_way = nullptr;
+    std::atomic<bool> ready{false};
+};
+
+/**
+ * @brief Pair : reçoit l'horodatage du thread RT, mesure l'aller, renvoie
+ */
+template <typename Channel>
+void* ipc_peer_main(void* arg)
+{
+    IpcPeer<Channel>* peer = static_cast<IpcPeer<Channel>*>(arg);
+    const TimestampClock& clock = *peer->clock;
+    peer->ready.store(true, std::memory_order_release);
+    
+    for (;;) {
+        uint64_t stamp = peer->ping->receive();
+        if (stamp == IPC_STOP) break;
+        uint64_t now = clock.now();
+        peer->one_way->record(now > stamp ? clock.delta_ns(now - stamp) : 0);
+        peer->pong->send(stamp);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Mesure une primitive : ping-pong cadencé par la tâche périodique
+ * 
+ * À chaque période, le thread RT (déjà configuré) envoie son horodatage,
+ * chronomètre son send(), puis attend la réponse du pair. Le pair, sur
+ * config.peer_cpu, mesure l'aller à la réception.
+ * 
+ * @param config Paramètres validés
+ * @param out Histogrammes de la primitive
+ * @return false si le thread pair n'a pas pu être créé
+ */
+template <typename Channel>
+bool run_ipc_pass(const RtConfig& config, IpcResults& out)
+{
+    Channel ping;
+    Channel pong;
+    IpcPeer<Channel> peer;
+    peer.ping = &ping;
+    peer.pong = &pong;
+    peer.clock = &config.clock;
+    peer.one_way = &out.one_way;
+    
+    // Comme le thread de rapport : ordonnancement et CPU explicites
+    pthread_attr_t attr;
+    pthread_attr_init(&attr);
+    pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+    pthread_attr_setschedpolicy(&attr, config.peer_priority > 0 ? SCHED_FIFO : SCHED_OTHER);
+    
+    struct sched_param param;
+    param.sched_priority = config.peer_priority;
+    pthread_attr_setschedparam(&attr, &param);
+    
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(static_cast<size_t>(config.peer_cpu), &cpuset);
+    pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+    
+    pthread_t thread;
+    int err = pthread_create(&thread, &attr, ipc_peer_main<Channel>, &peer);
+    pthread_attr_destroy(&attr);
+    if (err != 0) {
+        std::cerr << COLOR_RED << "  ✗ Création du thread pair impossible : "
+                  << strerror(err) << COLOR_RESET << std::endl;
+        return false;
+    }
+    while (!peer.ready.load(std::memory_order_acquire)) {
+        struct timespec pause = {0, 1000000};
+        clock_nanosleep(CLOCK_MONOTONIC, 0, &pause, NULL);
+    }
+    
+    RtTaskConfig task_config = config;
+    task_config.measure_exec = false;
+    const TimestampClock& clock = config.clock;
+    PeriodicTask task(task_config, [&](const LatencySample&) {
+        uint64_t t0 = clock.now();
+        ping.send(t0);
+        uint64_t t1 = clock.now();
+        pong.receive();
+        uint64_t t2 = clock.now();
+        out.send_cost.record(clock.delta_ns(t1 - t0));
+        out.round_trip.record(clock.delta_ns(t2 - t0));
+    });
+    out.rt = task.make_stats();
+    struct timespec first_wake;
+    clock_gettime(CLOCK_MONOTONIC, &first_wake);
+    timespec_add_us(first_wake, static_cast<uint64_t>(config.period_us));
+    task.run(first_wake, out.rt);
+    
+    ping.send(IPC_STOP);
+    pthread_join(thread, nullptr);
+    out.measured = true;
+    return true;
+}
+
+/**
+ * @brief Compare les primitives demandées et affiche leurs histogrammes
+ * 
+ * Appelée après configure_realtime() : le thread courant est le thread RT.
+ * 
+ * @param config Paramètres validés
+ * @return false si un thread pair n'a pas pu être créé
+ */
+bool run_ipc_benchmark(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           MESSAGERIE RT → NON-RT                             ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    std::cout << "  • Thread RT : CPU " << config.cpu << ", " << policy_name(config.policy)
+              << " priorité " << config.priority << std::endl;
+    std::cout << "  • Pair      : CPU " << config.peer_cpu << ", "
+              << (config.peer_priority > 0 ? "SCHED_FIFO priorité " + std::to_string(config.peer_priority)
+                                           : std::string("SCHED_OTHER")) << std::endl;
+    std::cout << "  • Messages  : " << config.num_iterations << " allers-retours, un par période de "
+              << config.period_us << " µs\n" << std::endl;
+    
+    // Histogrammes alloués avant les passes (une par primitive)
+    std::vector<IpcResults> results(config.ipc.size());
+    for (size_t k = 0; k < config.ipc.size(); ++k) {
+        IpcResults& out = results[k];
+        out.primitive = config.ipc[k];
+        const char* name = ipc_primitive_name(out.primitive);
+        if (ipc_primitive_polls(out.primitive) && config.peer_cpu == config.cpu) {
+            std::cout << "  • " << name << " : " << COLOR_YELLOW << "ignoré (attente active : le pair doit"
+                      << " être sur un autre CPU, --peer-cpu)" << COLOR_RESET << std::endl;
+            continue;
+        }
+        std::cout << "  • " << name << "..." << std::endl;
+        
+        bool ok = true;
+        switch (out.primitive) {
+            case IpcPrimitive::FUTEX:   ok = run_ipc_pass<FutexChannel>(config, out); break;
+            case IpcPrimitive::EVENTFD: ok = run_ipc_pass<EventfdChannel>(config, out); break;
+            case IpcPrimitive::SPSC:    ok = run_ipc_pass<SpscChannel>(config, out); break;
+            case IpcPrimitive::SEQLOCK: ok = run_ipc_pass<SeqlockChannel>(config, out); break;
+            default:                    ok = run_ipc_pass<PiMutexChannel>(config, out); break;
+        }
+        if (!ok) return false;
+    }
+    
+    // Tableau : le coût côté RT (envoi) est celui qui touche la latence de la boucle
+    std::cout << "\n  Primitive │ Envoi p99   max │ Aller p50    p99     max │  A/R p50    p99     max" << std::endl;
+    std::cout << "  ──────────┼─────────────────┼──────────────────────────┼─────────────────────────" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const IpcResults& out : results) {
+        if (!out.measured) continue;
+        LatencyPercentiles send = calculate_percentiles(out.send_cost);
+        LatencyPercentiles one_way = calculate_percentiles(out.one_way);
+        LatencyPercentiles round_trip = calculate_percentiles(out.round_trip);
+        std::cout << "  " << std::left << std::setw(9) << ipc_primitive_name(out.primitive) << std::right
+                  << " │ " << std::setw(9) << static_cast<double>(send.p99_ns) / 1000.0
+                  << std::setw(6) << static_cast<double>(out.send_cost.max_ns()) / 1000.0
+                  << " │ " << std::setw(9) << static_cast<double>(one_way.p50_ns) / 1000.0
+                  << std::setw(7) << static_cast<double>(one_way.p99_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(out.one_way.max_ns()) / 1000.0
+                  << " │ " << std::setw(8) << static_cast<double>(round_trip.p50_ns) / 1000.0
+                  << std::setw(7) << static_cast<double>(round_trip.p99_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(out.round_trip.max_ns()) / 1000.0 << std::endl;
+    }
+    std::cout << "  (µs ; envoi = durée de send() dans le thread RT, aller = envoi → réception"
+              << "\n   par le pair, A/R = envoi → réponse reçue par le thread RT)" << std::endl;
+    
+    // Histogrammes de l'aller (et, pour une seule primitive, de l'envoi et de l'A/R)
+    for (const IpcResults& out : results) {
+        if (!out.measured) continue;
+        std::cout << "\n" << COLOR_CYAN << "  " << ipc_primitive_name(out.primitive)
+                  << " : latence aller (RT → pair)" << COLOR_RESET << std::endl;
+        print_histogram(out.one_way);
+        if (results.size() == 1) {
+            std::cout << "\n" << COLOR_CYAN << "  " << ipc_primitive_name(out.primitive)
+                      << " : coût de send() dans le thread RT" << COLOR_RESET << std::endl;
+            print_histogram(out.send_cost);
+            std::cout << "\n" << COLOR_CYAN << "  " << ipc_primitive_name(out.primitive)
+                      << " : aller-retour" << COLOR_RESET << std::endl;
+            print_histogram(out.round_trip);
+        }
+        if (out.rt.memory.allocations > 0 || out.rt.memory.minor_faults + out.rt.memory.major_faults > 0) {
+            std::cout << "  " << COLOR_YELLOW << "⚠ Thread RT : " << out.rt.memory.allocations
+                      << " allocations, " << out.rt.memory.minor_faults + out.rt.memory.major_faults
+                      << " page faults pendant la mesure" << COLOR_RESET << std::endl;
+        }
+    }
+    
+    std::cout << "\n  Le pi-mutex borne l'inversion de priorité, mais le thread RT peut encore attendre"
+              << "\n  la section critique du pair ; futex et eventfd coûtent un appel système quand le"
+              << "\n  pair dort ; spsc et seqlock n'en font aucun mais le pair occupe son CPU." << std::endl;
+    return true;
+}
+
+// ============================================================================
+// MODE ALLER-RETOUR GPIO (--gpio + --gpio-input)
+// ============================================================================
+
+/**
+ * @brief Histogrammes de l'aller-retour sortie → entrée
+ */
+struct GpioRoundTrip {
+    LatencyHistogram output_to_irq;   ///< Écriture GPSET0 → front horodaté par le kernel
+    LatencyHistogram irq_to_user;     ///< Front horodaté → read() rendu au thread RT
+    LatencyHistogram round_trip;      ///< Écriture GPSET0 → read() rendu
+    uint64_t missed = 0;              ///< Cycles sans front dans le délai
+    TaskStats rt;                     ///< Réveil et mémoire du thread RT
+};
+
+/// Instant CLOCK_MONOTONIC, base de temps des horodatages de fronts du kernel
+inline uint64_t gpio_monotonic_ns()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return timespec_to_ns(now);
+}
+
+/**
+ * @brief Mesure l'aller-retour sortie → interruption → espace utilisateur
+ * 
+ * La broche de sortie doit être reliée à la broche d'entrée par un fil. À
+ * chaque période, le thread RT (déjà configuré) monte la sortie, attend le
+ * front sur l'entrée, puis redescend la sortie. Les deux broches restent
+ * observables à l'analyseur logique : l'écart entre leurs fronts doit
+ * retrouver la colonne « sortie → IRQ ».
+ * 
+ * Les horodatages sont pris par CLOCK_MONOTONIC, comme ceux du kernel,
+ * quelle que soit l'option --clock.
+ * 
+ * @param config Paramètres validés
+ * @return false si une broche n'a pas pu être ouverte ou si aucun front n'arrive
+ */
+bool run_gpio_roundtrip(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           ALLER-RETOUR GPIO (SORTIE → ENTRÉE)                ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    GpioOutput output;
+    if (!output.open(config.gpio_pin)) {
+        std::cerr << COLOR_RED << "  ✗ Sortie GPIO " << config.gpio_pin << " : " << output.error()
+                  << COLOR_RESET << std::endl;
+        return false;
+    }
+    GpioEdgeInput input;
+    if (!input.open(config.gpio_chip, config.gpio_input_pin)) {
+        std::cerr << COLOR_RED << "  ✗ Entrée GPIO : " << input.error() << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    std::cout << "  • Sortie    : GPIO " << config.gpio_pin << " (" << GPIO_MEM_DEVICE
+              << ", écriture de registre)" << std::endl;
+    std::cout << "  • Entrée    : GPIO " << config.gpio_input_pin << " (" << config.gpio_chip
+              << ", fronts montants horodatés par le kernel)" << std::endl;
+    std::cout << "  • Mesures   : " << config.num_iterations << " allers-retours, un par période de "
+              << config.period_us << " µs\n" << std::endl;
+    
+    // Câblage vérifié avant la mesure : sans fil, chaque cycle attendrait en vain
+    uint64_t edge_ns = 0;
+    input.drain();
+    output.set();
+    const bool wired = input.wait(100, edge_ns);
+    output.clear();
+    if (!wired) {
+        std::cerr << COLOR_RED << "  ✗ Aucun front sur GPIO " << config.gpio_input_pin
+                  << " : relier GPIO " << config.gpio_pin << " à GPIO " << config.gpio_input_pin
+                  << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    GpioRoundTrip out;
+    const int timeout_ms = std::max(1, config.period_us / 1000);
+    RtTaskConfig task_config = config;
+    task_config.measure_exec = false;
+    PeriodicTask task(task_config, [&](const LatencySample&) {
+        input.drain();
+        uint64_t t0 = gpio_monotonic_ns();
+        output.set();
+        uint64_t edge = 0;
+        bool seen = input.wait(timeout_ms, edge);
+        uint64_t t1 = gpio_monotonic_ns();
+        output.clear();
+        if (!seen) {
+            ++out.missed;
+            return;
+        }
+        out.output_to_irq.record(edge > t0 ? edge - t0 : 0);
+        out.irq_to_user.record(t1 > edge ? t1 - edge : 0);
+        out.round_trip.record(t1 - t0);
+    });
+    out.rt = task.make_stats();
+    struct timespec first_wake;
+    clock_gettime(CLOCK_MONOTONIC, &first_wake);
+    timespec_add_us(first_wake, static_cast<uint64_t>(config.period_us));
+    task.run(first_wake, out.rt);
+    
+    if (out.round_trip.empty()) {
+        std::cerr << COLOR_RED << "  ✗ Aucun front reçu pendant la mesure" << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    std::cout << "  Étape                  │    p50     p99   p99.9     max (µs)" << std::endl;
+    std::cout << "  ───────────────────────┼────────────────────────────────────" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    const std::pair<const char*, const LatencyHistogram*> rows[] = {
+        {"Sortie → IRQ          ", &out.output_to_irq},
+        {"IRQ → espace util.    ", &out.irq_to_user},
+        {"Aller-retour          ", &out.round_trip},
+        {"Réveil du thread RT   ", &out.rt.histogram},
+    };
+    for (const auto& row : rows) {
+        LatencyPercentiles pct = calculate_percentiles(*row.second);
+        std::cout << "  " << row.first << " │ " << std::setw(6) << static_cast<double>(pct.p50_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(pct.p99_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(pct.p999_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(row.second->max_ns()) / 1000.0 << std::endl;
+    }
+    std::cout << std::setprecision(2);
+    if (out.missed > 0) {
+        std::cout << "  " << COLOR_YELLOW << "⚠ " << out.missed << " cycle(s) sans front en "
+                  << timeout_ms << " ms (fil, rebond, tirage)" << COLOR_RESET << std::endl;
+    }
+    if (out.rt.memory.allocations > 0 || out.rt.memory.minor_faults + out.rt.memory.major_faults > 0) {
+        std::cout << "  " << COLOR_YELLOW << "⚠ Thread RT : " << out.rt.memory.allocations
+                  << " allocations, " << out.rt.memory.minor_faults + out.rt.memory.major_faults
+                  << " page faults pendant la mesure" << COLOR_RESET << std::endl;
+    }
+    
+    std::cout << "\n" << COLOR_CYAN << "  Latence interruption → espace utilisateur" << COLOR_RESET << std::endl;
+    print_histogram(out.irq_to_user);
+    
+    std::cout << "\n  « Sortie → IRQ » inclut la propagation électrique et l'entrée du gestionnaire"
+              << "\n  d'interruption ; « IRQ → espace util. » le réveil du thread RT bloqué dans"
+              << "\n  poll() : c'est la latence d'un thread qui réagit à un capteur." << std::endl;
+    return true;
+}
+
+// ============================================================================
+// MODE INTERFÉRENCE DE CACHE PARTAGÉ (--cache-sweep)
+// ============================================================================
+
+/**
+ * @brief Mesure de la charge RT face à un agresseur d'une empreinte donnée
+ */
+struct CacheSweepStep {
+    size_t footprint_kb = 0;        ///< Empreinte de chaque agresseur (0 = référence sans agresseur)
+    bool closing = false;           ///< Référence re-mesurée après le balayage
+    TaskResults results;            ///< Réveil et temps d'exécution du thread RT
+    double bandwidth_mb_s = 0.0;    ///< Débit de chaque agresseur pendant la passe
+};
+
+/// Taille lisible : "512 Ko", "4 Mo"
+std::string format_kb(size_t kb)
+{
+    if (kb >= 1024 && kb % 1024 == 0) return std::to_string(kb / 1024) + " Mo";
+    return std::to_string(kb) + " Ko";
+}
+
+/**
+ * @brief Balaie l'empreinte d'un voisin bruyant et mesure le thread RT
+ * 
+ * Sur le Raspberry Pi 4, les quatre Cortex-A72 partagent un L2 de 1 Mo :
+ * un CPU parfaitement isolé (isolcpus, IRQs routées) subit encore les
+ * évictions provoquées par ses voisins. Le thread RT exécute à chaque
+ * période la même charge à ensemble de travail fixe (--workload, défaut
+ * memwalk) pendant qu'un agresseur SCHED_OTHER parcourt sur un autre CPU
+ * un tampon de taille doublée à chaque passe (32 Ko à 64 Mo par défaut).
+ * 
+ * Une passe d'échauffement, non retenue, précède la mesure : sans elle, la
+ * référence paierait seule les premiers accès au tampon de la charge
+ * (caches, TLB) et la montée en fréquence du CPU, et toutes les passes
+ * suivantes paraîtraient plus rapides qu'elle. La référence sans agresseur
+ * est mesurée avant ET après le balayage ; la plus petite des deux (p99
+ * d'exécution) est retenue. Aucun verdict n'est donné si les deux
+ * références divergent, ou si des passes avec agresseur sont nettement
+ * plus rapides que la référence (CPU RT qui s'endort quand il est seul).
+ * 
+ * L'empreinte tolérée est la plus grande qui garde le p99 d'exécution à
+ * moins de CACHE_SWEEP_TOLERANCE fois la référence ; tant que l'ensemble de
+ * travail RT + celui des voisins tient dans le L2, le thread RT garde ses
+ * lignes.
+ * 
+ * Appelée après configure_realtime() ; config.num_iterations cycles par passe.
+ * 
+ * @param config Paramètres d'exécution (charge déjà choisie)
+ * @return false si un agresseur n'a pas pu démarrer
+ */
+bool run_cache_sweep(const RtConfig& config)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║           INTERFÉRENCE DE CACHE PARTAGÉ                      ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    SyntheticWorkload workload;
+    workload.init(config.workload);
+    
+    std::cout << "  • Thread RT  : CPU " << config.cpu << ", " << workload.describe()
+              << " à chaque période de " << config.period_us << " µs" << std::endl;
+    std::cout << "  • Agresseurs : CPU";
+    bool shares_cpu = false;
+    for (int cpu : config.aggressor_cpus) {
+        std::cout << " " << cpu;
+        shares_cpu = shares_cpu || cpu == config.cpu;
+    }
+    std::cout << " (SCHED_OTHER), " << format_kb(static_cast<size_t>(config.aggressor_min_kb))
+              << " → " << format_kb(static_cast<size_t>(config.aggressor_max_kb)) << std::endl;
+    if (shares_cpu) {
+        std::cout << "  " << COLOR_YELLOW << "⚠ Un agresseur partage le CPU RT : il ne s'exécute qu'entre"
+                  << " les cycles et pollue aussi le L1 (--aggressor-cpus)" << COLOR_RESET << std::endl;
+    }
+    std::cout << std::endl;
+    
+    // Passes allouées avant la première mesure : référence puis chaque empreinte
+    std::vector<CacheSweepStep> steps(1);
+    for (size_t kb = static_cast<size_t>(config.aggressor_min_kb);
+         kb <= static_cast<size_t>(config.aggressor_max_kb); kb *= 2) {
+        steps.emplace_back();
+        steps.back().footprint_kb = kb;
+    }
+    steps.emplace_back();
+    steps.back().closing = true;
+    
+    // Échauffement : caches, TLB et fréquence dans l'état des passes suivantes
+    std::cout << "  • échauffement (non retenu)..." << std::endl;
+    run_quiet_pass(config, workload);
+    
+    CacheAggressor aggressor;
+    for (CacheSweepStep& step : steps) {
+        if (step.footprint_kb == 0) {
+            std::cout << "  • sans agresseur (référence" << (step.closing ? ", fin" : "") << ")..." << std::endl;
+            step.results = run_quiet_pass(config, workload);
+            continue;
+        }
+        std::cout << "  • " << format_kb(step.footprint_kb) << "..." << std::endl;
+        if (!aggressor.start(config.aggressor_cpus, step.footprint_kb * 1024)) {
+            std::cerr << COLOR_RED << "✗ Agresseur de cache : " << aggressor.error()
+                      << COLOR_RESET << std::endl;
+            return false;
+        }
+        struct timespec begin, end;
+        clock_gettime(CLOCK_MONOTONIC, &begin);
+        step.results = run_quiet_pass(config, workload);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        aggressor.stop();
+        
+        const double elapsed_s = static_cast<double>(end.tv_sec - begin.tv_sec)
+                               + static_cast<double>(end.tv_nsec - begin.tv_nsec) / 1e9;
+        if (elapsed_s > 0.0) {
+            step.bandwidth_mb_s = static_cast<double>(aggressor.bytes_touched())
+                                / static_cast<double>(config.aggressor_cpus.size())
+                                / elapsed_s / (1024.0 * 1024.0);
+        }
+    }
+    
+    // Tableau : le p99 d'exécution, comparé à la référence, désigne l'empreinte tolérée
+    // Référence : la plus basse des deux passes sans agresseur (début, fin)
+    const uint64_t opening_p99 = calculate_percentiles(steps.front().results.exec_histogram).p99_ns;
+    const uint64_t closing_p99 = calculate_percentiles(steps.back().results.exec_histogram).p99_ns;
+    const double reference_p99 = static_cast<double>(std::max<uint64_t>(std::min(opening_p99, closing_p99), 1));
+    size_t tolerated_kb = 0;
+    bool degraded = false;
+    double lowest_ratio = 1.0;   // < 1 / tolérance : passes avec agresseur plus rapides que la référence
+    
+    std::cout << "\n  Agresseur │ Exéc moy    p99     max │  ×p99 │ Réveil p99 │ Débit (Mo/s)" << std::endl;
+    std::cout << "  ──────────┼─────────────────────────┼───────┼────────────┼─────────────" << std::endl;
+    std::cout << std::fixed;
+    for (const CacheSweepStep& step : steps) {
+        const LatencyHistogram& exec = step.results.exec_histogram;
+        const LatencyPercentiles exec_pct = calculate_percentiles(exec);
+        const LatencyPercentiles wake_pct = calculate_percentiles(step.results.histogram);
+        const double ratio = static_cast<double>(exec_pct.p99_ns) / reference_p99;
+        const bool over = step.footprint_kb > 0 && ratio > CACHE_SWEEP_TOLERANCE;
+        if (step.footprint_kb > 0) lowest_ratio = std::min(lowest_ratio, ratio);
+        if (step.footprint_kb > 0 && !degraded) {
+            if (over) {
+                degraded = true;
+            } else {
+                tolerated_kb = step.footprint_kb;
+            }
+        }
+        
+        const std::string label = step.footprint_kb > 0 ? format_kb(step.footprint_kb)
+                                : (step.closing ? "aucun/fin" : "aucun");
+        std::cout << "  " << std::setw(9) << label
+                  << " │ " << std::setprecision(1)
+                  << std::setw(8) << exec.stats().mean_ns() / 1000.0
+                  << std::setw(7) << static_cast<double>(exec_pct.p99_ns) / 1000.0
+                  << std::setw(8) << static_cast<double>(exec.max_ns()) / 1000.0
+                  << " │ " << (over ? COLOR_YELLOW : "") << std::setprecision(2)
+                  << std::setw(5) << ratio << (over ? COLOR_RESET : "")
+                  << " │ " << std::setprecision(1)
+                  << std::setw(10) << static_cast<double>(wake_pct.p99_ns) / 1000.0
+                  << " │ " << std::setprecision(0);
+        if (step.footprint_kb == 0) {
+            std::cout << std::setw(12) << "-";
+        } else {
+            std::cout << std::setw(12) << step.bandwidth_mb_s;
+        }
+        std::cout << std::endl;
+    }
+    std::cout << std::setprecision(1);
+    std::cout << "  (µs ; " << config.num_iterations << " cycles par passe, ×p99 = p99 d'exécution /"
+              << " plus basse des références sans agresseur,\n   débit = octets parcourus par agresseur)"
+              << std::endl;
+    
+    /*
+     * Référence non représentative : les deux passes sans agresseur
+     * divergent, ou des passes AVEC agresseur sont nettement plus rapides
+     * qu'elle. Le CPU RT, seul, s'endort entre les cycles (états
+     * d'inactivité profonds, fréquence abaissée) : un voisin qui l'occupe
+     * le garde éveillé. Le rapport ×p99 ne mesure plus alors le cache.
+     */
+    const double drift = static_cast<double>(std::max(opening_p99, closing_p99)) / reference_p99;
+    const bool unreliable = drift > CACHE_SWEEP_TOLERANCE || lowest_ratio * CACHE_SWEEP_TOLERANCE < 1.0;
+    
+    std::cout << std::endl;
+    if (unreliable) {
+        std::cout << COLOR_YELLOW << "⚠ Pas de verdict : référence non représentative (début/fin ×"
+                  << std::setprecision(2) << drift << ", meilleure passe avec agresseur ×" << lowest_ratio
+                  << std::setprecision(1) << ")" << COLOR_RESET << std::endl;
+        std::cout << "  Le CPU RT change d'état entre les passes (veille profonde, fréquence) :"
+                  << "\n  gouverneur performance, cpuidle limité (cpuidle.off=1 ou /dev/cpu_dma_latency),"
+                  << " puis relancer." << std::endl;
+    } else if (!degraded) {
+        std::cout << COLOR_GREEN << "✓ Aucune dégradation de plus de "
+                  << static_cast<int>((CACHE_SWEEP_TOLERANCE - 1.0) * 100.0 + 0.5)
+                  << " % jusqu'à " << format_kb(static_cast<size_t>(config.aggressor_max_kb))
+                  << " par agresseur" << COLOR_RESET << std::endl;
+    } else if (tolerated_kb == 0) {
+        std::cout << COLOR_YELLOW << "⚠ Le p99 d'exécution se dégrade dès "
+                  << format_kb(static_cast<size_t>(config.aggressor_min_kb))
+                  << " : réduire l'ensemble de travail RT (" << workload.describe() << ")"
+                  << COLOR_RESET << std::endl;
+    } else {
+        std::cout << COLOR_YELLOW << "⚠ Empreinte tolérée : " << format_kb(tolerated_kb)
+                  << " par voisin (p99 d'exécution ≤ +"
+                  << static_cast<int>((CACHE_SWEEP_TOLERANCE - 1.0) * 100.0 + 0.5)
+                  << " %) avec " << workload.describe() << " côté RT" << COLOR_RESET << std::endl;
+    }
+    std::cout << "  Ensemble de travail RT + empreinte des voisins doit tenir dans le L2 partagé" << std::endl;
+    std::cout << "  (1 Mo sur le Raspberry Pi 4) ; au-delà, seul le partitionnement du cache protège." << std::endl;
+    return true;
+}
+
+// ============================================================================
+// MODE BALAYAGE : EFFET DE CHAQUE RÉGLAGE (--sweep)
+// ============================================================================
+
+/**
+ * @brief Une combinaison de réglages temps réel et ses résultats
+ */
+struct SweepCase {
+    bool mlock = false;          ///< mlockall(MCL_CURRENT | MCL_FUTURE)
+    int policy = SCHED_OTHER;    ///< SCHED_OTHER, SCHED_FIFO, SCHED_RR ou SCHED_DEADLINE
+    bool pin = false;            ///< Affinage sur config.cpu (jamais en SCHED_DEADLINE)
+    TaskResults results;
+};
+
+/**
+ * @brief Applique les réglages d'une combinaison au processus courant
+ * 
+ * Contrairement à configure_realtime(), chaque réglage est appliqué
+ * séparément et sans affichage : c'est ce qui permet de les isoler.
+ * SCHED_DEADLINE passe par set_deadline_scheduling() avec la réservation
+ * de config (runtime, deadline, période).
+ * 
+ * @param sweep_case Combinaison à appliquer
+ * @param config Paramètres d'exécution (priorité, CPU cible, réservation EDF)
+ * @return true si tous les réglages demandés ont été appliqués
+ */
+bool apply_sweep_case(const SweepCase& sweep_case, const RtConfig& config)
+{
+    if (sweep_case.mlock && mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << COLOR_RED << "  ✗ mlockall: " << strerror(errno) << COLOR_RESET << std::endl;
+        return false;
+    }
+    
+    if (sweep_case.policy == SCHED_DEADLINE) {
+        int err = set_deadline_scheduling(config);
+        if (err != 0) {
+            std::cerr << COLOR_RED << "  ✗ sched_setattr(SCHED_DEADLINE): " << strerror(err)
+                      << COLOR_RESET << std::endl;
+            return false;
+        }
+    } else {
+        struct sched_param param;
+        param.sched_priority = sweep_case.policy == SCHED_OTHER ? 0 : config.priority;
+        if (sched_setscheduler(0, sweep_case.policy, &param) != 0) {
+            std::cerr << COLOR_RED << "  ✗ sched_setscheduler(" << policy_name(sweep_case.policy)
+                      << "): " << strerror(errno) << COLOR_RESET << std::endl;
+            return false;
+        }
+    }
+    
+    if (sweep_case.pin) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(static_cast<size_t>(config.cpu), &cpuset);
+        if (sched_setaffinity(0, sizeof(cpu_set_t), &cpuset) != 0) {
+            std::cerr << COLOR_RED << "  ✗ sched_setaffinity: " << strerror(errno)
+                      << COLOR_RESET << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Revient à la configuration de départ (aucun réglage RT)
+ * 
+ * @param original_mask Affinité du processus au lancement
+ */
+void reset_sweep_case(const cpu_set_t& original_mask)
+{
+    struct sched_param param;
+    param.sched_priority = 0;
+    sched_setscheduler(0, SCHED_OTHER, &param);
+    sched_setaffinity(0, sizeof(cpu_set_t), &original_mask);
+    munlockall();
+}
+
+/**
+ * @brief Affiche la matrice des résultats du balayage
+ * 
+ * Puis, pour chaque réglage, son effet moyen sur le p99.9 : la moyenne des
+ * écarts entre les paires de combinaisons qui ne diffèrent que par ce
+ * réglage. Un réglage qui n'apporte plus rien sur une carte saute aux yeux.
+ */
+void print_sweep_matrix(const std::vector<SweepCase>& cases)
+{
+    std::cout << "\n" << COLOR_CYAN 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║              MATRICE DES RÉGLAGES TEMPS RÉEL                 ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    std::cout << "  mlockall  Politique       Affinage │      Max      p99    p99.9  Dépass." << std::endl;
+    std::cout << "  ───────────────────────────────────┼─────────────────────────────────────" << std::endl;
+    
+    std::cout << std::fixed << std::setprecision(1);
+    std::vector<uint64_t> p999(cases.size());
+    for (size_t i = 0; i < cases.size(); ++i) {
+        const SweepCase& c = cases[i];
+        const LatencyHistogram& histogram = c.results.histogram;
+        LatencyPercentiles pct = calculate_percentiles(histogram);
+        p999[i] = pct.p999_ns;
+        
+        std::cout << "  " << std::setw(6) << (c.mlock ? "oui" : "-") << "    "
+                  << std::left << std::setw(15) << policy_name(c.policy) << std::right
+                  << std::setw(8) << (c.pin ? "oui" : "-") << "  │ "
+                  << std::setw(8) << static_cast<double>(histogram.max_ns()) / 1000.0
+                  << std::setw(9) << static_cast<double>(pct.p99_ns) / 1000.0
+                  << std::setw(9) << static_cast<double>(pct.p999_ns) / 1000.0
+                  << std::setw(9) << c.results.overruns.overruns() << std::endl;
+    }
+    std::cout << "  (latences en µs, " << (cases.empty() ? 0 : cases[0].results.histogram.count())
+              << " cycles par combinaison)" << std::endl;
+    
+    /*
+     * Effet d'un réglage : pour chaque combinaison SANS ce réglage, on cherche
+     * la combinaison identique AVEC ce réglage et on mesure la baisse du
+     * p99.9. Seules les combinaisons SCHED_OTHER/SCHED_FIFO sont appariées
+     * pour la politique d'ordonnancement.
+     */
+    auto same_except = [&](const SweepCase& a, const SweepCase& b, int knob) {
+        return (knob == 0 || a.mlock == b.mlock)
+            && (knob == 1 || a.policy == b.policy)
+            && (knob == 2 || a.pin == b.pin);
+    };
+    const char* knob_names[] = {"mlockall          ", "SCHED_FIFO        ", "Affinage CPU      "};
+    
+    std::cout << "\nEffet moyen de chaque réglage sur le p99.9 :" << std::endl;
+    for (int knob = 0; knob < 3; ++knob) {
+        double total_us = 0.0;
+        int pairs = 0;
+        for (size_t i = 0; i < cases.size(); ++i) {
+            const SweepCase& off = cases[i];
+            bool is_off = (knob == 0 && !off.mlock) || (knob == 1 && off.policy == SCHED_OTHER)
+                       || (knob == 2 && !off.pin);
+            if (!is_off) continue;
+            for (size_t j = 0; j < cases.size(); ++j) {
+                const SweepCase& on = cases[j];
+                bool is_on = (knob == 0 && on.mlock) || (knob == 1 && on.policy == SCHED_FIFO)
+                          || (knob == 2 && on.pin);
+                if (is_on && same_except(off, on, knob)) {
+                    total_us += (static_cast<double>(p999[i]) - static_cast<double>(p999[j])) / 1000.0;
+                    pairs++;
+                }
+            }
+        }
+        if (pairs == 0) continue;
+        double gain_us = total_us / pairs;
+        std::cout << "  • " << knob_names[knob] << ": " << std::setw(8) << gain_us << " µs";
+        if (gain_us > 0.0) {
+            std::cout << "  " << COLOR_GREEN << "← Réduit la queue de latence" << COLOR_RESET;
+        } else {
+            std::cout << "  " << COLOR_YELLOW << "← Aucun gain mesurable" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+}
 
 /**
- * CPU ISOLÉ POUR L'EXÉCUTION
+ * @brief Exécute la tâche sous toutes les combinaisons de réglages
  * 
- * Le script setup_realtime_rpi.sh configure isolcpus=2,3. Ces CPUs sont
- * réservés aux tâches temps réel et ne reçoivent pas de tâches du scheduler
- * général.
+ * Les 2^3 combinaisons de mlockall, SCHED_FIFO et affinage, plus (option
+ * --sweep-rr) les quatre combinaisons SCHED_RR. Avec --policy deadline,
+ * deux combinaisons SCHED_DEADLINE (avec et sans mlockall) utilisent la
+ * réservation de config ; elles ne sont jamais affinées, le kernel refusant
+ * l'affinité d'une tâche DEADLINE sur un seul CPU. Chaque combinaison
+ * exécute config.num_iterations cycles, sans affichage ni thread de
+ * rapport, puis le processus revient à sa configuration de départ.
+ * 
+ * @param config Paramètres d'exécution communs
+ * @param include_rr Ajoute les combinaisons SCHED_RR
+ * @param cases Combinaisons exécutées et leurs résultats
+ * @return true si toutes les combinaisons ont été exécutées
  */
-constexpr int RT_CPU = 2;
+bool run_sweep(const RtConfig& config, bool include_rr, std::vector<SweepCase>& cases)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║         BALAYAGE : mlockall × POLITIQUE × AFFINAGE           ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    std::vector<int> policies = {SCHED_OTHER, SCHED_FIFO};
+    if (include_rr) {
+        policies.push_back(SCHED_RR);
+    }
+    for (int policy : policies) {
+        for (int bits = 0; bits < 4; ++bits) {
+            SweepCase c;
+            c.mlock = (bits & 2) != 0;
+            c.policy = policy;
+            c.pin = (bits & 1) != 0;
+            cases.push_back(std::move(c));
+        }
+    }
+    if (config.policy == SCHED_DEADLINE) {
+        for (bool mlock : {false, true}) {
+            SweepCase c;
+            c.mlock = mlock;
+            c.policy = SCHED_DEADLINE;
+            cases.push_back(std::move(c));
+        }
+    }
+    
+    cpu_set_t original_mask;
+    CPU_ZERO(&original_mask);
+    sched_getaffinity(0, sizeof(cpu_set_t), &original_mask);
+    
+    // Charge allouée une fois : verrouillée par mlockall dans les combinaisons concernées
+    SyntheticWorkload workload;
+    workload.init(config.workload);
+    
+    for (size_t i = 0; i < cases.size(); ++i) {
+        SweepCase& c = cases[i];
+        std::cout << "  [" << std::setw(2) << (i + 1) << "/" << cases.size() << "] mlockall "
+                  << (c.mlock ? "oui" : "non") << ", " << policy_name(c.policy)
+                  << ", affinage " << (c.pin ? "CPU " + std::to_string(config.cpu) : "non")
+                  << "..." << std::endl;
+        
+        if (!apply_sweep_case(c, config)) {
+            reset_sweep_case(original_mask);
+            return false;
+        }
+        
+        // La boucle attend par sched_yield() en SCHED_DEADLINE, par le timer sinon
+        RtConfig pass = config;
+        pass.policy = c.policy;
+        c.results = run_quiet_pass(pass, workload);
+        reset_sweep_case(original_mask);
+    }
+    return true;
+}
 
 // ============================================================================
-// FONCTIONS DE CONFIGURATION TEMPS RÉEL
+// MODE MULTI-THREADS : UN THREAD TEMPS RÉEL PAR CPU ISOLÉ
 // ============================================================================
 
 /**
- * @brief Configure le thread courant pour l'exécution temps réel
+ * @brief Barrière de démarrage commune aux threads de mesure
  * 
- * Cette fonction applique les trois configurations essentielles pour une tâche
- * temps réel sous Linux :
- * 1. Verrouillage mémoire (mlockall)
- * 2. Ordonnancement SCHED_FIFO
- * 3. Affinage CPU sur un cœur isolé
+ * Tous les threads attendent ici que le thread principal les libère, puis
+ * partagent le MÊME instant de premier réveil : leurs périodes sont alignées,
+ * ce qui fait apparaître les interférences entre cœurs (cache L2 partagé,
+ * interruptions simultanées...).
+ * 
+ * @note pthread_barrier_t ne permet pas d'annuler l'attente si la création
+ *       d'un thread échoue (EPERM sans sudo par exemple) : on utilise donc
+ *       un mutex et une variable de condition avec un drapeau d'abandon.
+ */
+struct StartBarrier {
+    pthread_mutex_t mutex = PTHREAD_MUTEX_INITIALIZER;
+    pthread_cond_t cond = PTHREAD_COND_INITIALIZER;
+    int ready = 0;                  ///< Threads arrivés à la barrière
+    bool released = false;          ///< Démarrage autorisé
+    bool aborted = false;           ///< Démarrage annulé (erreur de création)
+    struct timespec start_time {};  ///< Premier réveil commun (CLOCK_MONOTONIC)
+};
+
+/**
+ * @brief Contexte d'un thread de mesure (un par CPU)
+ */
+struct MeasurementThread {
+    RtConfig config;                ///< Configuration propre au thread (CPU)
+    StartBarrier* barrier = nullptr;
+    LoopOutputs out;                ///< Histogramme propre au thread
+    SyntheticWorkload workload;     ///< Charge propre au thread (données privées)
+    TraceWriter trace;              ///< Trace propre au thread (<fichier>.cpuN)
+    pthread_t thread {};
+};
+
+/**
+ * @brief Point d'entrée des threads de mesure
  * 
- * @return true si la configuration réussit, false sinon
+ * Ordonnancement et affinage sont déjà appliqués à la création via les
+ * attributs du thread : il ne reste qu'à attendre le signal de départ.
  */
-bool configure_realtime()
+void* measurement_thread_main(void* arg)
 {
-    std::cout << COLOR_CYAN << "\n╔══════════════════════════════════════════════════════════════╗\n"
-              << "║           CONFIGURATION TEMPS RÉEL                           ║\n"
-              << "╚══════════════════════════════════════════════════════════════╝"
-              << COLOR_RESET << "\n" << std::endl;
+    MeasurementThread* ctx = static_cast<MeasurementThread*>(arg);
+    StartBarrier* barrier = ctx->barrier;
     
-    // ========================================================================
-    // ÉTAPE 1 : VERROUILLAGE MÉMOIRE
-    // ========================================================================
+    pthread_mutex_lock(&barrier->mutex);
+    barrier->ready++;
+    pthread_cond_broadcast(&barrier->cond);
+    while (!barrier->released && !barrier->aborted) {
+        pthread_cond_wait(&barrier->cond, &barrier->mutex);
+    }
+    bool aborted = barrier->aborted;
+    struct timespec start_time = barrier->start_time;
+    pthread_mutex_unlock(&barrier->mutex);
     
-    std::cout << "1️⃣  Verrouillage mémoire avec mlockall()" << std::endl;
-    std::cout << "   ────────────────────────────────────────" << std::endl;
-    std::cout << "   Objectif : Éviter les page faults qui causent des latences" << std::endl;
-    std::cout << "              imprévisibles (plusieurs millisecondes)." << std::endl;
-    std::cout << std::endl;
+    if (!aborted) {
+        periodic_loop(ctx->config, start_time, ctx->workload, ctx->out);
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Affiche une ligne de résumé par thread (format proche de cyclictest)
+ */
+void print_thread_summary(size_t index, const MeasurementThread& ctx)
+{
+    const LatencyHistogram& histogram = ctx.out.results.histogram;
+    LatencyStats stats = calculate_stats(histogram);
     
-    /*
-     * mlockall() verrouille toutes les pages mémoire en RAM.
-     * 
-     * POURQUOI C'EST NÉCESSAIRE ?
-     * Par défaut, Linux utilise la mémoire virtuelle. Quand un programme accède
-     * à une page non chargée en RAM, un "page fault" se produit : le kernel doit
-     * charger la page depuis le disque ou la swap. Ce processus peut prendre
-     * plusieurs MILLISECONDES - catastrophique pour le temps réel.
-     * 
-     * MCL_CURRENT : Verrouille les pages actuellement mappées
-     * MCL_FUTURE : Verrouille aussi les futures allocations
-     */
+    std::cout << "  T:" << std::setw(2) << index
+              << "  CPU:" << std::setw(2) << ctx.config.cpu
+              << "  P:" << std::setw(2) << ctx.config.priority
+              << "  C:" << std::setw(8) << histogram.count()
+              << "  Min:" << std::setw(6) << stats.min_ns / 1000
+              << "  Avg:" << std::setw(6) << static_cast<uint64_t>(stats.avg_ns) / 1000
+              << "  Max:" << std::setw(6) << stats.max_ns / 1000
+              << "  P99.9:" << std::setw(6) << calculate_percentile(histogram, 99.9) / 1000
+              << " µs  Overruns:" << ctx.out.results.overruns.overruns() << std::endl;
+}
+
+/**
+ * @brief Exécute la tâche périodique simultanément sur plusieurs CPUs
+ * 
+ * Équivalent de cyclictest -t -a <cpus> : un thread SCHED_FIFO par CPU de
+ * config.cpus, chacun avec ses propres attributs (politique, priorité,
+ * affinité) et son propre histogramme. Les threads démarrent ensemble depuis
+ * une barrière commune, puis les résultats sont agrégés.
+ * 
+ * @param config Paramètres d'exécution (config.cpus non vide)
+ * @param aggregate Résultats recevant la fusion des résultats par thread
+ * @return true si tous les threads ont pu être créés et exécutés
+ */
+bool run_multi_threaded(const RtConfig& config, TaskResults& aggregate)
+{
+    std::cout << "\n" << COLOR_BLUE 
+              << "╔══════════════════════════════════════════════════════════════╗\n"
+              << "║        EXÉCUTION MULTI-THREADS (UN THREAD PAR CPU)           ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    // Le verrouillage mémoire s'applique à tout le processus, donc aussi aux
+    // piles et histogrammes des threads créés ensuite (MCL_FUTURE)
     if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
         std::cerr << COLOR_RED 
-                  << "   ✗ Erreur mlockall: " << strerror(errno) << "\n\n"
+                  << "   ✗ Erreur mlockall: " << strerror(errno) << "\n"
                   << "   Solution : Exécuter avec sudo\n"
-                  << "              sudo ./rt_tuto\n"
                   << COLOR_RESET << std::endl;
         return false;
     }
-    std::cout << "   " << COLOR_GREEN << "✓ Mémoire verrouillée (MCL_CURRENT | MCL_FUTURE)" 
-              << COLOR_RESET << "\n" << std::endl;
-    
-    // ========================================================================
-    // ÉTAPE 2 : ORDONNANCEMENT SCHED_FIFO
-    // ========================================================================
-    
-    std::cout << "2️⃣  Configuration ordonnancement SCHED_FIFO" << std::endl;
-    std::cout << "   ─────────────────────────────────────────" << std::endl;
-    std::cout << "   Objectif : Garantir l'exécution prioritaire du thread." << std::endl;
-    std::cout << std::endl;
     
-    /*
-     * POLITIQUES D'ORDONNANCEMENT LINUX :
-     * 
-     * SCHED_OTHER (défaut) :
-     *   - Ordonnancement équitable (CFS)
-     *   - Pas de garanties de latence
-     *   - Préemptable à tout moment
-     * 
-     * SCHED_FIFO (temps réel) :
-     *   - First-In-First-Out
-     *   - Priorités 1-99 (99 = plus haute)
-     *   - Préempté UNIQUEMENT par :
-     *     * Thread de priorité supérieure
-     *     * Interruption matérielle
-     *   - Garde le CPU jusqu'à ce qu'il :
-     *     * Se bloque (sleep, I/O, mutex)
-     *     * Yield explicitement
-     */
-    struct sched_param param;
-    param.sched_priority = RT_PRIORITY;
+    // Contextes alloués AVANT la création des threads : le vecteur n'est plus
+    // redimensionné ensuite (les threads gardent un pointeur sur leur contexte)
+    StartBarrier barrier;
+    std::vector<MeasurementThread> threads(config.cpus.size());
     
-    std::cout << "   Configuration :" << std::endl;
-    std::cout << "   • Politique : SCHED_FIFO (temps réel)" << std::endl;
-    std::cout << "   • Priorité  : " << RT_PRIORITY << " (1-99, 99 = max)" << std::endl;
-    std::cout << std::endl;
+    std::cout << "Threads :" << std::endl;
+    size_t created = 0;
+    bool ok = true;
     
-    if (sched_setscheduler(0, SCHED_FIFO, &param) != 0) {
-        std::cerr << COLOR_RED 
-                  << "   ✗ Erreur sched_setscheduler: " << strerror(errno) << "\n\n"
-                  << "   Solutions :\n"
-                  << "   1. Exécuter avec sudo: sudo ./rt_tuto\n"
-                  << "   2. Vérifier : ulimit -r (doit être 99)\n"
-                  << COLOR_RESET << std::endl;
-        munlockall();
-        return false;
+    for (size_t i = 0; i < threads.size(); ++i) {
+        MeasurementThread& ctx = threads[i];
+        ctx.config = config;
+        ctx.config.cpu = config.cpus[i];
+        ctx.out.results.histogram.set_deadline_ns(config.deadline_ns());
+        ctx.out.results.exec_histogram.set_deadline_ns(static_cast<uint64_t>(config.period_us) * 1000);
+        ctx.workload.init(config.workload);
+        ctx.barrier = &barrier;
+        
+        /*
+         * Attributs du thread : PTHREAD_EXPLICIT_SCHED est indispensable,
+         * sinon le thread hérite de la politique du créateur (SCHED_OTHER)
+         * et les paramètres ci-dessous sont ignorés.
+         */
+        pthread_attr_t attr;
+        pthread_attr_init(&attr);
+        pthread_attr_setinheritsched(&attr, PTHREAD_EXPLICIT_SCHED);
+        pthread_attr_setschedpolicy(&attr, ctx.config.policy);
+        
+        struct sched_param param;
+        param.sched_priority = ctx.config.priority;
+        pthread_attr_setschedparam(&attr, &param);
+        
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(static_cast<size_t>(ctx.config.cpu), &cpuset);
+        pthread_attr_setaffinity_np(&attr, sizeof(cpu_set_t), &cpuset);
+        
+        int err = pthread_create(&ctx.thread, &attr, measurement_thread_main, &ctx);
+        pthread_attr_destroy(&attr);
+        
+        if (err != 0) {
+            std::cerr << COLOR_RED << "  ✗ Création du thread pour le CPU " << ctx.config.cpu
+                      << " impossible : " << strerror(err) << COLOR_RESET << std::endl;
+            ok = false;
+            break;
+        }
+        
+        std::cout << "  • T:" << i << " → CPU " << ctx.config.cpu
+                  << ", " << policy_name(ctx.config.policy) << " priorité " << ctx.config.priority << std::endl;
+        created++;
     }
-    std::cout << "   " << COLOR_GREEN << "✓ SCHED_FIFO activé avec priorité " << RT_PRIORITY 
-              << COLOR_RESET << "\n" << std::endl;
     
-    // ========================================================================
-    // ÉTAPE 3 : AFFINAGE CPU (CPU PINNING)
-    // ========================================================================
+    // Libération de la barrière (ou abandon en cas d'erreur)
+    pthread_mutex_lock(&barrier.mutex);
+    if (ok) {
+        while (barrier.ready < static_cast<int>(created)) {
+            pthread_cond_wait(&barrier.cond, &barrier.mutex);
+        }
+        // Premier réveil commun dans 10 ms : tous les threads sont alors
+        // endormis dans clock_nanosleep() et partent exactement ensemble
+        clock_gettime(CLOCK_MONOTONIC, &barrier.start_time);
+        timespec_add_us(barrier.start_time, 10000);
+        barrier.released = true;
+        
+        // Traces ouvertes ici car l'instant de départ est maintenant connu ;
+        // les threads ne les touchent qu'après la libération de la barrière
+        for (size_t i = 0; i < created; ++i) {
+            MeasurementThread& ctx = threads[i];
+            std::string path = config.trace_path.empty() ? std::string()
+                             : config.trace_path + ".cpu" + std::to_string(ctx.config.cpu);
+            if (open_trace(ctx.trace, path, ctx.config, barrier.start_time)) {
+                ctx.out.trace = &ctx.trace;
+            }
+        }
+        
+        std::cout << "\nDémarrage synchronisé de " << created << " thread(s)..." << std::endl;
+    } else {
+        barrier.aborted = true;
+    }
+    pthread_cond_broadcast(&barrier.cond);
+    pthread_mutex_unlock(&barrier.mutex);
     
-    std::cout << "3️⃣  Affinage sur CPU isolé" << std::endl;
-    std::cout << "   ────────────────────────" << std::endl;
-    std::cout << "   Objectif : Exécuter sur un CPU dédié sans interférences." << std::endl;
-    std::cout << std::endl;
+    for (size_t i = 0; i < created; ++i) {
+        pthread_join(threads[i].thread, NULL);
+        close_trace(threads[i].trace);
+    }
     
-    /*
-     * CPU PINNING : POURQUOI ?
-     * 
-     * Même avec SCHED_FIFO, des interférences peuvent survenir :
-     * - Interruptions matérielles
-     * - Threads kernel (softirq, workqueues)
-     * - Cache invalidation par d'autres processus
-     * 
-     * SOLUTION : Combiner l'affinage avec l'isolation CPU du kernel.
-     * 
-     * PARAMÈTRES KERNEL (configurés par setup_realtime_rpi.sh) :
-     *   isolcpus=2,3  : CPUs exclus du scheduler général
-     *   rcu_nocbs=2,3 : RCU callbacks déplacés ailleurs
-     *   nohz_full=2,3 : Ticks timer désactivés (tickless)
-     * 
-     * L'affinage force le thread sur un CPU isolé, garantissant une
-     * exécution sans perturbation.
-     */
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(RT_CPU, &cpuset);
+    if (!ok) {
+        return false;
+    }
     
-    std::cout << "   Configuration :" << std::endl;
-    std::cout << "   • CPU cible : " << RT_CPU << " (isolé par isolcpus=2,3)" << std::endl;
-    std::cout << "   • Méthode   : pthread_setaffinity_np()" << std::endl;
-    std::cout << std::endl;
+    std::cout << "\n" << COLOR_GREEN << "✓ Tous les threads sont terminés" << COLOR_RESET << "\n" << std::endl;
     
-    if (pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpuset) != 0) {
-        std::cerr << COLOR_YELLOW 
-                  << "   ⚠ Avertissement : Affinage CPU échoué - " << strerror(errno) << "\n"
-                  << "     Le test continue mais les résultats peuvent être moins bons.\n"
-                  << COLOR_RESET << std::endl;
-    } else {
-        std::cout << "   " << COLOR_GREEN << "✓ Thread affiné sur CPU " << RT_CPU << " (isolé)" 
-                  << COLOR_RESET << std::endl;
+    // Résultats par thread puis agrégation
+    for (size_t i = 0; i < threads.size(); ++i) {
+        print_thread_summary(i, threads[i]);
+        aggregate.merge(threads[i].out.results);
     }
     
     return true;
 }
 
 // ============================================================================
-// FONCTION DE DÉMONSTRATION DE TÂCHE PÉRIODIQUE
+// RÉSULTATS LISIBLES PAR MACHINE (--format json|csv)
 // ============================================================================
 
 /**
- * @brief Exécute une tâche périodique temps réel et mesure les latences
+ * @brief Paramètres de la mesure, tels qu'exportés (clés stables)
+ */
+ExportInfo make_export_info(const RtConfig& config)
+{
+    ExportInfo info;
+    info.config.emplace_back("period_us", std::to_string(config.period_us));
+    info.config.emplace_back("iterations", std::to_string(config.num_iterations));
+    info.config.emplace_back("policy", policy_name(config.policy));
+    info.config.emplace_back("priority", std::to_string(config.priority));
+    if (config.cpus.empty()) {
+        info.config.emplace_back("cpu", std::to_string(config.cpu));
+    } else {
+        std::string cpus;
+        for (int cpu : config.cpus) {
+            cpus += (cpus.empty() ? "" : ",") + std::to_string(cpu);
+        }
+        info.config.emplace_back("cpus", cpus);
+    }
+    info.config.emplace_back("deadline_us", std::to_string(config.deadline_ns() / 1000));
+    info.config.emplace_back("timer", timer_backend_name(config.timer));
+    info.config.emplace_back("clock", clock_source_name(config.clock.source()));
+    info.config.emplace_back("overrun", config.overrun_policy == OverrunPolicy::SKIP ? "skip" : "catchup");
+    info.config.emplace_back("workload", workload_name(config.workload.type));
+    info.config.emplace_back("workload_param", std::to_string(config.workload.param));
+    info.config.emplace_back("stress", config.stress ? "1" : "0");
+    info.config.emplace_back("subtract_overhead", config.subtract_overhead ? "1" : "0");
+    info.system_snapshot = config.system_snapshot;
+    return info;
+}
+
+/**
+ * @brief Écrit les résultats finaux dans le format demandé
  * 
- * Cette fonction démontre comment implémenter une boucle périodique temps réel
- * avec mesure de latence. C'est le modèle de base pour toute application RT.
+ * Avec --format json|csv, l'affichage humain part sur la sortie d'erreur et
+ * seuls ces résultats restent sur la sortie standard :
+ * "rt_tuto --format json > mesure.json" donne un fichier valide.
  * 
- * @return Vecteur des latences mesurées en nanosecondes
+ * @param out Sortie standard d'origine
+ * @param format JSON ou CSV (TEXT : rien à écrire)
+ * @param info Paramètres et instantané système
+ * @param runs Mesures à exporter
  */
-std::vector<uint64_t> run_periodic_task()
+void write_machine_results(std::ostream& out, OutputFormat format, const ExportInfo& info,
+                           const std::vector<ExportRun>& runs)
 {
-    std::cout << "\n" << COLOR_BLUE 
+    if (format == OutputFormat::JSON) {
+        write_json_results(out, info, runs);
+    } else if (format == OutputFormat::CSV) {
+        write_csv_results(out, info, runs);
+    }
+}
+
+// ============================================================================
+// PORTE DE NON-RÉGRESSION (--baseline, --max-p99, --max-latency, --max-miss-rate)
+// ============================================================================
+
+/// Une ligne de contrôle : ✓ / ✗, libellé, valeur mesurée et limite
+void print_gate_check(bool ok, const char* label, const std::string& measured, const std::string& limit)
+{
+    std::cout << "  " << (ok ? COLOR_GREEN "✓ " : COLOR_RED "✗ ") << std::left << std::setw(20) << label
+              << std::right << std::setw(12) << measured << (ok ? "  ≤ " : "  > ") << limit
+              << COLOR_RESET << std::endl;
+}
+
+/// Durée en µs avec deux décimales : "12.34 µs"
+std::string format_us(uint64_t ns)
+{
+    std::ostringstream text;
+    text << std::fixed << std::setprecision(2) << static_cast<double>(ns) / 1000.0 << " µs";
+    return text.str();
+}
+
+/**
+ * @brief Juge la mesure : seuils absolus puis queue comparée à la référence
+ * 
+ * display_results() qualifie la latence maximale par des paliers fixes
+ * (50 / 100 / 200 µs) à titre indicatif ; ici, les limites sont celles de
+ * l'application et le verdict devient le code de sortie du programme.
+ * 
+ * @param gate Contrôles demandés (aucun : rien n'est affiché)
+ * @param baseline Histogramme de la trace de référence (NULL sans --baseline)
+ * @param current Latences de la mesure
+ * @return true si tous les contrôles passent
+ */
+bool check_regression_gate(const RegressionGate& gate, const LatencyHistogram* baseline,
+                           const LatencyHistogram& current)
+{
+    if (!gate.enabled()) return true;
+    
+    std::cout << "\n" << COLOR_CYAN
               << "╔══════════════════════════════════════════════════════════════╗\n"
-              << "║              EXÉCUTION TÂCHE PÉRIODIQUE                      ║\n"
+              << "║                   PORTE DE NON-RÉGRESSION                    ║\n"
               << "╚══════════════════════════════════════════════════════════════╝"
               << COLOR_RESET << "\n" << std::endl;
     
-    std::cout << "Paramètres :" << std::endl;
-    std::cout << "  • Période     : " << PERIOD_US << " µs (1 ms)" << std::endl;
-    std::cout << "  • Itérations  : " << NUM_ITERATIONS << std::endl;
-    std::cout << "  • Durée totale: ~" << (PERIOD_US * NUM_ITERATIONS / 1000000) << " seconde(s)" << std::endl;
-    std::cout << std::endl;
-    
-    // Pré-allocation du vecteur pour éviter les allocations pendant la boucle
-    std::vector<uint64_t> latencies;
-    latencies.reserve(NUM_ITERATIONS);
+    if (current.empty()) {
+        std::cout << COLOR_RED << "✗ Aucun échantillon : porte en échec" << COLOR_RESET << std::endl;
+        return false;
+    }
     
-    // ========================================================================
-    // INITIALISATION DE L'HORLOGE
-    // ========================================================================
+    bool passed = true;
+    const bool absolute = gate.max_p99_ns != 0 || gate.max_latency_ns != 0 || gate.max_miss_rate >= 0.0;
+    if (absolute) {
+        std::cout << "Seuils absolus :" << std::endl;
+        if (gate.max_p99_ns != 0) {
+            const uint64_t p99_ns = current.value_at_percentile(99.0);
+            const bool ok = p99_ns <= gate.max_p99_ns;
+            print_gate_check(ok, "p99", format_us(p99_ns), format_us(gate.max_p99_ns));
+            passed = passed && ok;
+        }
+        if (gate.max_latency_ns != 0) {
+            const bool ok = current.max_ns() <= gate.max_latency_ns;
+            print_gate_check(ok, "Latence maximale", format_us(current.max_ns()), format_us(gate.max_latency_ns));
+            passed = passed && ok;
+        }
+        if (gate.max_miss_rate >= 0.0) {
+            const double rate = current.stats().deadline_miss_rate();
+            const bool ok = rate <= gate.max_miss_rate;
+            std::ostringstream measured, limit;
+            measured << std::fixed << std::setprecision(4) << rate * 100.0 << " %";
+            limit << std::fixed << std::setprecision(4) << gate.max_miss_rate * 100.0 << " % (deadline "
+                  << format_us(current.stats().deadline_ns()) << ")";
+            print_gate_check(ok, "Deadlines manquées", measured.str(), limit.str());
+            passed = passed && ok;
+        }
+    }
     
-    /*
-     * struct timespec : Structure POSIX pour représenter un instant
-     *   tv_sec  : secondes
-     *   tv_nsec : nanosecondes (0 à 999,999,999)
-     * 
-     * CLOCK_MONOTONIC :
-     *   - Horloge monotone croissante
-     *   - NON affectée par NTP ou changements d'heure
-     *   - Idéale pour mesurer des intervalles
-     * 
-     * Alternative CLOCK_REALTIME :
-     *   - Temps réel (wall clock)
-     *   - PEUT sauter (NTP, ajustements)
-     *   - À ÉVITER pour les mesures de latence
-     */
-    struct timespec next_period;
-    clock_gettime(CLOCK_MONOTONIC, &next_period);
+    if (baseline != nullptr) {
+        std::cout << (absolute ? "\n" : "") << "Queue comparée à la référence " << gate.baseline_path
+                  << " (" << baseline->count() << " échantillons) :" << std::endl;
+        std::cout << "\n  Percentile │ Référence   Courant │ Excès réf  Excès courant │     z │ Verdict" << std::endl;
+        std::cout << "  ───────────┼─────────────────────┼──────────────────────────┼───────┼─────────" << std::endl;
+        for (double percentile : REGRESSION_PERCENTILES) {
+            const TailComparison tail = compare_tail(*baseline, current, percentile);
+            std::ostringstream label;
+            label << "p" << percentile;
+            std::cout << "  " << std::left << std::setw(10) << label.str() << std::right << " │ "
+                      << std::fixed << std::setprecision(1)
+                      << std::setw(9) << static_cast<double>(tail.baseline_ns) / 1000.0
+                      << std::setw(10) << static_cast<double>(tail.current_ns) / 1000.0 << " │ "
+                      << std::setprecision(3)
+                      << std::setw(7) << tail.baseline_excess * 100.0 << " %"
+                      << std::setw(13) << tail.current_excess * 100.0 << " %" << " │ "
+                      << std::setprecision(2) << std::setw(5) << tail.z << " │ "
+                      << (tail.regression ? COLOR_RED "✗ régression" : COLOR_GREEN "✓") << COLOR_RESET
+                      << std::endl;
+            passed = passed && !tail.regression;
+        }
+        std::cout << "  " << std::left << std::setw(10) << "max" << std::right << " │ "
+                  << std::setprecision(1)
+                  << std::setw(9) << static_cast<double>(baseline->max_ns()) / 1000.0
+                  << std::setw(10) << static_cast<double>(current.max_ns()) / 1000.0
+                  << " │ (échantillon unique : borné par --max-latency seulement)" << std::endl;
+        std::cout << "  (µs ; excès = part des échantillons au-delà de la case du percentile de référence ;"
+                  << "\n   régression si z > " << std::setprecision(2) << REGRESSION_Z_THRESHOLD
+                  << ", risque de fausse alerte 0,1 % par percentile)" << std::endl;
+    }
     
-    std::cout << "Démarrage de la boucle périodique..." << std::endl;
-    std::cout << "(Affichage tous les 100 cycles)\n" << std::endl;
+    std::cout << std::endl;
+    if (passed) {
+        std::cout << COLOR_GREEN << "✓ Porte franchie : aucune régression" << COLOR_RESET << std::endl;
+    } else {
+        std::cout << COLOR_RED << "✗ Porte en échec : code de sortie " << EXIT_REGRESSION
+                  << COLOR_RESET << std::endl;
+    }
+    return passed;
+}
+
+// ============================================================================
+// COMPTEURS MATÉRIELS PAR CYCLE (--pmu)
+// ============================================================================
+
+/// Libellés courts des colonnes, dans l'ordre de PMU_CYCLE_EVENTS
+const char* const PMU_COLUMN_LABELS[PMU_EVENT_COUNT] = {
+    "cycles", "instr.", "L1D miss", "L2 miss", "br. miss", "ctx sw"
+};
+
+/**
+ * @brief Affiche les compteurs moyens par tranche de la distribution
+ * 
+ * Trois lignes : cycles typiques (sous le p99), p99 à p99.9, au-delà du
+ * p99.9. Les tranches suivent les bandes de CounterCorrelation : leurs
+ * bornes sont arrondies à la bande qui contient le percentile.
+ * 
+ * @param title Titre du tableau
+ * @param correlation Sommes par bande
+ * @param histogram Distribution rangée dans correlation (percentiles)
+ * @param pmu Disponibilité des compteurs
+ * @param typical Moyennes de la ligne typique (sortie)
+ * @param tail Moyennes de la tranche la plus haute non vide (sortie)
+ * @return false si aucune tranche de queue n'a d'échantillon
+ */
+bool print_pmu_table(const char* title, const CounterCorrelation& correlation,
+                     const LatencyHistogram& histogram, const PmuStats& pmu,
+                     double* typical, double* tail)
+{
+    const size_t b99 = CounterCorrelation::band_of(histogram.value_at_percentile(99.0));
+    const size_t b999 = CounterCorrelation::band_of(histogram.value_at_percentile(99.9));
+    const char* labels[3] = {"typique (< p99)", "p99 à p99.9", "≥ p99.9"};
+    const size_t bounds[4] = {0, b99, b999, CounterCorrelation::BAND_COUNT};
     
-    // ========================================================================
-    // BOUCLE PÉRIODIQUE TEMPS RÉEL
-    // ========================================================================
+    std::cout << "  " << title << " (moyenne par cycle) :" << std::endl;
+    std::cout << "    " << std::left << std::setw(18) << "tranche" << std::right << std::setw(8) << "n";
+    for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) std::cout << std::setw(11) << PMU_COLUMN_LABELS[k];
+    std::cout << std::endl;
     
-    for (int i = 0; i < NUM_ITERATIONS; ++i) {
-        // --------------------------------------------------------------------
-        // ATTENTE DE LA PROCHAINE PÉRIODE
-        // --------------------------------------------------------------------
-        
-        /*
-         * clock_nanosleep() : Suspension précise du thread
-         * 
-         * Paramètres :
-         *   CLOCK_MONOTONIC : horloge de référence
-         *   TIMER_ABSTIME   : temps ABSOLU (pas relatif)
-         *   &next_period    : instant de réveil
-         *   NULL            : pas de temps restant retourné
-         * 
-         * POURQUOI TIMER_ABSTIME ?
-         * Avec un temps relatif, les petites erreurs s'accumulent.
-         * Avec un temps absolu, on spécifie l'instant exact de réveil,
-         * évitant toute dérive sur le long terme.
-         */
-        clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next_period, NULL);
-        
-        // --------------------------------------------------------------------
-        // MESURE DE LA LATENCE
-        // --------------------------------------------------------------------
-        
-        /*
-         * Immédiatement après le réveil, on mesure l'instant réel.
-         * La latence est la différence entre l'instant prévu (next_period)
-         * et l'instant réel (now).
-         * 
-         * Une latence de 0 est impossible (temps de réveil du scheduler).
-         * Une latence < 100 µs est excellente avec un kernel RT.
-         * Une latence > 500 µs indique un problème de configuration.
-         */
-        struct timespec now;
-        clock_gettime(CLOCK_MONOTONIC, &now);
-        
-        uint64_t latency_ns = timespec_diff_ns(next_period, now);
-        latencies.push_back(latency_ns);
-        
-        // --------------------------------------------------------------------
-        // CALCUL DE LA PROCHAINE PÉRIODE
-        // --------------------------------------------------------------------
-        
-        /*
-         * On ajoute la période à l'instant prévu.
-         * Si tv_nsec dépasse 1 seconde (1,000,000,000 ns), on incrémente
-         * tv_sec et on soustrait 1 seconde de tv_nsec.
-         */
-        next_period.tv_nsec += PERIOD_US * 1000;  // µs → ns
-        if (next_period.tv_nsec >= 1000000000) {
-            next_period.tv_sec++;
-            next_period.tv_nsec -= 1000000000;
+    bool has_tail = false;
+    for (size_t row = 0; row < 3; ++row) {
+        double means[PMU_EVENT_COUNT];
+        const uint64_t cycles = correlation.means_between(bounds[row], bounds[row + 1], means);
+        std::cout << "    " << labels[row];
+        // Largeur affichée : « à » et « ≥ » occupent plusieurs octets
+        const size_t shown = row == 0 ? 15 : (row == 1 ? 11 : 7);
+        std::cout << std::string(18 - shown, ' ') << std::setw(8) << cycles;
+        for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) {
+            if (!pmu.available[k]) {
+                std::cout << std::setw(11) << "n/d";
+            } else if (cycles == 0) {
+                std::cout << std::setw(11) << "-";
+            } else {
+                std::cout << std::setw(11) << std::setprecision(means[k] < 100.0 ? 2 : 0) << means[k];
+            }
         }
+        std::cout << std::endl;
         
-        // Affichage de la progression
-        if ((i + 1) % 100 == 0) {
-            std::cout << "  Cycle " << std::setw(4) << (i + 1) << "/" << NUM_ITERATIONS 
-                      << " - Latence courante: " << std::setw(5) << (latency_ns / 1000) 
-                      << " µs" << std::endl;
+        if (row == 0) {
+            std::copy(means, means + PMU_EVENT_COUNT, typical);
+        } else if (cycles > 0) {
+            std::copy(means, means + PMU_EVENT_COUNT, tail);
+            has_tail = true;
         }
     }
+    std::cout << std::setprecision(2);
+    return has_tail;
+}
+
+/**
+ * @brief Explique la queue par l'écart de ses compteurs à la ligne typique
+ * 
+ * Ordre des hypothèses : une préemption (changement de contexte) domine
+ * tout le reste ; puis la pollution de cache (défauts L1D/L2), puis un
+ * chemin de code plus long (instructions). Si aucun compteur du thread ne
+ * bouge, le temps perdu l'a été hors de lui.
+ */
+void print_pmu_diagnosis(const double* typical, const double* tail, const PmuStats& pmu)
+{
+    auto ratio = [&](size_t k) {
+        return typical[k] > 0.0 ? tail[k] / typical[k] : (tail[k] > 0.0 ? 1e9 : 1.0);
+    };
     
-    std::cout << "\n" << COLOR_GREEN << "✓ Tâche périodique terminée" << COLOR_RESET << std::endl;
+    std::cout << "    → queue / typique :";
+    for (size_t k = 0; k < PMU_EVENT_COUNT; ++k) {
+        if (!pmu.available[k]) continue;
+        std::cout << " " << PMU_COLUMN_LABELS[k] << " ×";
+        if (ratio(k) >= 1e9) {
+            std::cout << "∞";
+        } else {
+            std::cout << std::setprecision(1) << ratio(k) << std::setprecision(2);
+        }
+    }
+    std::cout << std::endl;
+    
+    const size_t CYCLES = 0, INSTRUCTIONS = 1, L1D = 2, L2 = 3, CTX = 5;
+    std::cout << "    → ";
+    if (pmu.available[CTX] && tail[CTX] - typical[CTX] >= 0.5) {
+        std::cout << COLOR_YELLOW << "Changements de contexte en excès : délai d'ordonnancement"
+                  << " (thread préempté ou réveillé en retard)" << COLOR_RESET;
+    } else if ((pmu.available[L1D] && ratio(L1D) >= 2.0) || (pmu.available[L2] && ratio(L2) >= 2.0)) {
+        std::cout << COLOR_YELLOW << "Défauts de cache en excès : pollution par un voisin ou"
+                  << " données évincées pendant le sommeil" << COLOR_RESET;
+    } else if (pmu.available[INSTRUCTIONS] && ratio(INSTRUCTIONS) >= 1.5) {
+        std::cout << COLOR_YELLOW << "Instructions en excès : chemin de code plus long"
+                  << " (branche rare, travail différé)" << COLOR_RESET;
+    } else if (pmu.available[CYCLES] && ratio(CYCLES) < 1.5) {
+        std::cout << COLOR_YELLOW << "Compteurs du thread inchangés : temps perdu hors de lui"
+                  << " (IRQ, SMI, hyperviseur, fréquence CPU)" << COLOR_RESET;
+    } else {
+        std::cout << "Aucune cause dominante parmi les compteurs disponibles";
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Section « compteurs matériels » des résultats
+ */
+void print_pmu_results(const TaskResults& results)
+{
+    const PmuStats& pmu = results.pmu;
+    std::cout << "\nCompteurs matériels par cycle (" << pmu.cycles << " cycles) :" << std::endl;
+    
+    double typical[PMU_EVENT_COUNT] = {};
+    double tail[PMU_EVENT_COUNT] = {};
+    if (print_pmu_table("Par latence de réveil", pmu.by_latency, results.histogram, pmu, typical, tail)) {
+        print_pmu_diagnosis(typical, tail, pmu);
+    }
+    if (!results.exec_histogram.empty()) {
+        std::fill(typical, typical + PMU_EVENT_COUNT, 0.0);
+        std::fill(tail, tail + PMU_EVENT_COUNT, 0.0);
+        if (print_pmu_table("Par temps d'exécution", pmu.by_exec, results.exec_histogram, pmu, typical, tail)) {
+            print_pmu_diagnosis(typical, tail, pmu);
+        }
+    }
     
-    return latencies;
+    std::cout << "  • Lecture           : "
+              << (pmu.user_read ? "rdpmc/mrs en espace utilisateur, sans appel système"
+                                : "read() groupé (un appel système par cycle)") << std::endl;
+    if (pmu.user_only) {
+        std::cout << "  " << COLOR_YELLOW << "⚠ Kernel exclu (perf_event_paranoid) : chemin de réveil"
+                  << " non compté" << COLOR_RESET << std::endl;
+    }
+    if (!pmu.error.empty()) {
+        std::cout << "  • Indisponibles     : " << pmu.error << std::endl;
+    }
 }
 
 // ============================================================================
@@ -395,21 +2629,23 @@ std::vector<uint64_t> run_periodic_task()
 /**
  * @brief Analyse et affiche les statistiques de latence
  * 
- * @param latencies Vecteur des latences en nanosecondes
+ * @param results Histogramme des latences et dépassements de période
  */
-void display_results(const std::vector<uint64_t>& latencies)
+void display_results(const TaskResults& results)
 {
-    if (latencies.empty()) {
+    const LatencyHistogram& histogram = results.histogram;
+    
+    if (histogram.empty()) {
         std::cerr << COLOR_RED << "Erreur : Aucune donnée de latence" << COLOR_RESET << std::endl;
         return;
     }
     
     // Calcul des statistiques
-    LatencyStats stats = calculate_stats(latencies);
+    LatencyStats stats = calculate_stats(histogram);
     
     // Conversion en microsecondes pour l'affichage
-    double min_us = stats.min_ns / 1000.0;
-    double max_us = stats.max_ns / 1000.0;
+    double min_us = static_cast<double>(stats.min_ns) / 1000.0;
+    double max_us = static_cast<double>(stats.max_ns) / 1000.0;
     double avg_us = stats.avg_ns / 1000.0;
     double stddev_us = stats.stddev_ns / 1000.0;
     
@@ -439,9 +2675,144 @@ void display_results(const std::vector<uint64_t>& latencies)
     
     std::cout << "  • Latence moyenne   : " << std::setw(8) << avg_us << " µs" << std::endl;
     std::cout << "  • Écart-type        : " << std::setw(8) << stddev_us << " µs" << std::endl;
+    std::cout << "  • Échantillons      : " << std::setw(8) << histogram.count() << std::endl;
+    
+    // Deadlines manquées : comptées en ligne par RunningStats
+    const RunningStats& running = histogram.stats();
+    if (running.deadline_ns() != 0) {
+        std::cout << "  • Deadlines manquées: " << std::setw(8) << running.deadline_misses()
+                  << " (" << std::setprecision(3) << running.deadline_miss_rate() * 100.0
+                  << std::setprecision(2) << " %, latence > "
+                  << static_cast<double>(running.deadline_ns()) / 1000.0 << " µs)" << std::endl;
+    }
+    
+    // Interférences : ce qui a interrompu le CPU mesuré pendant la fenêtre
+    const InterferenceStats& interference = results.interference;
+    if (interference.measured) {
+        std::cout << "\nInterférences sur le CPU " << interference.cpu << " :" << std::endl;
+        std::cout << "  • IRQs reçues       : " << std::setw(8) << interference.total_irqs() << std::endl;
+        const size_t shown = std::min<size_t>(interference.irqs.size(), 8);
+        for (size_t k = 0; k < shown; ++k) {
+            std::cout << "      " << std::setw(8) << interference.irqs[k].second << "  "
+                      << interference.irqs[k].first << std::endl;
+        }
+        if (interference.irqs.size() > shown) {
+            std::cout << "      (+" << interference.irqs.size() - shown << " autre(s) source(s))" << std::endl;
+        }
+        std::cout << "  • Softirqs          :";
+        if (interference.softirqs.empty()) std::cout << " aucun";
+        for (const auto& softirq : interference.softirqs) {
+            std::cout << " " << softirq.first << "=" << softirq.second;
+        }
+        std::cout << std::endl;
+        std::cout << "  • Changements de contexte : " << interference.voluntary_switches
+                  << " volontaires, " << interference.involuntary_switches << " préemptions";
+        if (interference.involuntary_switches > 0) {
+            std::cout << "  " << COLOR_YELLOW << "← Thread RT préempté" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Dépassements de période : la métrique qui compte pour une boucle de contrôle
+    const OverrunStats& overruns = results.overruns;
+    std::cout << "\nDépassements de période :" << std::endl;
+    std::cout << "  • Cycles en retard  : " << std::setw(8) << overruns.overruns()
+              << " (" << std::setprecision(3) << overruns.overrun_rate() * 100.0
+              << std::setprecision(2) << " %)";
+    if (overruns.overruns() == 0) {
+        std::cout << "  " << COLOR_GREEN << "← Aucun" << COLOR_RESET;
+    } else {
+        std::cout << "  " << COLOR_RED << "← Échéances manquées" << COLOR_RESET;
+    }
+    std::cout << std::endl;
+    if (overruns.overruns() > 0) {
+        std::cout << "  • Périodes manquées : " << std::setw(8) << overruns.missed_periods() << std::endl;
+        std::cout << "  • Plus longue série : " << std::setw(8) << overruns.longest_streak() << " cycle(s)" << std::endl;
+        std::cout << "  • Retard maximal    : " << std::setw(8)
+                  << static_cast<double>(overruns.max_overrun_ns()) / 1000.0 << " µs" << std::endl;
+    }
+    
+    // Percentiles : tous calculés en un seul parcours de l'histogramme
+    LatencyPercentiles pct = calculate_percentiles(histogram);
+    
+    std::cout << "\nPercentiles :" << std::endl;
+    std::cout << "  • p50 (médiane)     : " << std::setw(8) << static_cast<double>(pct.p50_ns) / 1000.0 << " µs" << std::endl;
+    std::cout << "  • p90               : " << std::setw(8) << static_cast<double>(pct.p90_ns) / 1000.0 << " µs" << std::endl;
+    std::cout << "  • p99               : " << std::setw(8) << static_cast<double>(pct.p99_ns) / 1000.0 << " µs" << std::endl;
+    std::cout << "  • p99.9             : " << std::setw(8) << static_cast<double>(pct.p999_ns) / 1000.0 << " µs" << std::endl;
+    std::cout << "  • p99.99            : " << std::setw(8) << static_cast<double>(pct.p9999_ns) / 1000.0 << " µs" << std::endl;
+    
+    // Mémoire : le chemin RT ne doit ni allouer ni provoquer de page fault
+    const MemoryGuardStats& memory = results.memory;
+    if (memory.measured) {
+        bool clean = memory.minor_faults == 0 && memory.major_faults == 0 && memory.allocations == 0;
+        std::cout << "\nMémoire pendant la mesure :" << std::endl;
+        std::cout << "  • Page faults mineurs: " << std::setw(7) << memory.minor_faults << std::endl;
+        std::cout << "  • Page faults majeurs: " << std::setw(7) << memory.major_faults << std::endl;
+        std::cout << "  • Allocations       : " << std::setw(8) << memory.allocations;
+        if (clean) {
+            std::cout << "  " << COLOR_GREEN << "← Chemin RT sans allocation ni page fault" << COLOR_RESET;
+        } else {
+            std::cout << "  " << COLOR_YELLOW << "← Augmenter --prefault-stack/--prefault-heap" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Instrument : part de la mesure due à la mesure elle-même
+    const InstrumentFloor& instrument = results.instrument;
+    if (instrument.measured) {
+        std::cout << "\nInstrument de mesure :" << std::endl;
+        std::cout << "  • Lecture d'horloge : " << std::setw(8) << instrument.read_min_ns << " ns min, "
+                  << instrument.read_p50_ns << " ns médiane, " << instrument.read_max_ns << " ns max"
+                  << std::endl;
+        std::cout << "  • Comptabilité/cycle: " << std::setw(8) << instrument.bookkeeping_p50_ns
+                  << " ns (lecture + conversion + histogramme, médiane)" << std::endl;
+        if (instrument.subtracted) {
+            std::cout << "  • Plancher soustrait: " << std::setw(8) << instrument.read_min_ns
+                      << " ns retirés de chaque latence" << std::endl;
+        } else if (stats.min_ns < 2 * instrument.bookkeeping_p50_ns) {
+            std::cout << "  " << COLOR_YELLOW << "⚠ Latence minimale proche du plancher : "
+                      << "--subtract-overhead donne la latence nette" << COLOR_RESET << std::endl;
+        }
+    }
+    
+    // Temps d'exécution de la charge : combien de calcul tient dans la période
+    const LatencyHistogram& exec = results.exec_histogram;
+    if (!exec.empty()) {
+        LatencyStats exec_stats = calculate_stats(exec);
+        LatencyPercentiles exec_pct = calculate_percentiles(exec);
+        const double period_us = static_cast<double>(exec.stats().deadline_ns()) / 1000.0;
+        const double exec_max_us = static_cast<double>(exec_stats.max_ns) / 1000.0;
+        
+        std::cout << "\nTemps d'exécution de la charge :" << std::endl;
+        std::cout << "  • Minimum           : " << std::setw(8) << static_cast<double>(exec_stats.min_ns) / 1000.0 << " µs" << std::endl;
+        std::cout << "  • Moyenne           : " << std::setw(8) << exec_stats.avg_ns / 1000.0 << " µs" << std::endl;
+        std::cout << "  • p99               : " << std::setw(8) << static_cast<double>(exec_pct.p99_ns) / 1000.0 << " µs" << std::endl;
+        std::cout << "  • p99.9             : " << std::setw(8) << static_cast<double>(exec_pct.p999_ns) / 1000.0 << " µs" << std::endl;
+        std::cout << "  • Maximum           : " << std::setw(8) << exec_max_us << " µs" << std::endl;
+        
+        // Budget : le pire cycle cumule (au pire) le pire réveil et la pire exécution
+        double worst_us = max_us + exec_max_us;
+        std::cout << "  • Budget utilisé    : " << std::setw(8) << exec_max_us / period_us * 100.0
+                  << " % de la période (pire exécution)" << std::endl;
+        std::cout << "  • Réveil + exécution: " << std::setw(8) << worst_us << " µs (pires cas cumulés)";
+        if (worst_us < period_us * 0.8) {
+            std::cout << "  " << COLOR_GREEN << "← Marge confortable" << COLOR_RESET;
+        } else if (worst_us < period_us) {
+            std::cout << "  " << COLOR_YELLOW << "← Marge faible" << COLOR_RESET;
+        } else {
+            std::cout << "  " << COLOR_RED << "← Dépasse la période" << COLOR_RESET;
+        }
+        std::cout << std::endl;
+    }
+    
+    // Compteurs PMU : ce qui distingue un cycle de la queue d'un cycle typique
+    if (results.pmu.measured) {
+        print_pmu_results(results);
+    }
     
     // Affichage de l'histogramme
-    print_histogram(latencies);
+    print_histogram(histogram);
     
     // Recommandations
     std::cout << "\n" << COLOR_CYAN << "💡 Recommandations :" << COLOR_RESET << std::endl;
@@ -459,6 +2830,7 @@ void display_results(const std::vector<uint64_t>& latencies)
         std::cout << "    • Kernel RT actif : uname -r (doit contenir 'rt' ou 'realtime')" << std::endl;
         std::cout << "    • CPUs isolés : cat /sys/devices/system/cpu/isolated (doit être '2-3')" << std::endl;
         std::cout << "    • Limites RT : ulimit -r (doit être 99)" << std::endl;
+        std::cout << "    (réglages relevés sur cette machine : section « Environnement » en tête de mesure)" << std::endl;
     }
     
     std::cout << std::endl;
@@ -466,6 +2838,136 @@ void display_results(const std::vector<uint64_t>& latencies)
     std::cout << "   sudo cyclictest -t1 -p 80 -a 2 -m -i 1000 -l 3600000" << std::endl;
 }
 
+/**
+ * @brief Relit une trace binaire et affiche ses résultats (--analyze)
+ * 
+ * Reconstruit l'histogramme à partir des enregistrements : les statistiques
+ * et l'histogramme affichés sont ceux qu'aurait produits la mesure d'origine.
+ * 
+ * @param path Chemin du fichier de trace
+ * @param format Format des résultats en plus de l'affichage (--format)
+ * @param results_out Destination des résultats JSON / CSV
+ * @param gate Contrôles de non-régression appliqués à la trace
+ * @param baseline Histogramme de référence (NULL sans --baseline)
+ * @return Code de sortie du programme (0 = succès, EXIT_REGRESSION si la
+ *         porte échoue)
+ */
+int analyze_trace(const std::string& path, OutputFormat format, std::ostream& results_out,
+                  const RegressionGate& gate, const LatencyHistogram* baseline)
+{
+    TraceReader reader;
+    if (!reader.open(path)) {
+        std::cerr << COLOR_RED << "✗ Lecture de " << path << " impossible : "
+                  << reader.error() << COLOR_RESET << std::endl;
+        return 1;
+    }
+    
+    const TraceFileHeader* h = reader.header();
+    
+    std::cout << COLOR_CYAN
+              << "\n╔══════════════════════════════════════════════════════════════╗\n"
+              << "║                 ANALYSE D'UNE TRACE BINAIRE                  ║\n"
+              << "╚══════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << "\n" << std::endl;
+    
+    std::cout << "Trace : " << path << std::endl;
+    std::cout << "  • Machine      : " << h->nodename << " (" << h->machine << ")" << std::endl;
+    std::cout << "  • Kernel       : " << h->sysname << " " << h->release << std::endl;
+    std::cout << "                   " << h->kernel_version << std::endl;
+    std::cout << "  • Période      : " << h->period_us << " µs" << std::endl;
+    std::cout << "  • CPU          : " << h->cpu << std::endl;
+    std::cout << "  • Priorité RT  : " << h->priority << std::endl;
+    std::cout << "  • Échantillons : " << reader.count() << std::endl;
+    
+    // Configuration système relevée au moment de la mesure (si enregistrée)
+    std::string snapshot = reader.metadata();
+    if (!snapshot.empty()) {
+        std::cout << "\nConfiguration système de la mesure :" << std::endl;
+        std::istringstream lines(snapshot);
+        std::string line;
+        while (std::getline(lines, line)) {
+            std::cout << "  " << line << std::endl;
+        }
+    }
+    
+    /*
+     * La deadline n'est pas stockée dans la trace : la période sert de
+     * deadline. Les dépassements sont reconstruits avec la même règle que
+     * la boucle : un réveil en retard d'au moins une période a manqué
+     * l'échéance suivante.
+     */
+    const uint64_t period_ns = static_cast<uint64_t>(h->period_us) * 1000;
+    TaskResults results;
+    results.histogram.set_deadline_ns(period_ns);
+    for (uint64_t i = 0; i < reader.count(); ++i) {
+        uint64_t latency_ns = reader.record(i).latency_ns;
+        results.histogram.record(latency_ns);
+        if (period_ns != 0 && latency_ns >= period_ns) {
+            results.overruns.record_overrun(latency_ns - period_ns, latency_ns / period_ns);
+        } else {
+            results.overruns.record_on_time();
+        }
+    }
+    
+    display_results(results);
+    
+    if (format != OutputFormat::TEXT) {
+        ExportInfo info;
+        info.config.emplace_back("trace", path);
+        info.config.emplace_back("period_us", std::to_string(h->period_us));
+        info.config.emplace_back("cpu", std::to_string(h->cpu));
+        info.config.emplace_back("priority", std::to_string(h->priority));
+        info.config.emplace_back("deadline_us", std::to_string(h->period_us));
+        info.system_snapshot = snapshot;
+        write_machine_results(results_out, format, info, {ExportRun{"rt", &results}});
+    }
+    return check_regression_gate(gate, baseline, results.histogram) ? 0 : EXIT_REGRESSION;
+}
+
+// ============================================================================
+// VALIDATION DE L'ENVIRONNEMENT
+// ============================================================================
+
+/**
+ * @brief Affiche l'instantané système et les réglages qui dégradent la latence
+ * 
+ * @param snap Instantané relevé avant la mesure
+ * @param warnings Problèmes détectés par validate_snapshot()
+ */
+void print_environment_check(const SystemSnapshot& snap, const std::vector<std::string>& warnings)
+{
+    std::cout << "\nEnvironnement :" << std::endl;
+    std::cout << "  • Kernel           : " << snap.kernel_release
+              << (snap.preempt_rt() ? " (PREEMPT_RT)" : "") << std::endl;
+    std::cout << "  • CPUs isolés      : " << (snap.isolated.empty() ? "aucun" : snap.isolated) << std::endl;
+    std::cout << "  • nohz_full        : " << (snap.nohz_full.empty() ? "aucun" : snap.nohz_full) << std::endl;
+    std::cout << "  • rcu_nocbs        : " << (snap.rcu_nocbs.empty() ? "aucun" : snap.rcu_nocbs) << std::endl;
+    for (const CpuFrequencyInfo& info : snap.frequencies) {
+        std::cout << "  • CPU " << info.cpu << " cpufreq    : ";
+        if (info.governor.empty()) {
+            std::cout << "non disponible" << std::endl;
+        } else {
+            std::cout << info.governor << ", " << info.cur_khz / 1000 << "/" << info.max_khz / 1000
+                      << " MHz" << std::endl;
+        }
+    }
+    std::cout << "  • Limitation RT    : ";
+    if (snap.rt_runtime_us < 0) {
+        std::cout << "désactivée" << std::endl;
+    } else {
+        std::cout << snap.rt_runtime_us << "/" << snap.rt_period_us << " µs" << std::endl;
+    }
+    std::cout << "  • IRQs sur CPU(s)  : " << snap.irqs.size() << std::endl;
+    
+    if (warnings.empty()) {
+        std::cout << "  " << COLOR_GREEN << "✓ Configuration conforme pour la mesure" << COLOR_RESET << std::endl;
+        return;
+    }
+    for (const std::string& warning : warnings) {
+        std::cout << "  " << COLOR_YELLOW << "⚠ " << warning << COLOR_RESET << std::endl;
+    }
+}
+
 // ============================================================================
 // FONCTION D'AIDE
 // ============================================================================
@@ -486,7 +2988,115 @@ void print_usage(const char* program_name)
               << "  • Boucle périodique avec mesure de latence\n"
               << "\n"
               << "OPTIONS:\n"
-              << "  --help, -h  Affiche cette aide\n"
+              << "  --period <us>     Période de la tâche en µs (défaut: " << DEFAULT_PERIOD_US << ")\n"
+              << "  --loops <n>       Nombre d'itérations (défaut: " << DEFAULT_NUM_ITERATIONS << ")\n"
+              << "  --duration <s>    Durée du test en secondes (remplace --loops)\n"
+              << "  --prio <1-99>     Priorité SCHED_FIFO (défaut: " << DEFAULT_RT_PRIORITY << ")\n"
+              << "  --cpu <n>         CPU cible de l'affinage (défaut: " << DEFAULT_RT_CPU << ")\n"
+              << "  --policy <p>      Ordonnancement : fifo (défaut), rr ou deadline (EDF,\n"
+              << "                    réservation runtime/deadline/période via sched_setattr)\n"
+              << "  --runtime <us>    Budget SCHED_DEADLINE par période (défaut: estimé sur\n"
+              << "                    la charge, 1,25 × pire temps + " << DEADLINE_RUNTIME_MARGIN_US << " µs)\n"
+              << "  --deadline <us>   Latence au-delà de laquelle une deadline est manquée\n"
+              << "                    (défaut: la période)\n"
+              << "  --overrun <mode>  Après un dépassement de période : skip (sauter les\n"
+              << "                    échéances passées, défaut) ou catchup (rattraper dos à dos)\n"
+              << "  --workload <type[:n]> Charge exécutée à chaque cycle, temps d'exécution\n"
+              << "                    mesuré à part : none (défaut), memwalk[:Ko] (parcours\n"
+              << "                    mémoire, " << DEFAULT_MEMWALK_KB << " Ko), fir[:échantillons] (filtre FIR, "
+              << DEFAULT_FIR_SAMPLES << "),\n"
+              << "                    matmul[:N] (produit de matrices N×N, " << DEFAULT_MATMUL_N << ")\n"
+              << "  --task <p>[:charge] Exécutif multi-cadences : tâche de période p µs (option\n"
+              << "                    répétable, périodes harmoniques), toutes exécutées sur un\n"
+              << "                    seul thread ; trame de base = plus petite période\n"
+              << "  --ipc <primitive> Banc de messagerie RT → non-RT (aller, aller-retour, coût\n"
+              << "                    de l'envoi) : pi-mutex, futex, eventfd, spsc, seqlock ou all\n"
+              << "  --peer-cpu <n>    CPU du thread pair du banc --ipc (défaut: " << DEFAULT_REPORT_CPU << ")\n"
+              << "  --peer-prio <n>   Priorité SCHED_FIFO du pair (défaut: 0 = SCHED_OTHER)\n"
+              << "  --gpio <n>        Broche BCM basculée à chaque cycle par /dev/gpiomem : haute\n"
+              << "                    au réveil, basse en fin de cycle (analyseur logique)\n"
+              << "  --gpio-input <n>  Avec --gpio : entrée reliée à la sortie, aller-retour\n"
+              << "                    sortie → IRQ → espace utilisateur\n"
+              << "  --gpio-chip <dev> Contrôleur de l'entrée (défaut: " << DEFAULT_GPIO_CHIP << ")\n"
+              << "  --soak            Rodage de longue durée : sans limite de cycles (sauf\n"
+              << "                    --duration), une ligne par fenêtre, arrêt propre sur\n"
+              << "                    Ctrl-C ou SIGTERM (résultats finaux, SCHED_OTHER, munlockall)\n"
+              << "  --soak-window <s> Fenêtre courte du rodage (défaut: " << DEFAULT_SOAK_WINDOW_S
+              << " s ; fenêtre longue = " << SOAK_LONG_WINDOW_FACTOR << " ×)\n"
+              << "  --cache-sweep     Temps d'exécution de la charge RT (défaut: memwalk) face à\n"
+              << "                    un agresseur de cache dont l'empreinte double à chaque passe\n"
+              << "  --aggressor-kb <min-max> Empreintes balayées en Ko (défaut: "
+              << DEFAULT_AGGRESSOR_MIN_KB << "-" << DEFAULT_AGGRESSOR_MAX_KB << ")\n"
+              << "  --aggressor-cpus <liste> CPUs des agresseurs (défaut: le CPU du rapport)\n"
+              << "  --stress          Charge de fond SCHED_OTHER pendant la mesure : memcpy,\n"
+              << "                    appels système et écritures fichier sur chaque CPU de service\n"
+              << "  --stress-cpus <liste> CPUs de la charge de fond (défaut: 0,1)\n"
+              << "  --stress-dir <rép> Répertoire des écritures de la charge (défaut: .)\n"
+              << "  --compare         Exécute la tâche sans RT puis avec RT et affiche le\n"
+              << "                    tableau comparatif (latences, percentiles, deadlines)\n"
+              << "  --sweep           Exécute la tâche sous les 8 combinaisons mlockall ×\n"
+              << "                    SCHED_FIFO × affinage et affiche la matrice max/p99/p99.9\n"
+              << "                    (avec --policy deadline : + 2 combinaisons SCHED_DEADLINE)\n"
+              << "  --sweep-rr        Ajoute les combinaisons SCHED_RR au balayage\n"
+              << "  --prefault-stack <Ko> Pile pré-chargée par thread RT (défaut: " << DEFAULT_PREFAULT_STACK_KB << ")\n"
+              << "  --prefault-heap <Ko>  Réserve de tas pré-chargée (défaut: " << DEFAULT_PREFAULT_HEAP_KB << ")\n"
+              << "  --memory-guard abort  Arrête le programme à la première allocation ou page\n"
+              << "                    fault pendant la mesure (sinon elles sont seulement comptées)\n"
+              << "  --timer <mode>    Mécanisme de réveil : nanosleep (défaut), timerfd, signal\n"
+              << "                    (timer_create), hybrid (sommeil puis attente active), busy,\n"
+              << "                    ou all (mesure chacun et affiche le comparatif)\n"
+              << "  --spin <us>       Mécanisme hybrid : attente active avant l'échéance (défaut: "
+              << DEFAULT_SPIN_US << ")\n"
+              << "  --subtract-overhead Retire des latences le coût d'une lecture d'horloge,\n"
+              << "                    mesuré avant la boucle sur le même CPU\n"
+              << "  --pmu             Compteurs PMU relevés à chaque cycle (cycles, instructions,\n"
+              << "                    défauts L1D/L2, mauvaises prédictions, changements de\n"
+              << "                    contexte), moyennés par tranche de latence et d'exécution\n"
+              << "  --break-on <us>   Trace kernel (ftrace) du CPU mesuré, figée au premier\n"
+              << "                    échantillon au-dessus du seuil ; la mesure s'arrête\n"
+              << "  --break-events <liste> Événements enregistrés (défaut: sched_switch,\n"
+              << "                    sched_wakeup, irq_handler_*, softirq_entry, hrtimer_expire_*)\n"
+              << "  --break-file <fichier> Destination de la trace kernel (défaut: "
+              << DEFAULT_BREAK_FILE << ")\n"
+              << "  --clock <source>  Horodatage : monotonic (défaut, clock_gettime) ou cntvct\n"
+              << "                    (compteur ARM lu directement, builds Raspberry Pi 4)\n"
+              << "  --cpus <liste>    Un thread RT par CPU listé, démarrage synchronisé\n"
+              << "                    (ex: 2,3 ou 2-3, comme cyclictest -t -a)\n"
+              << "  --report-cpu <n>  CPU du thread de rapport non-RT (défaut: " << DEFAULT_REPORT_CPU << ")\n"
+              << "  --log <fichier>   Journal texte des échantillons (cycle, instant, latence)\n"
+              << "  --trace <fichier> Trace binaire des échantillons (mmap, relue par --analyze)\n"
+              << "                    (mode --cpus : un fichier <fichier>.cpuN par thread)\n"
+              << "  --analyze <fichier> Affiche les résultats d'une trace binaire (sans sudo)\n"
+              << "  --format <f>      Résultats finaux : text (défaut), json ou csv ; en json/csv,\n"
+              << "                    seuls les résultats vont sur la sortie standard, l'affichage\n"
+              << "                    humain passe sur la sortie d'erreur\n"
+              << "  --prom-file <fichier> Métriques Prometheus réécrites chaque seconde par le\n"
+              << "                    thread de rapport (textfile collector de node_exporter)\n"
+              << "  --baseline <trace> Compare la queue (p99, p99.9, p99.99) à une trace de\n"
+              << "                    référence (--trace) : test z, régression → code de sortie 2\n"
+              << "  --max-p99 <µs>    Échec (code 2) si le p99 dépasse la limite\n"
+              << "  --max-latency <µs> Échec (code 2) si la latence maximale dépasse la limite\n"
+              << "  --max-miss-rate <%> Échec (code 2) si le taux de deadlines manquées la dépasse\n"
+              << "  --help, -h        Affiche cette aide\n"
+              << "\n"
+              << "EXEMPLES:\n"
+              << "  sudo " << program_name << " --period 250 --duration 60 --cpu 3\n"
+              << "  sudo " << program_name << " --period 100 --loops 100000 --prio 95\n"
+              << "  sudo " << program_name << " --cpus 2,3 --duration 60\n"
+              << "  sudo " << program_name << " --period 250 --workload memwalk:512\n"
+              << "  sudo " << program_name << " --stress --duration 300\n"
+              << "  sudo " << program_name << " --soak --stress --period 500\n"
+              << "  sudo " << program_name << " --format json --duration 60 > mesure.json\n"
+              << "  sudo " << program_name << " --duration 600 --baseline ref.trace --max-latency 100\n"
+              << "  sudo " << program_name << " --soak --prom-file /var/lib/node_exporter/rt_tuto.prom\n"
+              << "  sudo " << program_name << " --compare --stress --duration 30\n"
+              << "  sudo " << program_name << " --sweep --stress --duration 10\n"
+              << "  sudo " << program_name << " --policy deadline --workload fir --duration 60\n"
+              << "  sudo " << program_name << " --timer all --period 100 --loops 20000\n"
+              << "  sudo " << program_name << " --ipc all --cpu 2 --peer-cpu 3 --loops 10000\n"
+              << "  sudo " << program_name << " --cpu 2 --gpio 17 --gpio-input 27 --loops 10000\n"
+              << "  sudo " << program_name << " --cache-sweep --workload memwalk:256 --aggressor-cpus 0 --loops 5000\n"
+              << "  sudo " << program_name << " --task 1000:fir:256 --task 4000:matmul:16 --task 100000 --duration 10\n"
               << "\n"
               << "PRÉREQUIS:\n"
               << "  • Kernel RT installé (uname -r doit contenir 'rt' ou 'realtime')\n"
@@ -501,6 +3111,163 @@ void print_usage(const char* program_name)
               << std::endl;
 }
 
+// ============================================================================
+// ANALYSE DES ARGUMENTS
+// ============================================================================
+
+/**
+ * @brief Convertit une liste de CPUs ("2,3", "2-3" ou "0,2-3")
+ * 
+ * Même syntaxe que le paramètre kernel isolcpus.
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param max_cpu Numéro de CPU maximal accepté
+ * @param out Liste des CPUs en cas de succès
+ * @return true si la liste est valide et non vide
+ */
+bool parse_cpu_list(const std::string& option, const char* value,
+                    long max_cpu, std::vector<int>& out)
+{
+    if (value == nullptr) {
+        std::cerr << "Valeur manquante pour " << option << std::endl;
+        return false;
+    }
+    
+    out.clear();
+    const char* p = value;
+    while (*p != '\0') {
+        char* end = nullptr;
+        long first = strtol(p, &end, 10);
+        long last = first;
+        if (end == p) break;
+        if (*end == '-') {
+            const char* q = end + 1;
+            last = strtol(q, &end, 10);
+            if (end == q) break;
+        }
+        if (first < 0 || last > max_cpu || first > last) break;
+        for (long cpu = first; cpu <= last; ++cpu) {
+            out.push_back(static_cast<int>(cpu));
+        }
+        if (*end == '\0') {
+            return true;
+        }
+        if (*end != ',') break;
+        p = end + 1;
+    }
+    
+    std::cerr << "Liste de CPUs invalide pour " << option << ": " << value
+              << " (attendu: ex. 2,3 ou 2-3, CPUs 0 à " << max_cpu << ")" << std::endl;
+    out.clear();
+    return false;
+}
+
+/**
+ * @brief Convertit une tâche de l'exécutif ("période[:charge]")
+ * 
+ * Exemples : "1000:fir:256" (1 kHz, filtre FIR), "100000" (10 Hz, sans charge)
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param out Tâche convertie en cas de succès
+ * @return true si la période est valide (≥ 10 µs) et la charge reconnue
+ */
+bool parse_task_spec(const std::string& option, const char* value, RateTaskSpec& out)
+{
+    if (value == nullptr) {
+        std::cerr << "Valeur manquante pour " << option << std::endl;
+        return false;
+    }
+    
+    std::string text = value;
+    size_t colon = text.find(':');
+    std::string period = text.substr(0, colon);
+    char* end = nullptr;
+    errno = 0;
+    long parsed = strtol(period.c_str(), &end, 10);
+    bool ok = errno == 0 && !period.empty() && *end == '\0' && parsed >= 10 && parsed <= 10000000;
+    
+    out = RateTaskSpec();
+    out.period_us = static_cast<int>(parsed);
+    if (ok && colon != std::string::npos) {
+        ok = parse_workload_spec(text.substr(colon + 1), out.workload);
+    }
+    if (!ok) {
+        std::cerr << "Tâche invalide pour " << option << ": " << value
+                  << " (attendu: période en µs [10-10000000][:charge], ex. 1000:fir:256)" << std::endl;
+    }
+    return ok;
+}
+
+/**
+ * @brief Convertit un pourcentage ("0.01", "5")
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param out Pourcentage converti en cas de succès
+ * @return true si la valeur est un nombre dans [0, 100]
+ */
+bool parse_percent_option(const std::string& option, const char* value, double& out)
+{
+    if (value == nullptr) {
+        std::cerr << "Valeur manquante pour " << option << std::endl;
+        return false;
+    }
+    
+    char* end = nullptr;
+    errno = 0;
+    double parsed = strtod(value, &end);
+    
+    if (errno != 0 || end == value || *end != '\0' || !(parsed >= 0.0 && parsed <= 100.0)) {
+        std::cerr << "Valeur invalide pour " << option << ": " << value
+                  << " (attendu: pourcentage de 0 à 100)" << std::endl;
+        return false;
+    }
+    
+    out = parsed;
+    return true;
+}
+
+/**
+ * @brief Convertit une plage d'empreintes en Ko ("min-max" ou une seule taille)
+ * 
+ * Exemples : "32-65536" (32 Ko à 64 Mo), "1024" (1 Mo seulement)
+ * 
+ * @param option Nom de l'option (pour le message d'erreur)
+ * @param value Chaîne à convertir (peut être NULL si la valeur manque)
+ * @param min_kb Plus petite empreinte en cas de succès
+ * @param max_kb Plus grande empreinte en cas de succès
+ * @return true si 4 ≤ min ≤ max ≤ 1048576 Ko
+ */
+bool parse_kb_range(const std::string& option, const char* value, int& min_kb, int& max_kb)
+{
+    if (value == nullptr) {
+        std::cerr << "Valeur manquante pour " << option << std::endl;
+        return false;
+    }
+    
+    char* end = nullptr;
+    errno = 0;
+    long first = strtol(value, &end, 10);
+    long last = first;
+    bool ok = errno == 0 && end != value;
+    if (ok && *end == '-') {
+        const char* q = end + 1;
+        last = strtol(q, &end, 10);
+        ok = errno == 0 && end != q;
+    }
+    ok = ok && *end == '\0' && first >= 4 && first <= last && last <= 1048576;
+    if (!ok) {
+        std::cerr << "Plage invalide pour " << option << ": " << value
+                  << " (attendu: min-max en Ko, 4 à 1048576, ex. 32-65536)" << std::endl;
+        return false;
+    }
+    min_kb = static_cast<int>(first);
+    max_kb = static_cast<int>(last);
+    return true;
+}
+
 // ============================================================================
 // FONCTION PRINCIPALE
 // ============================================================================
@@ -513,12 +3280,267 @@ void print_usage(const char* program_name)
  */
 int main(int argc, char* argv[])
 {
+    RtConfig config;
+    int duration_s = 0;
+    bool compare = false;
+    bool sweep = false;
+    bool sweep_rr = false;
+    bool timer_all = false;
+    ClockSource clock_source = ClockSource::MONOTONIC;
+    OutputFormat format = OutputFormat::TEXT;
+    RegressionGate gate;
+    std::string analyze_path;
+    const long max_cpu = sysconf(_SC_NPROCESSORS_CONF) - 1;
+    
     // Parse des arguments
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
+        const char* value = (i + 1 < argc) ? argv[i + 1] : nullptr;
+        
         if (arg == "--help" || arg == "-h") {
             print_usage(argv[0]);
             return 0;
+        } else if (arg == "--period") {
+            if (!parse_int_option(arg, value, 1, 1000000, config.period_us)) return 1;
+            ++i;
+        } else if (arg == "--loops") {
+            if (!parse_int_option(arg, value, 1, INT_MAX, config.num_iterations)) return 1;
+            ++i;
+        } else if (arg == "--duration") {
+            if (!parse_int_option(arg, value, 1, INT_MAX, duration_s)) return 1;
+            ++i;
+        } else if (arg == "--prio") {
+            if (!parse_int_option(arg, value, 1, 99, config.priority)) return 1;
+            ++i;
+        } else if (arg == "--cpu") {
+            if (!parse_int_option(arg, value, 0, max_cpu, config.cpu)) return 1;
+            ++i;
+        } else if (arg == "--policy") {
+            std::string policy = value ? value : "";
+            if (policy == "fifo") {
+                config.policy = SCHED_FIFO;
+            } else if (policy == "rr") {
+                config.policy = SCHED_RR;
+            } else if (policy == "deadline") {
+                config.policy = SCHED_DEADLINE;
+            } else {
+                std::cerr << "Valeur invalide pour " << arg << ": " << policy
+                          << " (attendu: fifo, rr ou deadline)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--runtime") {
+            if (!parse_int_option(arg, value, 1, 1000000, config.runtime_us)) return 1;
+            ++i;
+        } else if (arg == "--deadline") {
+            if (!parse_int_option(arg, value, 1, 1000000, config.deadline_us)) return 1;
+            ++i;
+        } else if (arg == "--overrun") {
+            std::string mode = value ? value : "";
+            if (mode == "skip") {
+                config.overrun_policy = OverrunPolicy::SKIP;
+            } else if (mode == "catchup") {
+                config.overrun_policy = OverrunPolicy::CATCH_UP;
+            } else {
+                std::cerr << "Valeur invalide pour " << arg << ": " << mode
+                          << " (attendu: skip ou catchup)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--workload") {
+            if (value == nullptr || !parse_workload_spec(value, config.workload)) {
+                std::cerr << "Valeur invalide pour " << arg << ": " << (value ? value : "")
+                          << " (attendu: none, memwalk[:Ko], fir[:échantillons] ou matmul[:N])"
+                          << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--ipc") {
+            IpcPrimitive primitive;
+            if (value != nullptr && std::string(value) == "all") {
+                config.ipc.assign(std::begin(ALL_IPC_PRIMITIVES), std::end(ALL_IPC_PRIMITIVES));
+            } else if (value != nullptr && parse_ipc_primitive(value, primitive)) {
+                config.ipc.assign(1, primitive);
+            } else {
+                std::cerr << "Valeur invalide pour " << arg << ": " << (value ? value : "")
+                          << " (attendu: pi-mutex, futex, eventfd, spsc, seqlock ou all)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--peer-cpu") {
+            if (!parse_int_option(arg, value, 0, max_cpu, config.peer_cpu)) return 1;
+            ++i;
+        } else if (arg == "--peer-prio") {
+            if (!parse_int_option(arg, value, 0, 98, config.peer_priority)) return 1;
+            ++i;
+        } else if (arg == "--gpio") {
+            if (!parse_int_option(arg, value, 0, GPIO_MAX_PIN, config.gpio_pin)) return 1;
+            ++i;
+        } else if (arg == "--gpio-input") {
+            if (!parse_int_option(arg, value, 0, GPIO_MAX_PIN, config.gpio_input_pin)) return 1;
+            ++i;
+        } else if (arg == "--gpio-chip") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.gpio_chip = value;
+            ++i;
+        } else if (arg == "--soak") {
+            config.soak = true;
+        } else if (arg == "--soak-window") {
+            if (!parse_int_option(arg, value, 1, 3600, config.soak_window_s)) return 1;
+            config.soak = true;
+            ++i;
+        } else if (arg == "--cache-sweep") {
+            config.cache_sweep = true;
+        } else if (arg == "--aggressor-kb") {
+            if (!parse_kb_range(arg, value, config.aggressor_min_kb, config.aggressor_max_kb)) return 1;
+            ++i;
+        } else if (arg == "--aggressor-cpus") {
+            if (!parse_cpu_list(arg, value, max_cpu, config.aggressor_cpus)) return 1;
+            ++i;
+        } else if (arg == "--task") {
+            RateTaskSpec task;
+            if (!parse_task_spec(arg, value, task)) return 1;
+            config.tasks.push_back(task);
+            ++i;
+        } else if (arg == "--compare") {
+            compare = true;
+        } else if (arg == "--sweep") {
+            sweep = true;
+        } else if (arg == "--sweep-rr") {
+            sweep = true;
+            sweep_rr = true;
+        } else if (arg == "--timer") {
+            std::string name = value ? value : "";
+            if (name == "all") {
+                timer_all = true;
+            } else if (!parse_timer_backend(name, config.timer)) {
+                std::cerr << "Valeur invalide pour " << arg << ": " << name
+                          << " (attendu: nanosleep, timerfd, signal, hybrid, busy ou all)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--clock") {
+            std::string name = value ? value : "";
+            if (!parse_clock_source(name, clock_source)) {
+                std::cerr << "Valeur invalide pour " << arg << ": " << name
+                          << " (attendu: monotonic ou cntvct)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--format") {
+            std::string name = value ? value : "";
+            if (!parse_output_format(name, format)) {
+                std::cerr << "Valeur invalide pour " << arg << ": " << name
+                          << " (attendu: text, json ou csv)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--baseline") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            gate.baseline_path = value;
+            ++i;
+        } else if (arg == "--max-p99" || arg == "--max-latency") {
+            int limit_us = 0;
+            if (!parse_int_option(arg, value, 1, 100000000, limit_us)) return 1;
+            uint64_t& limit_ns = arg == "--max-p99" ? gate.max_p99_ns : gate.max_latency_ns;
+            limit_ns = static_cast<uint64_t>(limit_us) * 1000;
+            ++i;
+        } else if (arg == "--max-miss-rate") {
+            double percent = 0.0;
+            if (!parse_percent_option(arg, value, percent)) return 1;
+            gate.max_miss_rate = percent / 100.0;
+            ++i;
+        } else if (arg == "--prom-file") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.prom_path = value;
+            ++i;
+        } else if (arg == "--spin") {
+            if (!parse_int_option(arg, value, 1, 1000000, config.spin_us)) return 1;
+            ++i;
+        } else if (arg == "--prefault-stack") {
+            if (!parse_int_option(arg, value, 0, 65536, config.prefault_stack_kb)) return 1;
+            ++i;
+        } else if (arg == "--prefault-heap") {
+            if (!parse_int_option(arg, value, 0, 1048576, config.prefault_heap_kb)) return 1;
+            ++i;
+        } else if (arg == "--break-on") {
+            if (!parse_int_option(arg, value, 1, 10000000, config.break_on_us)) return 1;
+            ++i;
+        } else if (arg == "--break-events") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.break_events = value;
+            ++i;
+        } else if (arg == "--break-file") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.break_file = value;
+            ++i;
+        } else if (arg == "--subtract-overhead") {
+            config.subtract_overhead = true;
+        } else if (arg == "--pmu") {
+            config.measure_pmu = true;
+        } else if (arg == "--memory-guard") {
+            std::string mode = value ? value : "";
+            if (mode == "abort") {
+                rt_memory_guard_abort = true;
+            } else if (mode != "count") {
+                std::cerr << "Valeur invalide pour " << arg << ": " << mode
+                          << " (attendu: count ou abort)" << std::endl;
+                return 1;
+            }
+            ++i;
+        } else if (arg == "--stress") {
+            config.stress = true;
+        } else if (arg == "--stress-cpus") {
+            if (!parse_cpu_list(arg, value, max_cpu, config.stress_cpus)) return 1;
+            config.stress = true;
+            ++i;
+        } else if (arg == "--stress-dir") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.stress_dir = value;
+            config.stress = true;
+            ++i;
+        } else if (arg == "--report-cpu") {
+            if (!parse_int_option(arg, value, 0, max_cpu, config.report_cpu)) return 1;
+            ++i;
+        } else if (arg == "--log") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            config.log_path = value;
+            ++i;
+        } else if (arg == "--trace" || arg == "--analyze") {
+            if (value == nullptr) {
+                std::cerr << "Valeur manquante pour " << arg << std::endl;
+                return 1;
+            }
+            if (arg == "--trace") {
+                config.trace_path = value;
+            } else {
+                analyze_path = value;
+            }
+            ++i;
+        } else if (arg == "--cpus") {
+            if (!parse_cpu_list(arg, value, max_cpu, config.cpus)) return 1;
+            ++i;
         } else {
             std::cerr << "Option inconnue: " << arg << std::endl;
             print_usage(argv[0]);
@@ -526,6 +3548,209 @@ int main(int argc, char* argv[])
         }
     }
     
+    /*
+     * --format json|csv : la sortie standard ne reçoit que les résultats ;
+     * tout l'affichage humain (progression, tableaux) part sur la sortie
+     * d'erreur, toujours visible dans le terminal.
+     */
+    std::streambuf* results_buffer = std::cout.rdbuf();
+    std::ostream results_out(results_buffer);
+    if (format != OutputFormat::TEXT) {
+        std::cout.rdbuf(std::cerr.rdbuf());
+    }
+    
+    // Référence chargée avant la mesure : une trace illisible échoue tout de suite
+    std::unique_ptr<LatencyHistogram> baseline;
+    if (!gate.baseline_path.empty()) {
+        baseline.reset(new LatencyHistogram());
+        std::string error;
+        if (!load_baseline_histogram(gate.baseline_path, *baseline, error)) {
+            std::cerr << COLOR_RED << "✗ Lecture de la référence " << gate.baseline_path
+                      << " impossible : " << error << COLOR_RESET << std::endl;
+            return 1;
+        }
+    }
+    
+    // Mode analyse : relecture d'une trace, aucune configuration temps réel
+    if (!analyze_path.empty()) {
+        return analyze_trace(analyze_path, format, results_out, gate, baseline.get());
+    }
+    
+    if ((format != OutputFormat::TEXT || !config.prom_path.empty())
+        && (sweep || timer_all || !config.tasks.empty() || !config.ipc.empty() || config.cache_sweep)) {
+        std::cerr << "--format et --prom-file exportent une mesure de latence : incompatibles avec"
+                  << " --sweep, --timer all, --task, --ipc et --cache-sweep" << std::endl;
+        return 1;
+    }
+    if (gate.enabled()
+        && (sweep || timer_all || !config.tasks.empty() || !config.ipc.empty() || config.cache_sweep)) {
+        std::cerr << "--baseline et --max-* jugent une mesure de latence : incompatibles avec"
+                  << " --sweep, --timer all, --task, --ipc et --cache-sweep" << std::endl;
+        return 1;
+    }
+    if (config.measure_pmu
+        && (sweep || timer_all || !config.tasks.empty() || !config.ipc.empty() || config.cache_sweep)) {
+        std::cerr << "--pmu corrèle les compteurs aux latences d'une mesure : incompatible avec"
+                  << " --sweep, --timer all, --task, --ipc et --cache-sweep" << std::endl;
+        return 1;
+    }
+    if (config.gpio_pin >= 0
+        && (compare || sweep || timer_all || !config.cpus.empty() || !config.tasks.empty()
+            || !config.ipc.empty() || config.cache_sweep)) {
+        std::cerr << "--gpio suit la boucle d'un seul thread de mesure : incompatible avec --compare,"
+                  << " --sweep, --timer all, --cpus, --task, --ipc et --cache-sweep" << std::endl;
+        return 1;
+    }
+    if (config.gpio_input_pin >= 0) {
+        if (config.gpio_pin < 0 || config.gpio_input_pin == config.gpio_pin) {
+            std::cerr << "--gpio-input mesure un aller-retour : il faut aussi --gpio <n>, sur une"
+                      << " autre broche reliée à l'entrée" << std::endl;
+            return 1;
+        }
+        if (config.soak || config.break_on_us > 0 || config.measure_pmu
+            || config.workload.type != WorkloadType::NONE
+            || !config.log_path.empty() || !config.trace_path.empty()
+            || format != OutputFormat::TEXT || !config.prom_path.empty() || gate.enabled()) {
+            std::cerr << "--gpio-input est un banc d'essai autonome : incompatible avec --soak,"
+                      << " --break-on, --pmu, --workload, --log, --trace, --format, --prom-file,"
+                      << " --baseline et --max-*" << std::endl;
+            return 1;
+        }
+    }
+    if (!config.prom_path.empty() && !config.cpus.empty()) {
+        std::cerr << "--prom-file est alimenté par le thread de rapport du mode mono-thread :"
+                  << " incompatible avec --cpus" << std::endl;
+        return 1;
+    }
+    
+    if ((compare || sweep) && !config.cpus.empty()) {
+        std::cerr << (compare ? "--compare" : "--sweep")
+                  << " mesure un seul thread : incompatible avec --cpus" << std::endl;
+        return 1;
+    }
+    if (config.policy == SCHED_DEADLINE && !config.cpus.empty()) {
+        std::cerr << "--policy deadline est incompatible avec --cpus"
+                  << " (affinité par thread impossible en SCHED_DEADLINE)" << std::endl;
+        return 1;
+    }
+    if (config.policy == SCHED_DEADLINE && (timer_all || config.timer != TimerBackend::NANOSLEEP)) {
+        std::cerr << "--timer est sans effet en SCHED_DEADLINE (réveil par le kernel après sched_yield)"
+                  << std::endl;
+        return 1;
+    }
+    if (config.break_on_us > 0 && (timer_all || compare || sweep || !config.cpus.empty())) {
+        std::cerr << "--break-on n'est disponible qu'en mesure mono-thread simple" << std::endl;
+        return 1;
+    }
+    if (timer_all && (compare || sweep || !config.cpus.empty())) {
+        std::cerr << "--timer all est incompatible avec --compare, --sweep et --cpus" << std::endl;
+        return 1;
+    }
+    if (!config.ipc.empty()
+        && (compare || sweep || timer_all || !config.cpus.empty() || config.break_on_us > 0
+            || !config.tasks.empty() || config.policy == SCHED_DEADLINE
+            || config.workload.type != WorkloadType::NONE
+            || !config.log_path.empty() || !config.trace_path.empty())) {
+        std::cerr << "--ipc est un banc d'essai autonome : incompatible avec --compare, --sweep,"
+                  << " --timer all, --cpus, --break-on, --task, --policy deadline, --workload,"
+                  << " --log et --trace" << std::endl;
+        return 1;
+    }
+    if (config.soak
+        && (compare || sweep || timer_all || !config.cpus.empty() || !config.tasks.empty()
+            || !config.ipc.empty() || config.cache_sweep
+            || !config.log_path.empty() || !config.trace_path.empty())) {
+        std::cerr << "--soak mesure un seul thread à mémoire constante : incompatible avec --compare,"
+                  << " --sweep, --timer all, --cpus, --task, --ipc, --cache-sweep, --log et --trace"
+                  << std::endl;
+        return 1;
+    }
+    if (config.cache_sweep) {
+        if (compare || sweep || timer_all || !config.cpus.empty() || config.break_on_us > 0
+            || !config.tasks.empty() || !config.ipc.empty()
+            || !config.log_path.empty() || !config.trace_path.empty()) {
+            std::cerr << "--cache-sweep enchaîne ses propres passes : incompatible avec --compare,"
+                      << " --sweep, --timer all, --cpus, --break-on, --task, --ipc, --log et --trace"
+                      << std::endl;
+            return 1;
+        }
+        // Ensemble de travail fixe côté RT : parcours mémoire par défaut
+        if (config.workload.type == WorkloadType::NONE) {
+            config.workload.type = WorkloadType::MEMWALK;
+        }
+        if (config.aggressor_cpus.empty()) {
+            config.aggressor_cpus.push_back(config.report_cpu);
+        }
+    }
+    if (!config.tasks.empty()) {
+        if (compare || sweep || timer_all || !config.cpus.empty() || config.break_on_us > 0
+            || config.policy == SCHED_DEADLINE) {
+            std::cerr << "--task est incompatible avec --compare, --sweep, --timer all, --cpus,"
+                      << " --break-on et --policy deadline" << std::endl;
+            return 1;
+        }
+        if (config.workload.type != WorkloadType::NONE || !config.log_path.empty()
+            || !config.trace_path.empty()) {
+            std::cerr << "--task : la charge se donne par tâche (--task période:charge) ;"
+                      << " --workload, --log et --trace sont sans effet" << std::endl;
+            return 1;
+        }
+        // Trame de base = plus petite période (--period est remplacé)
+        config.period_us = config.tasks.front().period_us;
+        for (const RateTaskSpec& task : config.tasks) {
+            config.period_us = std::min(config.period_us, task.period_us);
+        }
+    }
+    if (compare && sweep) {
+        std::cerr << "--compare et --sweep sont incompatibles (--sweep inclut déjà les deux cas)"
+                  << std::endl;
+        return 1;
+    }
+    
+    // --duration est prioritaire sur --loops : conversion en nombre de cycles
+    if (duration_s > 0) {
+        uint64_t loops = static_cast<uint64_t>(duration_s) * UINT64_C(1000000)
+                       / static_cast<uint64_t>(config.period_us);
+        if (loops == 0 || loops > static_cast<uint64_t>(INT_MAX)) {
+            std::cerr << "Durée invalide pour la période choisie" << std::endl;
+            return 1;
+        }
+        config.num_iterations = static_cast<int>(loops);
+    } else if (config.soak) {
+        // --soak sans --duration : jusqu'à SIGINT / SIGTERM
+        config.num_iterations = 0;
+    }
+    
+    // SCHED_DEADLINE : runtime ≤ deadline ≤ période, budget estimé si absent
+    if (config.policy == SCHED_DEADLINE) {
+        if (config.deadline_ns() > static_cast<uint64_t>(config.period_us) * 1000) {
+            std::cerr << "--deadline doit être ≤ --period en SCHED_DEADLINE" << std::endl;
+            return 1;
+        }
+        if (config.runtime_us == 0) {
+            config.runtime_us = estimate_deadline_runtime_us(config);
+        } else if (static_cast<uint64_t>(config.runtime_us) * 1000 > config.deadline_ns()) {
+            std::cerr << "--runtime doit être ≤ à la deadline (" << config.deadline_ns() / 1000
+                      << " µs)" << std::endl;
+            return 1;
+        }
+    }
+    
+    // Charge de fond : par défaut sur les CPUs non isolés 0 et 1 (s'ils existent)
+    if (config.stress && config.stress_cpus.empty()) {
+        for (int cpu = 0; cpu <= std::min(1L, max_cpu); ++cpu) {
+            config.stress_cpus.push_back(cpu);
+        }
+    }
+    
+    // Calibration de l'horloge de mesure, une fois pour tous les threads
+    if (!config.clock.init(clock_source)) {
+        std::cerr << "--clock " << clock_source_name(clock_source)
+                  << " n'est disponible que dans les builds Raspberry Pi 4 (TARGET_RPI4, aarch64)"
+                  << std::endl;
+        return 1;
+    }
+    
     // En-tête
     std::cout << COLOR_CYAN
               << "\n╔══════════════════════════════════════════════════════════════╗\n"
@@ -536,22 +3761,190 @@ int main(int argc, char* argv[])
     // Informations système
     std::cout << "\nInformations système :" << std::endl;
     std::cout << "  • CPUs disponibles : " << sysconf(_SC_NPROCESSORS_ONLN) << std::endl;
-    std::cout << "  • Période de test  : " << PERIOD_US << " µs" << std::endl;
-    std::cout << "  • Itérations       : " << NUM_ITERATIONS << std::endl;
+    std::cout << "  • Période de test  : " << config.period_us << " µs" << std::endl;
+    if (config.num_iterations > 0) {
+        std::cout << "  • Itérations       : " << config.num_iterations << std::endl;
+    } else {
+        std::cout << "  • Itérations       : sans limite (--soak)" << std::endl;
+    }
+    if (config.policy == SCHED_DEADLINE) {
+        std::cout << "  • Ordonnancement   : SCHED_DEADLINE (runtime " << config.runtime_us << " µs)" << std::endl;
+    } else {
+        std::cout << "  • Priorité RT      : " << config.priority << " (" << policy_name(config.policy) << ")" << std::endl;
+    }
+    std::cout << "  • Charge par cycle : " << workload_name(config.workload.type) << std::endl;
+    if (config.cpus.empty()) {
+        std::cout << "  • CPU cible        : " << config.cpu << std::endl;
+    } else {
+        std::cout << "  • CPUs (1 thread/CPU):";
+        for (int cpu : config.cpus) {
+            std::cout << " " << cpu;
+        }
+        std::cout << std::endl;
+    }
     
-    // Configuration temps réel
-    if (!configure_realtime()) {
-        std::cerr << "\n" << COLOR_RED 
-                  << "✗ Échec de la configuration temps réel" 
-                  << COLOR_RESET << std::endl;
+    /*
+     * Instantané de la configuration système des CPUs mesurés : affiché et
+     * validé ici, puis recopié dans le journal et la trace binaire pour que
+     * chaque résultat garde la trace de la machine qui l'a produit.
+     */
+    std::vector<int> target_cpus = config.cpus.empty() ? std::vector<int>{config.cpu} : config.cpus;
+    SystemSnapshot snapshot = capture_system_snapshot(target_cpus);
+    config.system_snapshot = snapshot_to_text(snapshot);
+    print_environment_check(snapshot, validate_snapshot(snapshot, config.priority));
+    
+    // malloc réglé pour le temps réel, puis réserve de tas pré-chargée : elle
+    // sera verrouillée par mlockall(MCL_CURRENT) et ne sera jamais rendue
+    configure_malloc_for_rt();
+    prefault_heap(static_cast<size_t>(config.prefault_heap_kb) * 1024);
+    
+    // Charge de fond démarrée avant la configuration RT : ses tampons sont
+    // alloués pendant que le processus est encore SCHED_OTHER
+    StressGenerator stress;
+    if (config.stress && !start_stress(stress, config)) {
         return 1;
     }
     
-    // Exécution de la tâche périodique
-    std::vector<uint64_t> latencies = run_periodic_task();
-    
-    // Affichage des résultats
-    display_results(latencies);
+    bool gate_passed = true;
+    if (!config.ipc.empty()) {
+        // Banc de messagerie : le thread courant est le thread RT émetteur
+        bool ok = configure_realtime(config);
+        if (ok) {
+            ok = run_ipc_benchmark(config);
+        }
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec du banc de messagerie" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+    } else if (config.gpio_input_pin >= 0) {
+        // Aller-retour GPIO : le thread courant pilote la sortie et attend l'entrée
+        bool ok = configure_realtime(config);
+        if (ok) {
+            ok = run_gpio_roundtrip(config);
+        }
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de la mesure d'aller-retour GPIO" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+    } else if (config.cache_sweep) {
+        // Balayage de l'agresseur : le thread courant exécute la charge RT
+        bool ok = configure_realtime(config);
+        if (ok) {
+            ok = run_cache_sweep(config);
+        }
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec du balayage d'interférence de cache" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+    } else if (!config.tasks.empty()) {
+        // Exécutif multi-cadences : toutes les tâches sur le thread courant
+        bool ok = configure_realtime(config);
+        if (ok) {
+            ok = run_executive(config);
+        }
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de l'exécutif multi-cadences" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+    } else if (timer_all) {
+        // Comparatif des mécanismes de réveil, sous la configuration RT complète
+        bool ok = configure_realtime(config);
+        if (ok) {
+            run_timer_comparison(config);
+        }
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de la configuration temps réel" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+    } else if (sweep) {
+        // Mode balayage : chaque réglage RT isolé, puis la matrice de résultats
+        std::vector<SweepCase> cases;
+        bool ok = run_sweep(config, sweep_rr, cases);
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec du balayage (exécuter avec sudo)" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+        
+        print_sweep_matrix(cases);
+    } else if (compare) {
+        // Mode comparaison : même tâche sans puis avec la configuration RT
+        TaskResults no_rt;
+        TaskResults rt;
+        bool ok = run_comparison(config, no_rt, rt);
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de la configuration temps réel" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+        
+        display_results(rt);
+        print_comparison_table(&no_rt.histogram, &rt.histogram);
+        write_machine_results(results_out, format, make_export_info(config),
+                              {ExportRun{"no_rt", &no_rt}, ExportRun{"rt", &rt}});
+        gate_passed = check_regression_gate(gate, baseline.get(), rt.histogram);
+    } else if (!config.cpus.empty()) {
+        // Mode multi-threads : un thread SCHED_FIFO par CPU listé
+        TaskResults aggregate;
+        aggregate.histogram.set_deadline_ns(config.deadline_ns());
+        bool ok = run_multi_threaded(config, aggregate);
+        stop_stress(stress);
+        if (!ok) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de l'exécution multi-threads" 
+                      << COLOR_RESET << std::endl;
+            munlockall();
+            return 1;
+        }
+        
+        // Résultats agrégés de tous les threads
+        display_results(aggregate);
+        write_machine_results(results_out, format, make_export_info(config),
+                              {ExportRun{"aggregate", &aggregate}});
+        gate_passed = check_regression_gate(gate, baseline.get(), aggregate.histogram);
+    } else {
+        // --soak : Ctrl-C / SIGTERM terminent la mesure au lieu du processus
+        if (config.soak && !install_stop_handlers()) {
+            std::cerr << COLOR_YELLOW << "⚠ sigaction : " << strerror(errno)
+                      << " (arrêt propre indisponible)" << COLOR_RESET << std::endl;
+        }
+        
+        // Configuration temps réel
+        if (!configure_realtime(config)) {
+            std::cerr << "\n" << COLOR_RED 
+                      << "✗ Échec de la configuration temps réel" 
+                      << COLOR_RESET << std::endl;
+            return 1;
+        }
+        
+        // Exécution de la tâche périodique
+        TaskResults results = run_periodic_task(config);
+        stop_stress(stress);
+        
+        // Affichage des résultats
+        display_results(results);
+        write_machine_results(results_out, format, make_export_info(config), {ExportRun{"rt", &results}});
+        gate_passed = check_regression_gate(gate, baseline.get(), results.histogram);
+    }
     
     // Nettoyage
     struct sched_param param;
@@ -570,5 +3963,6 @@ int main(int argc, char* argv[])
     std::cout << "Pour des tests de performance réels et stress tests, utilisez :" << std::endl;
     std::cout << "  sudo cyclictest -t1 -p 80 -a 2 -m -i 1000 -l 3600000\n" << std::endl;
     
-    return 0;
+    std::cout.rdbuf(results_buffer);
+    return gate_passed ? 0 : EXIT_REGRESSION;
 }
@@ -7,7 +7,10 @@
  * 
  * Ce fichier contient des fonctions et structures utilitaires pour :
  * - Manipulation des structures timespec
- * - Calcul de statistiques sur les latences
+ * - Calcul de statistiques sur les latences (accumulateur de Welford en O(1))
+ * - Comptage des dépassements de période (overruns)
+ * - Histogramme log-linéaire à mémoire constante (enregistrement en O(1))
+ * - File SPSC sans verrou pour sortir les échantillons du thread temps réel
  * - Affichage d'histogrammes
  * - Codes couleur pour le terminal
  */
@@ -16,10 +19,13 @@
 #define RT_UTILS_H
 
 #include <stdint.h>
+#include <stddef.h>
 #include <time.h>
 #include <vector>
+#include <atomic>
 #include <cmath>
 #include <algorithm>
+#include <iterator>
 #include <iostream>
 #include <iomanip>
 
@@ -88,6 +94,32 @@ inline uint64_t timespec_diff_ns(const struct timespec& start, const struct time
     return (end_ns > start_ns) ? (end_ns - start_ns) : 0;
 }
 
+/**
+ * @brief Convertit un timespec en nanosecondes
+ * 
+ * @param ts Instant à convertir
+ * @return Nombre de nanosecondes depuis l'origine de l'horloge
+ */
+inline uint64_t timespec_to_ns(const struct timespec& ts)
+{
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ULL
+         + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+/**
+ * @brief Convertit des nanosecondes en timespec (inverse de timespec_to_ns)
+ * 
+ * @param ns Nombre de nanosecondes depuis l'origine de l'horloge
+ * @return Instant correspondant
+ */
+inline struct timespec ns_to_timespec(uint64_t ns)
+{
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(ns / 1000000000ULL);
+    ts.tv_nsec = static_cast<long>(ns % 1000000000ULL);
+    return ts;
+}
+
 /**
  * @brief Ajoute des microsecondes à un timespec
  * 
@@ -132,6 +164,566 @@ struct LatencyStats {
     double stddev_ns;   ///< Écart-type en nanosecondes
 };
 
+/**
+ * @brief Percentiles usuels de la distribution des latences
+ * 
+ * Complète LatencyStats : le maximum seul dépend d'un unique échantillon,
+ * les percentiles élevés (99.9, 99.99) décrivent la "queue" de distribution
+ * de façon plus robuste.
+ */
+struct LatencyPercentiles {
+    uint64_t p50_ns;    ///< Médiane
+    uint64_t p90_ns;    ///< 90e percentile
+    uint64_t p99_ns;    ///< 99e percentile
+    uint64_t p999_ns;   ///< 99.9e percentile
+    uint64_t p9999_ns;  ///< 99.99e percentile
+};
+
+/// Percentiles calculés pour LatencyPercentiles, dans l'ordre des champs
+constexpr double STANDARD_PERCENTILES[] = {50.0, 90.0, 99.0, 99.9, 99.99};
+
+/**
+ * @brief Rang (1..N) de l'échantillon qui donne un percentile
+ * 
+ * Définition « nearest-rank », commune aux deux calculs de percentiles
+ * (histogramme et vecteur) : le p-ième percentile est le plus petit
+ * échantillon dont au moins p % des échantillons sont inférieurs ou égaux,
+ * soit le rang ceil(p / 100 × N) dans l'ordre croissant. Exemple : sur
+ * 1000 échantillons, p99.9 est le 999e et p100 le maximum.
+ * 
+ * Le produit p × N est formé avant la division, et la tolérance relative
+ * absorbe l'arrondi restant : 99.9 / 100 × 1000 vaut 999.0000000000001 en
+ * double et donnerait le rang 1000.
+ * 
+ * @param percentile Percentile (0-100, borné)
+ * @param count Nombre d'échantillons (> 0)
+ */
+inline uint64_t percentile_rank(double percentile, uint64_t count)
+{
+    const double p = std::max(0.0, std::min(percentile, 100.0));
+    const double exact = p * static_cast<double>(count) / 100.0;
+    const double rank_d = std::ceil(exact - exact * 1e-12);
+    uint64_t rank = (rank_d < 1.0) ? 1 : static_cast<uint64_t>(rank_d);
+    return std::min(rank, count);
+}
+
+// ============================================================================
+// ACCUMULATEUR STATISTIQUE EN LIGNE (WELFORD)
+// ============================================================================
+
+/**
+ * @brief Statistiques mises à jour échantillon par échantillon en O(1)
+ * 
+ * Min, max, moyenne et variance sont disponibles à tout instant, sans
+ * conserver les échantillons ni repasser sur un tampon de plusieurs millions
+ * de valeurs en fin de test.
+ * 
+ * ALGORITHME DE WELFORD :
+ * La formule naïve Var = E[X²] - E[X]² soustrait deux grands nombres voisins
+ * et perd toute précision. Welford met à jour la moyenne µ et la somme des
+ * carrés des écarts M2 de façon numériquement stable :
+ * @code
+ *   n  = n + 1
+ *   δ  = x - µ
+ *   µ  = µ + δ / n
+ *   M2 = M2 + δ × (x - µ)        variance = M2 / n
+ * @endcode
+ * 
+ * L'accumulateur compte aussi les DEADLINES MANQUÉES : échantillons
+ * strictement supérieurs à deadline_ns (0 = pas de deadline).
+ */
+class RunningStats {
+public:
+    /**
+     * @param deadline_ns Seuil au-delà duquel un échantillon est une deadline
+     *                    manquée (0 = pas de comptage)
+     */
+    explicit RunningStats(uint64_t deadline_ns = 0) : deadline_ns_(deadline_ns) {}
+    
+    /**
+     * @brief Ajoute un échantillon - O(1), sans allocation
+     */
+    void add(uint64_t value_ns)
+    {
+        count_++;
+        if (value_ns < min_ns_) min_ns_ = value_ns;
+        if (value_ns > max_ns_) max_ns_ = value_ns;
+        if (deadline_ns_ != 0 && value_ns > deadline_ns_) deadline_misses_++;
+        
+        const double x = static_cast<double>(value_ns);
+        const double delta = x - mean_;
+        mean_ += delta / static_cast<double>(count_);
+        m2_ += delta * (x - mean_);
+    }
+    
+    /**
+     * @brief Fusionne un autre accumulateur (formule de Chan et al.)
+     * 
+     * Permet d'agréger des statistiques de plusieurs threads ou fenêtres
+     * sans revenir aux échantillons.
+     */
+    void merge(const RunningStats& other)
+    {
+        if (other.count_ == 0) return;
+        if (count_ == 0) {
+            uint64_t deadline = deadline_ns_;
+            *this = other;
+            deadline_ns_ = deadline != 0 ? deadline : other.deadline_ns_;
+            return;
+        }
+        
+        const double n_a = static_cast<double>(count_);
+        const double n_b = static_cast<double>(other.count_);
+        const double delta = other.mean_ - mean_;
+        const double n = n_a + n_b;
+        
+        mean_ += delta * n_b / n;
+        m2_ += other.m2_ + delta * delta * n_a * n_b / n;
+        count_ += other.count_;
+        deadline_misses_ += other.deadline_misses_;
+        if (other.min_ns_ < min_ns_) min_ns_ = other.min_ns_;
+        if (other.max_ns_ > max_ns_) max_ns_ = other.max_ns_;
+    }
+    
+    /// Remet à zéro (la deadline est conservée)
+    void reset()
+    {
+        *this = RunningStats(deadline_ns_);
+    }
+    
+    /// Change la deadline (à faire avant le premier échantillon)
+    void set_deadline_ns(uint64_t deadline_ns) { deadline_ns_ = deadline_ns; }
+    
+    uint64_t count() const { return count_; }                          ///< Nombre d'échantillons
+    uint64_t min_ns() const { return count_ == 0 ? 0 : min_ns_; }      ///< Minimum exact
+    uint64_t max_ns() const { return max_ns_; }                        ///< Maximum exact
+    double mean_ns() const { return mean_; }                           ///< Moyenne
+    double variance_ns2() const { return count_ == 0 ? 0.0 : m2_ / static_cast<double>(count_); }  ///< Variance (population)
+    double stddev_ns() const { return std::sqrt(variance_ns2()); }     ///< Écart-type
+    uint64_t deadline_ns() const { return deadline_ns_; }              ///< Deadline (0 = aucune)
+    uint64_t deadline_misses() const { return deadline_misses_; }      ///< Deadlines manquées
+    
+    /// Taux de deadlines manquées (0.0 - 1.0)
+    double deadline_miss_rate() const
+    {
+        return count_ == 0 ? 0.0
+                           : static_cast<double>(deadline_misses_) / static_cast<double>(count_);
+    }
+    
+    /// Conversion vers la structure LatencyStats
+    LatencyStats to_latency_stats() const
+    {
+        LatencyStats stats = {min_ns(), max_ns_, mean_, stddev_ns()};
+        return stats;
+    }
+    
+private:
+    uint64_t count_ = 0;
+    uint64_t min_ns_ = UINT64_MAX;
+    uint64_t max_ns_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;
+    uint64_t deadline_ns_ = 0;
+    uint64_t deadline_misses_ = 0;
+};
+
+// ============================================================================
+// COMPTAGE DES DÉPASSEMENTS DE PÉRIODE (OVERRUNS)
+// ============================================================================
+
+/**
+ * @brief Comptabilité des cycles qui dépassent leur période
+ * 
+ * Un cycle est en DÉPASSEMENT (overrun) lorsqu'il se termine après l'instant
+ * de réveil prévu pour le cycle suivant : cette échéance est déjà passée,
+ * et clock_nanosleep(TIMER_ABSTIME) retournerait immédiatement.
+ * 
+ * Pour une boucle de contrôle, le taux de dépassement est souvent LA
+ * métrique qui compte : une commande calculée trop tard est perdue.
+ * 
+ * - overruns       : cycles en dépassement
+ * - missed_periods : échéances de réveil déjà passées à la fin d'un cycle
+ * - longest_streak : plus longue série de cycles consécutifs en dépassement
+ * - max_overrun_ns : plus grand retard sur l'échéance suivante
+ */
+class OverrunStats {
+public:
+    /// Cycle terminé avant l'échéance suivante
+    void record_on_time()
+    {
+        cycles_++;
+        current_streak_ = 0;
+    }
+    
+    /**
+     * @brief Cycle terminé après l'échéance suivante - O(1)
+     * 
+     * @param overrun_ns Retard sur l'échéance suivante (ns)
+     * @param missed Nombre d'échéances déjà passées (>= 1)
+     */
+    void record_overrun(uint64_t overrun_ns, uint64_t missed)
+    {
+        cycles_++;
+        overruns_++;
+        missed_periods_ += missed;
+        current_streak_++;
+        if (current_streak_ > longest_streak_) longest_streak_ = current_streak_;
+        if (overrun_ns > max_overrun_ns_) max_overrun_ns_ = overrun_ns;
+    }
+    
+    /// Agrège les compteurs d'un autre thread
+    void merge(const OverrunStats& other)
+    {
+        cycles_ += other.cycles_;
+        overruns_ += other.overruns_;
+        missed_periods_ += other.missed_periods_;
+        longest_streak_ = std::max(longest_streak_, other.longest_streak_);
+        max_overrun_ns_ = std::max(max_overrun_ns_, other.max_overrun_ns_);
+    }
+    
+    uint64_t cycles() const { return cycles_; }                  ///< Cycles observés
+    uint64_t overruns() const { return overruns_; }              ///< Cycles en dépassement
+    uint64_t missed_periods() const { return missed_periods_; }  ///< Échéances manquées
+    uint64_t longest_streak() const { return longest_streak_; }  ///< Plus longue série
+    uint64_t max_overrun_ns() const { return max_overrun_ns_; }  ///< Plus grand retard
+    
+    /// Taux de cycles en dépassement (0.0 - 1.0)
+    double overrun_rate() const
+    {
+        return cycles_ == 0 ? 0.0
+                            : static_cast<double>(overruns_) / static_cast<double>(cycles_);
+    }
+    
+private:
+    uint64_t cycles_ = 0;
+    uint64_t overruns_ = 0;
+    uint64_t missed_periods_ = 0;
+    uint64_t longest_streak_ = 0;
+    uint64_t current_streak_ = 0;
+    uint64_t max_overrun_ns_ = 0;
+};
+
+// ============================================================================
+// HISTOGRAMME DE LATENCE À MÉMOIRE CONSTANTE
+// ============================================================================
+
+/**
+ * @brief Histogramme log-linéaire (type HDR) des latences en nanosecondes
+ * 
+ * Stocker chaque échantillon dans un std::vector coûte 8 octets par cycle :
+ * ~29 Mo pour une heure à 1 kHz, et le tampon ne peut pas être pré-alloué
+ * pour un test de durée illimitée. Cet histogramme occupe une taille FIXE
+ * (allouée une seule fois à la construction) quelle que soit la durée du test.
+ * 
+ * PRINCIPE (log-linéaire) :
+ * - Les valeurs < SUB_BUCKET_COUNT ns sont comptées exactement (1 ns par case).
+ * - Au-delà, chaque puissance de deux [2^k, 2^(k+1)[ est découpée en
+ *   SUB_BUCKET_COUNT cases linéaires de largeur 2^(k - SUB_BUCKET_BITS).
+ * 
+ * L'erreur relative est donc bornée par 1 / SUB_BUCKET_COUNT (< 0,8 % ici)
+ * sur toute la plage, de la nanoseconde jusqu'à ~18 minutes.
+ * 
+ * PROPRIÉTÉS TEMPS RÉEL :
+ * - record() : O(1), sans allocation, sans appel système
+ * - min, max, moyenne, écart-type et deadlines manquées sont EXACTS
+ *   (RunningStats mis à jour à chaque échantillon)
+ * - Percentiles et histogramme affiché : précision de la case
+ * 
+ * @note Les valeurs au-delà de la plage sont comptées dans la dernière case,
+ *       mais max_ns() reste exact.
+ */
+class LatencyHistogram {
+public:
+    /// Nombre de bits de résolution linéaire par puissance de deux
+    static constexpr unsigned SUB_BUCKET_BITS = 7;
+    
+    /// Nombre de cases linéaires (128)
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    
+    /// Plage couverte : [0, 2^MAX_VALUE_BITS[ ns (~1100 s)
+    static constexpr unsigned MAX_VALUE_BITS = 40;
+    
+    /// Nombre total de cases (taille fixe, ~35 Ko)
+    static constexpr size_t BUCKET_COUNT =
+        (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+    
+    /**
+     * @brief Construit un histogramme vide
+     * 
+     * L'allocation (et la mise à zéro, qui touche toutes les pages) a lieu ici,
+     * AVANT la boucle temps réel.
+     */
+    explicit LatencyHistogram(uint64_t deadline_ns = 0)
+        : counts_(BUCKET_COUNT, 0), stats_(deadline_ns) {}
+    
+    /**
+     * @brief Enregistre une latence - O(1), sans allocation
+     * 
+     * @param value_ns Latence en nanosecondes
+     */
+    void record(uint64_t value_ns)
+    {
+        counts_[bucket_index(value_ns)]++;
+        stats_.add(value_ns);
+    }
+    
+    /**
+     * @brief Ajoute le contenu d'un autre histogramme (agrégation multi-threads)
+     */
+    void merge(const LatencyHistogram& other)
+    {
+        for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+            counts_[i] += other.counts_[i];
+        }
+        stats_.merge(other.stats_);
+    }
+    
+    /**
+     * @brief Remet l'histogramme à zéro sans libérer la mémoire
+     */
+    void reset()
+    {
+        std::fill(counts_.begin(), counts_.end(), 0);
+        stats_.reset();
+    }
+    
+    /// Seuil de comptage des deadlines manquées (avant le premier échantillon)
+    void set_deadline_ns(uint64_t deadline_ns) { stats_.set_deadline_ns(deadline_ns); }
+    
+    uint64_t count() const { return stats_.count(); }       ///< Nombre d'échantillons
+    bool empty() const { return stats_.count() == 0; }      ///< Aucun échantillon ?
+    uint64_t min_ns() const { return stats_.min_ns(); }     ///< Minimum exact
+    uint64_t max_ns() const { return stats_.max_ns(); }     ///< Maximum exact
+    const RunningStats& stats() const { return stats_; }    ///< Statistiques exactes
+    
+    /// Nombre d'échantillons dans la case d'indice index
+    uint64_t bucket_count_at(size_t index) const { return counts_[index]; }
+    
+    /**
+     * @brief Indice de la case contenant une valeur
+     * 
+     * Exemple avec SUB_BUCKET_BITS = 7 :
+     * - 100 ns    → case 100 (exacte)
+     * - 20 000 ns → msb = 14, case de largeur 2^(14-7) = 128 ns
+     */
+    static size_t bucket_index(uint64_t value_ns)
+    {
+        if (value_ns < SUB_BUCKET_COUNT) {
+            return static_cast<size_t>(value_ns);
+        }
+        if (value_ns >> MAX_VALUE_BITS) {
+            return BUCKET_COUNT - 1;
+        }
+        
+        // Position du bit de poids fort (>= SUB_BUCKET_BITS ici)
+        unsigned msb = 63u - static_cast<unsigned>(__builtin_clzll(value_ns));
+        unsigned shift = msb - SUB_BUCKET_BITS;
+        size_t sub = static_cast<size_t>(value_ns >> shift) & (SUB_BUCKET_COUNT - 1);
+        
+        return static_cast<size_t>(shift + 1) * SUB_BUCKET_COUNT + sub;
+    }
+    
+    /// Plus petite valeur (ns) contenue dans la case index
+    static uint64_t bucket_lower_bound(size_t index)
+    {
+        if (index < SUB_BUCKET_COUNT) {
+            return static_cast<uint64_t>(index);
+        }
+        size_t group = index / SUB_BUCKET_COUNT;   // >= 1
+        size_t sub = index % SUB_BUCKET_COUNT;
+        return static_cast<uint64_t>(SUB_BUCKET_COUNT + sub) << (group - 1);
+    }
+    
+    /// Largeur (ns) de la case index
+    static uint64_t bucket_width(size_t index)
+    {
+        if (index < SUB_BUCKET_COUNT) {
+            return 1;
+        }
+        return uint64_t(1) << (index / SUB_BUCKET_COUNT - 1);
+    }
+    
+    /**
+     * @brief Valeur du percentile (0-100), à la précision d'une case près
+     * 
+     * Rang « nearest-rank » (percentile_rank), comme calculate_percentiles()
+     * sur un vecteur. Retourne la plus grande valeur de la case atteinte,
+     * bornée par les min/max exacts : p100 donne exactement max_ns().
+     */
+    uint64_t value_at_percentile(double percentile) const
+    {
+        uint64_t value = 0;
+        values_at_percentiles(&percentile, 1, &value);
+        return value;
+    }
+    
+    /**
+     * @brief Calcule plusieurs percentiles en un seul parcours des cases
+     * 
+     * Les percentiles peuvent être donnés dans n'importe quel ordre ; ils sont
+     * traités par rang croissant pendant un unique cumul des compteurs.
+     * 
+     * @param percentiles Tableau de percentiles (0-100)
+     * @param count Nombre de percentiles
+     * @param values Tableau de sortie (count valeurs en ns, 0 si vide)
+     */
+    void values_at_percentiles(const double* percentiles, size_t count, uint64_t* values) const
+    {
+        if (empty()) {
+            std::fill(values, values + count, 0);
+            return;
+        }
+        
+        // Ordre de traitement : percentiles croissants
+        std::vector<size_t> order(count);
+        for (size_t k = 0; k < count; ++k) order[k] = k;
+        std::sort(order.begin(), order.end(), [percentiles](size_t a, size_t b) {
+            return percentiles[a] < percentiles[b];
+        });
+        
+        size_t next = 0;
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i < BUCKET_COUNT && next < count; ++i) {
+            cumulative += counts_[i];
+            uint64_t highest = bucket_lower_bound(i) + bucket_width(i) - 1;
+            highest = std::max(min_ns(), std::min(highest, max_ns()));
+            
+            // Plusieurs percentiles peuvent tomber dans la même case
+            while (next < count && cumulative >= rank_of(percentiles[order[next]])) {
+                values[order[next]] = highest;
+                next++;
+            }
+        }
+        for (; next < count; ++next) {
+            values[order[next]] = max_ns();
+        }
+    }
+    
+private:
+    /// Rang (1..N) de l'échantillon correspondant à un percentile (percentile_rank)
+    uint64_t rank_of(double percentile) const
+    {
+        return percentile_rank(percentile, count());
+    }
+    
+    std::vector<uint64_t> counts_;     ///< Compteurs par case (taille fixe)
+    RunningStats stats_;               ///< Statistiques exactes en ligne
+};
+
+// ============================================================================
+// FILE SPSC SANS VERROU (THREAD RT → THREAD NON-RT)
+// ============================================================================
+
+/**
+ * @brief Échantillon publié par la boucle temps réel
+ */
+struct LatencySample {
+    uint64_t cycle;          ///< Numéro du cycle (0..N-1)
+    uint64_t timestamp_ns;   ///< Instant de réveil mesuré (CLOCK_MONOTONIC, ns)
+    uint64_t latency_ns;     ///< Latence de réveil (ns)
+};
+
+/**
+ * @brief File circulaire mono-producteur / mono-consommateur sans attente
+ * 
+ * Un std::cout dans la boucle SCHED_FIFO passe par le verrou d'iostream et
+ * un appel système write() : il perturbe les latences qu'il affiche. Le
+ * thread temps réel dépose donc ses échantillons dans cette file, et un
+ * thread non-RT s'occupe de tout le formatage et des E/S.
+ * 
+ * GARANTIES :
+ * - try_push() / try_pop() : wait-free, O(1), sans allocation ni appel système
+ * - Si la file est pleine, l'échantillon est abandonné (jamais de blocage du
+ *   thread RT) et compté dans dropped()
+ * 
+ * PRINCIPE :
+ * - head_ n'est écrit que par le producteur, tail_ que par le consommateur
+ * - Publication par store-release / lecture par load-acquire
+ * - Chaque indice est sur sa propre ligne de cache (64 octets sur Cortex-A72)
+ *   avec une copie locale de l'indice opposé, pour éviter le "false sharing"
+ * 
+ * @tparam T Type des éléments (copiable trivialement de préférence)
+ */
+template <typename T>
+class SpscRing {
+public:
+    /**
+     * @brief Construit une file de capacité fixe
+     * 
+     * @param capacity Capacité, arrondie à la puissance de deux supérieure
+     */
+    explicit SpscRing(size_t capacity)
+        : buffer_(round_up_pow2(capacity)), mask_(buffer_.size() - 1) {}
+    
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+    
+    /**
+     * @brief Ajoute un élément (côté producteur uniquement)
+     * 
+     * @return false si la file est pleine (élément abandonné)
+     */
+    bool try_push(const T& item)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head - cached_tail_ > mask_) {
+            cached_tail_ = tail_.load(std::memory_order_acquire);
+            if (head - cached_tail_ > mask_) {
+                dropped_.store(dropped_.load(std::memory_order_relaxed) + 1,
+                               std::memory_order_relaxed);
+                return false;
+            }
+        }
+        buffer_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    
+    /**
+     * @brief Retire un élément (côté consommateur uniquement)
+     * 
+     * @return false si la file est vide
+     */
+    bool try_pop(T& item)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == cached_head_) {
+            cached_head_ = head_.load(std::memory_order_acquire);
+            if (tail == cached_head_) {
+                return false;
+            }
+        }
+        item = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    
+    size_t capacity() const { return buffer_.size(); }   ///< Capacité réelle
+    
+    /// Nombre d'éléments abandonnés car la file était pleine
+    uint64_t dropped() const { return dropped_.load(std::memory_order_relaxed); }
+    
+private:
+    static size_t round_up_pow2(size_t n)
+    {
+        size_t p = 1;
+        while (p < n) p <<= 1;
+        return p;
+    }
+    
+    std::vector<T> buffer_;
+    const size_t mask_;
+    
+    // Côté producteur
+    alignas(64) std::atomic<size_t> head_{0};
+    size_t cached_tail_ = 0;
+    std::atomic<uint64_t> dropped_{0};
+    
+    // Côté consommateur
+    alignas(64) std::atomic<size_t> tail_{0};
+    size_t cached_head_ = 0;
+};
+
 // ============================================================================
 // FONCTIONS DE CALCUL STATISTIQUE
 // ============================================================================
@@ -143,54 +735,144 @@ struct LatencyStats {
  * @return Structure LatencyStats contenant les statistiques
  * 
  * ALGORITHME :
- * 1. Trouve le minimum et maximum avec std::min_element/max_element
- * 2. Calcule la moyenne avec une somme puis division
- * 3. Calcule l'écart-type avec la formule : sqrt(E[(X-µ)²])
+ * Un seul passage sur les données avec l'accumulateur RunningStats (Welford) :
+ * min, max, moyenne et écart-type sont mis à jour à chaque échantillon.
  * 
- * COMPLEXITÉ : O(n) où n est le nombre de latences
+ * COMPLEXITÉ : O(n) où n est le nombre de latences, en un seul parcours
  * 
  * @note Retourne des valeurs nulles si le vecteur est vide
  */
 inline LatencyStats calculate_stats(const std::vector<uint64_t>& latencies)
 {
-    LatencyStats stats = {0, 0, 0.0, 0.0};
-    
+    RunningStats acc;
+    for (const auto& lat : latencies) {
+        acc.add(lat);
+    }
+    return acc.to_latency_stats();
+}
+
+/**
+ * @brief Calcule les statistiques à partir d'un histogramme
+ * 
+ * Toutes les valeurs sont exactes : elles proviennent de l'accumulateur
+ * RunningStats mis à jour à chaque record(), pas des cases.
+ * 
+ * COMPLEXITÉ : O(1), indépendante du nombre d'échantillons
+ * 
+ * @param histogram Histogramme des latences
+ * @return Structure LatencyStats contenant les statistiques
+ */
+inline LatencyStats calculate_stats(const LatencyHistogram& histogram)
+{
+    return histogram.stats().to_latency_stats();
+}
+
+/**
+ * @brief Calcule le percentile d'un histogramme de latences
+ * 
+ * @param histogram Histogramme des latences (non modifié)
+ * @param percentile Percentile à calculer (0-100)
+ * @return Valeur du percentile en nanosecondes (précision d'une case)
+ */
+inline uint64_t calculate_percentile(const LatencyHistogram& histogram, double percentile)
+{
+    return histogram.value_at_percentile(percentile);
+}
+
+/**
+ * @brief Calcule plusieurs percentiles d'un ensemble de latences en O(n)
+ * 
+ * @param latencies Vecteur de latences (copie de travail, réordonnée ici :
+ *                  passer std::move(v) pour éviter la copie)
+ * @param percentiles Percentiles à calculer (0-100), dans n'importe quel ordre
+ * @return Valeurs des percentiles en nanosecondes, dans l'ordre demandé
+ * 
+ * ALGORITHME :
+ * Plutôt qu'un tri complet en O(n log n), std::nth_element place le k-ième
+ * élément à sa position triée en O(n), tous les éléments suivants étant
+ * supérieurs ou égaux. Les percentiles sont traités par ordre croissant, et
+ * chaque partitionnement ne porte que sur la partie restante [index, fin[.
+ * 
+ * Le rang est celui de percentile_rank() (« nearest-rank »), le même que
+ * pour un histogramme : les deux calculs donnent le même échantillon.
+ * 
+ * COMPLEXITÉ : O(n) en moyenne pour l'ensemble des percentiles
+ */
+inline std::vector<uint64_t> calculate_percentiles(std::vector<uint64_t> latencies,
+                                                   const std::vector<double>& percentiles)
+{
+    std::vector<uint64_t> values(percentiles.size(), 0);
     if (latencies.empty()) {
-        return stats;
+        return values;
     }
     
-    // Calcul du minimum et maximum
-    // std::min_element et std::max_element retournent des itérateurs
-    auto min_it = std::min_element(latencies.begin(), latencies.end());
-    auto max_it = std::max_element(latencies.begin(), latencies.end());
-    stats.min_ns = *min_it;
-    stats.max_ns = *max_it;
+    std::vector<size_t> order(percentiles.size());
+    for (size_t k = 0; k < order.size(); ++k) order[k] = k;
+    std::sort(order.begin(), order.end(), [&percentiles](size_t a, size_t b) {
+        return percentiles[a] < percentiles[b];
+    });
     
-    // Calcul de la moyenne
-    // Utilisation de uint64_t pour la somme pour éviter les dépassements
-    uint64_t sum = 0;
-    for (const auto& lat : latencies) {
-        sum += lat;
-    }
-    stats.avg_ns = static_cast<double>(sum) / static_cast<double>(latencies.size());
-    
-    // Calcul de l'écart-type
-    // Formule : σ = sqrt(Σ(xi - µ)² / N)
-    double variance = 0.0;
-    for (const auto& lat : latencies) {
-        double diff = static_cast<double>(lat) - stats.avg_ns;
-        variance += diff * diff;
+    auto first = latencies.begin();
+    for (size_t k : order) {
+        size_t index = static_cast<size_t>(percentile_rank(percentiles[k], latencies.size()) - 1);
+        auto nth = latencies.begin() + static_cast<std::ptrdiff_t>(index);
+        
+        // Les index sont croissants : nth est toujours dans [first, fin[
+        std::nth_element(first, nth, latencies.end());
+        values[k] = *nth;
+        first = nth;
     }
-    variance /= static_cast<double>(latencies.size());
-    stats.stddev_ns = std::sqrt(variance);
     
-    return stats;
+    return values;
+}
+
+/**
+ * @brief Calcule plusieurs percentiles d'un histogramme en un seul parcours
+ * 
+ * @param histogram Histogramme des latences
+ * @param percentiles Percentiles à calculer (0-100), dans n'importe quel ordre
+ * @return Valeurs des percentiles en nanosecondes (précision d'une case)
+ */
+inline std::vector<uint64_t> calculate_percentiles(const LatencyHistogram& histogram,
+                                                   const std::vector<double>& percentiles)
+{
+    std::vector<uint64_t> values(percentiles.size(), 0);
+    histogram.values_at_percentiles(percentiles.data(), percentiles.size(), values.data());
+    return values;
+}
+
+/**
+ * @brief Regroupe les percentiles usuels (STANDARD_PERCENTILES)
+ */
+inline LatencyPercentiles make_percentiles(const std::vector<uint64_t>& values)
+{
+    return LatencyPercentiles{values[0], values[1], values[2], values[3], values[4]};
+}
+
+/**
+ * @brief Calcule les percentiles usuels (p50, p90, p99, p99.9, p99.99)
+ */
+inline LatencyPercentiles calculate_percentiles(const LatencyHistogram& histogram)
+{
+    std::vector<double> p(std::begin(STANDARD_PERCENTILES), std::end(STANDARD_PERCENTILES));
+    return make_percentiles(calculate_percentiles(histogram, p));
+}
+
+/**
+ * @brief Calcule les percentiles usuels (p50, p90, p99, p99.9, p99.99) - O(n)
+ * 
+ * @param latencies Vecteur de latences (non modifié)
+ */
+inline LatencyPercentiles calculate_percentiles(const std::vector<uint64_t>& latencies)
+{
+    std::vector<double> p(std::begin(STANDARD_PERCENTILES), std::end(STANDARD_PERCENTILES));
+    return make_percentiles(calculate_percentiles(std::vector<uint64_t>(latencies), p));
 }
 
 /**
  * @brief Calcule le percentile d'un ensemble de latences
  * 
- * @param latencies Vecteur de latences (sera modifié - trié)
+ * @param latencies Vecteur de latences (non modifié)
  * @param percentile Percentile à calculer (0-100)
  * @return Valeur du percentile en nanosecondes
  * 
@@ -198,23 +880,12 @@ inline LatencyStats calculate_stats(const std::vector<uint64_t>& latencies)
  * - percentile = 99 → valeur en dessous de laquelle 99% des latences se situent
  * - percentile = 50 → médiane
  * 
- * @note Le vecteur passé est trié en place pour des raisons de performance
+ * @note Pour plusieurs percentiles, préférer calculate_percentiles() qui
+ *       les obtient tous en un seul passage.
  */
-inline uint64_t calculate_percentile(std::vector<uint64_t>& latencies, double percentile)
+inline uint64_t calculate_percentile(const std::vector<uint64_t>& latencies, double percentile)
 {
-    if (latencies.empty()) {
-        return 0;
-    }
-    
-    // Tri du vecteur
-    std::sort(latencies.begin(), latencies.end());
-    
-    // Calcul de l'index
-    size_t index = static_cast<size_t>(
-        (percentile / 100.0) * static_cast<double>(latencies.size() - 1)
-    );
-    
-    return latencies[index];
+    return calculate_percentiles(latencies, std::vector<double>{percentile})[0];
 }
 
 // ============================================================================
@@ -230,7 +901,10 @@ inline uint64_t calculate_percentile(std::vector<uint64_t>& latencies, double pe
  * - Les valeurs aberrantes (outliers)
  * - La forme de la distribution (gaussienne, exponentielle, etc.)
  * 
- * @param latencies Vecteur de latences en nanosecondes
+ * Les cases log-linéaires de l'histogramme sont regroupées en num_bins barres
+ * de largeur constante entre le minimum et le maximum mesurés.
+ * 
+ * @param histogram Histogramme des latences
  * @param num_bins Nombre de barres dans l'histogramme (défaut: 15)
  * 
  * EXEMPLE DE SORTIE :
@@ -242,16 +916,16 @@ inline uint64_t calculate_percentile(std::vector<uint64_t>& latencies, double pe
  *    ...
  * @endcode
  */
-inline void print_histogram(const std::vector<uint64_t>& latencies, int num_bins = 15)
+inline void print_histogram(const LatencyHistogram& histogram, int num_bins = 15)
 {
-    if (latencies.empty()) {
+    if (histogram.empty()) {
         std::cout << "  Aucune donnée pour l'histogramme" << std::endl;
         return;
     }
     
-    // Trouver les bornes
-    uint64_t min_lat = *std::min_element(latencies.begin(), latencies.end());
-    uint64_t max_lat = *std::max_element(latencies.begin(), latencies.end());
+    // Bornes exactes
+    uint64_t min_lat = histogram.min_ns();
+    uint64_t max_lat = histogram.max_ns();
     
     // Cas particulier : toutes les valeurs sont identiques
     if (min_lat == max_lat) {
@@ -265,40 +939,46 @@ inline void print_histogram(const std::vector<uint64_t>& latencies, int num_bins
     uint64_t bin_width = range / static_cast<uint64_t>(num_bins);
     if (bin_width == 0) bin_width = 1;  // Éviter la division par zéro
     
-    // Compter les valeurs dans chaque bin
-    std::vector<int> bins(num_bins, 0);
+    // Répartir chaque case de l'histogramme dans une barre d'affichage
+    // (selon le centre de la case, borné par min/max)
+    std::vector<uint64_t> bins(static_cast<size_t>(num_bins), 0);
     
-    for (const auto& lat : latencies) {
-        int bin_index = static_cast<int>((lat - min_lat) / bin_width);
+    for (size_t b = 0; b < LatencyHistogram::BUCKET_COUNT; ++b) {
+        uint64_t c = histogram.bucket_count_at(b);
+        if (c == 0) continue;
+        uint64_t center = LatencyHistogram::bucket_lower_bound(b)
+                        + (LatencyHistogram::bucket_width(b) - 1) / 2;
+        center = std::max(min_lat, std::min(center, max_lat));
+        
+        size_t bin_index = static_cast<size_t>((center - min_lat) / bin_width);
         // S'assurer que l'index est dans les limites
-        if (bin_index >= num_bins) bin_index = num_bins - 1;
-        if (bin_index < 0) bin_index = 0;
-        bins[bin_index]++;
+        if (bin_index >= bins.size()) bin_index = bins.size() - 1;
+        bins[bin_index] += c;
     }
     
     // Trouver le maximum pour normaliser les barres
-    int max_count = *std::max_element(bins.begin(), bins.end());
+    uint64_t max_count = *std::max_element(bins.begin(), bins.end());
     if (max_count == 0) max_count = 1;  // Éviter la division par zéro
     
     // Largeur maximale des barres
-    const int max_bar_width = 40;
+    const uint64_t max_bar_width = 40;
     
     // Affichage
     std::cout << "\n  " << COLOR_CYAN << "Histogramme des latences:" << COLOR_RESET << std::endl;
     
-    for (int i = 0; i < num_bins; ++i) {
+    for (size_t i = 0; i < bins.size(); ++i) {
         // Calcul des bornes du bin en microsecondes
-        uint64_t range_start_us = (min_lat + static_cast<uint64_t>(i) * bin_width) / 1000;
-        uint64_t range_end_us = (min_lat + static_cast<uint64_t>(i + 1) * bin_width) / 1000;
+        uint64_t range_start_us = (min_lat + i * bin_width) / 1000;
+        uint64_t range_end_us = (min_lat + (i + 1) * bin_width) / 1000;
         
         // Calcul de la longueur de la barre
-        int bar_length = (bins[i] * max_bar_width) / max_count;
+        uint64_t bar_length = (bins[i] * max_bar_width) / max_count;
         
         // Choix de la couleur en fonction de la position (vert pour les faibles, rouge pour les hautes)
         const char* color;
-        if (i < num_bins / 3) {
+        if (i < bins.size() / 3) {
             color = COLOR_GREEN;
-        } else if (i < 2 * num_bins / 3) {
+        } else if (i < 2 * bins.size() / 3) {
             color = COLOR_YELLOW;
         } else {
             color = COLOR_RED;
@@ -309,7 +989,7 @@ inline void print_histogram(const std::vector<uint64_t>& latencies, int num_bins
                   << std::setw(6) << range_end_us << " µs: ";
         
         std::cout << color;
-        for (int j = 0; j < bar_length; ++j) {
+        for (uint64_t j = 0; j < bar_length; ++j) {
             std::cout << "█";
         }
         std::cout << COLOR_RESET;
@@ -326,13 +1006,50 @@ inline void print_histogram(const std::vector<uint64_t>& latencies, int num_bins
 }
 
 /**
- * @brief Affiche un tableau comparatif des résultats
+ * @brief Affiche un histogramme ASCII à partir d'un vecteur de latences
  * 
- * @param no_rt_stats Statistiques du test sans RT (peut être NULL)
- * @param rt_stats Statistiques du test avec RT (peut être NULL)
+ * @param latencies Vecteur de latences en nanosecondes
+ * @param num_bins Nombre de barres dans l'histogramme (défaut: 15)
  */
-inline void print_comparison_table(const LatencyStats* no_rt_stats, 
-                                    const LatencyStats* rt_stats)
+inline void print_histogram(const std::vector<uint64_t>& latencies, int num_bins = 15)
+{
+    LatencyHistogram histogram;
+    for (const auto& lat : latencies) {
+        histogram.record(lat);
+    }
+    print_histogram(histogram, num_bins);
+}
+
+/**
+ * @brief Affiche une ligne du tableau comparatif
+ * 
+ * L'amélioration est la baisse relative de la valeur (positive = mieux avec
+ * RT) ; elle s'affiche en rouge lorsque la configuration RT est moins bonne.
+ * 
+ * @param label Libellé de la métrique (15 colonnes)
+ * @param no_rt Valeur sans RT
+ * @param rt Valeur avec RT
+ * @param unit Unité affichée après chaque valeur (3 colonnes, ex. " µs")
+ * @param decimals Nombre de décimales des valeurs (0 pour un compteur)
+ */
+inline void print_comparison_row(const char* label, double no_rt, double rt,
+                                 const char* unit, int decimals = 1)
+{
+    double improvement = no_rt > 0.0 ? (no_rt - rt) / no_rt * 100.0 : 0.0;
+    
+    std::cout << std::fixed << std::setprecision(decimals);
+    std::cout << "║  " << label << "│  "
+              << std::setw(9) << no_rt << unit << " │  "
+              << std::setw(9) << rt << unit << " │  "
+              << std::setprecision(1)
+              << (improvement < 0.0 ? COLOR_RED : COLOR_GREEN) << std::setw(6) << improvement << "%" 
+              << COLOR_RESET << "     ║" << std::endl;
+}
+
+/**
+ * @brief En-tête du tableau comparatif
+ */
+inline void print_comparison_header()
 {
     std::cout << "\n" << COLOR_CYAN 
               << "╔════════════════════════════════════════════════════════════════╗\n"
@@ -341,44 +1058,75 @@ inline void print_comparison_table(const LatencyStats* no_rt_stats,
               << "║  Métrique       │  Sans RT      │  Avec RT      │  Amélioration║\n"
               << "╠════════════════════════════════════════════════════════════════╣"
               << COLOR_RESET << std::endl;
+}
+
+/**
+ * @brief Pied du tableau comparatif
+ */
+inline void print_comparison_footer()
+{
+    std::cout << COLOR_CYAN 
+              << "╚════════════════════════════════════════════════════════════════╝"
+              << COLOR_RESET << std::endl;
+}
+
+/**
+ * @brief Affiche un tableau comparatif des résultats
+ * 
+ * @param no_rt_stats Statistiques du test sans RT (peut être NULL)
+ * @param rt_stats Statistiques du test avec RT (peut être NULL)
+ */
+inline void print_comparison_table(const LatencyStats* no_rt_stats, 
+                                   const LatencyStats* rt_stats)
+{
+    print_comparison_header();
     
     if (no_rt_stats && rt_stats) {
-        // Latence max
-        double improvement_max = (static_cast<double>(no_rt_stats->max_ns) - 
-                                  static_cast<double>(rt_stats->max_ns)) / 
-                                 static_cast<double>(no_rt_stats->max_ns) * 100.0;
-        
-        std::cout << std::fixed << std::setprecision(1);
-        std::cout << "║  Latence max    │  " 
-                  << std::setw(8) << no_rt_stats->max_ns / 1000 << " µs │  "
-                  << std::setw(8) << rt_stats->max_ns / 1000 << " µs │  "
-                  << COLOR_GREEN << std::setw(6) << improvement_max << "%" 
-                  << COLOR_RESET << "    ║" << std::endl;
-        
-        // Latence moyenne
-        double improvement_avg = (no_rt_stats->avg_ns - rt_stats->avg_ns) / 
-                                 no_rt_stats->avg_ns * 100.0;
-        
-        std::cout << "║  Latence moy    │  " 
-                  << std::setw(8) << no_rt_stats->avg_ns / 1000.0 << " µs │  "
-                  << std::setw(8) << rt_stats->avg_ns / 1000.0 << " µs │  "
-                  << COLOR_GREEN << std::setw(6) << improvement_avg << "%" 
-                  << COLOR_RESET << "    ║" << std::endl;
+        print_comparison_row("Latence max    ", static_cast<double>(no_rt_stats->max_ns) / 1000.0,
+                             static_cast<double>(rt_stats->max_ns) / 1000.0, " µs");
+        print_comparison_row("Latence moy    ", no_rt_stats->avg_ns / 1000.0,
+                             rt_stats->avg_ns / 1000.0, " µs");
+        print_comparison_row("Écart-type     ", no_rt_stats->stddev_ns / 1000.0,
+                             rt_stats->stddev_ns / 1000.0, " µs");
+    }
+    
+    print_comparison_footer();
+}
+
+/**
+ * @brief Tableau comparatif complet : statistiques, percentiles et deadlines
+ * 
+ * Les percentiles de queue (p99.9, p99.99) et les deadlines manquées sont
+ * souvent plus parlants que le maximum, dominé par un seul événement.
+ * 
+ * @param no_rt Histogramme du test sans RT (peut être NULL)
+ * @param rt Histogramme du test avec RT (peut être NULL)
+ */
+inline void print_comparison_table(const LatencyHistogram* no_rt, const LatencyHistogram* rt)
+{
+    print_comparison_header();
+    
+    if (no_rt && rt && !no_rt->empty() && !rt->empty()) {
+        LatencyStats a = calculate_stats(*no_rt);
+        LatencyStats b = calculate_stats(*rt);
+        LatencyPercentiles pa = calculate_percentiles(*no_rt);
+        LatencyPercentiles pb = calculate_percentiles(*rt);
         
-        // Écart-type
-        double improvement_std = (no_rt_stats->stddev_ns - rt_stats->stddev_ns) / 
-                                 no_rt_stats->stddev_ns * 100.0;
+        auto us = [](uint64_t ns) { return static_cast<double>(ns) / 1000.0; };
         
-        std::cout << "║  Écart-type     │  " 
-                  << std::setw(8) << no_rt_stats->stddev_ns / 1000.0 << " µs │  "
-                  << std::setw(8) << rt_stats->stddev_ns / 1000.0 << " µs │  "
-                  << COLOR_GREEN << std::setw(6) << improvement_std << "%" 
-                  << COLOR_RESET << "    ║" << std::endl;
+        print_comparison_row("Latence max    ", us(a.max_ns), us(b.max_ns), " µs");
+        print_comparison_row("Latence moy    ", a.avg_ns / 1000.0, b.avg_ns / 1000.0, " µs");
+        print_comparison_row("Écart-type     ", a.stddev_ns / 1000.0, b.stddev_ns / 1000.0, " µs");
+        print_comparison_row("p50            ", us(pa.p50_ns), us(pb.p50_ns), " µs");
+        print_comparison_row("p99            ", us(pa.p99_ns), us(pb.p99_ns), " µs");
+        print_comparison_row("p99.9          ", us(pa.p999_ns), us(pb.p999_ns), " µs");
+        print_comparison_row("p99.99         ", us(pa.p9999_ns), us(pb.p9999_ns), " µs");
+        print_comparison_row("Deadl. manquées",
+                             static_cast<double>(no_rt->stats().deadline_misses()),
+                             static_cast<double>(rt->stats().deadline_misses()), "   ", 0);
     }
     
-    std::cout << COLOR_CYAN 
-              << "╚════════════════════════════════════════════════════════════════╝"
-              << COLOR_RESET << std::endl;
+    print_comparison_footer();
 }
 
 #endif // RT_UTILS_H
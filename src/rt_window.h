@@ -0,0 +1,167 @@
+/**
+ * @file rt_window.h
+ * @brief Fenêtres glissantes de latence pour les mesures de longue durée (--soak)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Un rodage de 24 à 72 h ne se juge pas sur le seul bilan final : un pic
+ * unique à la 40e heure doit pouvoir être daté, et une dérive lente (tâche
+ * cron, thermique, fuite) se voit d'une fenêtre à l'autre. RollingWindows
+ * découpe le flux d'échantillons en fenêtres de durée fixe :
+ * 
+ * - la fenêtre courante est un LatencyHistogram (taille fixe) ;
+ * - à sa fermeture, elle est résumée (min, moyenne, p99, p99.9, max,
+ *   deadlines manquées) dans un anneau de résumés alloué à la construction,
+ *   puis remise à zéro ;
+ * - la pire fenêtre depuis le début est conservée à part.
+ * 
+ * L'empreinte mémoire ne dépend donc pas de la durée de la mesure. Les
+ * fenêtres sont découpées sur les horodatages des échantillons, pas sur
+ * l'heure de traitement : le résultat ne dépend pas du retard du thread
+ * qui les consomme.
+ * 
+ * Les percentiles de fermeture parcourent l'histogramme et allouent : à
+ * utiliser dans le thread de rapport non-RT, jamais dans la boucle RT.
+ */
+
+#ifndef RT_WINDOW_H
+#define RT_WINDOW_H
+
+#include <stdint.h>
+#include <vector>
+
+#include "rt_utils.h"
+
+/**
+ * @brief Résumé d'une fenêtre fermée
+ */
+struct WindowSummary {
+    uint64_t index = 0;             ///< Numéro de la fenêtre depuis le premier échantillon
+    uint64_t end_ns = 0;            ///< Dernier échantillon, depuis le premier (fenêtre finale partielle)
+    uint64_t count = 0;             ///< Échantillons reçus
+    uint64_t min_ns = 0;
+    double mean_ns = 0.0;
+    uint64_t p99_ns = 0;
+    uint64_t p999_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t deadline_misses = 0;
+    uint64_t dropped = 0;           ///< Échantillons perdus avant le rapport (file pleine)
+};
+
+/**
+ * @brief Fenêtres de durée fixe et anneau de leurs résumés
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * RollingWindows minutes(60ULL * 1000000000, 60, deadline_ns);   // 1 h de minutes
+ * if (minutes.record(sample.timestamp_ns, sample.latency_ns)) {
+ *     print_line(minutes.last());    // une minute vient de se fermer
+ * }
+ * @endcode
+ */
+class RollingWindows {
+public:
+    /**
+     * @param window_ns Durée d'une fenêtre
+     * @param capacity Résumés conservés (les plus anciens sont écrasés)
+     * @param deadline_ns Seuil des deadlines manquées
+     */
+    RollingWindows(uint64_t window_ns, size_t capacity, uint64_t deadline_ns)
+        : window_ns_(window_ns > 0 ? window_ns : 1), ring_(capacity > 0 ? capacity : 1),
+          current_(deadline_ns)
+    {
+    }
+    
+    /**
+     * @brief Ajoute un échantillon à sa fenêtre
+     * 
+     * @return true si l'échantillon a fermé la fenêtre précédente (résumé
+     *         disponible par last())
+     */
+    bool record(uint64_t timestamp_ns, uint64_t latency_ns)
+    {
+        if (!started_) {
+            origin_ns_ = timestamp_ns;
+            started_ = true;
+        }
+        const uint64_t index = timestamp_ns > origin_ns_ ? (timestamp_ns - origin_ns_) / window_ns_ : 0;
+        bool closed = false;
+        if (index > index_) {
+            closed = flush();
+            index_ = index;
+        }
+        current_.record(latency_ns);
+        last_ns_ = timestamp_ns > origin_ns_ ? timestamp_ns - origin_ns_ : 0;
+        return closed;
+    }
+    
+    /// Échantillons perdus en amont, imputés à la fenêtre courante
+    void add_dropped(uint64_t count) { dropped_ += count; }
+    
+    /**
+     * @brief Ferme la fenêtre courante (fin de mesure)
+     * 
+     * @return false si elle était vide
+     */
+    bool flush()
+    {
+        if (current_.empty()) return false;
+        
+        WindowSummary summary;
+        summary.index = index_;
+        summary.end_ns = last_ns_;
+        summary.count = current_.count();
+        summary.min_ns = current_.min_ns();
+        summary.mean_ns = current_.stats().mean_ns();
+        const double percentiles[] = {99.0, 99.9};
+        uint64_t values[2];
+        current_.values_at_percentiles(percentiles, 2, values);
+        summary.p99_ns = values[0];
+        summary.p999_ns = values[1];
+        summary.max_ns = current_.max_ns();
+        summary.deadline_misses = current_.stats().deadline_misses();
+        summary.dropped = dropped_;
+        
+        ring_[static_cast<size_t>(closed_ % ring_.size())] = summary;
+        if (closed_ == 0 || summary.max_ns > worst_.max_ns) {
+            worst_ = summary;
+        }
+        ++closed_;
+        current_.reset();
+        dropped_ = 0;
+        return true;
+    }
+    
+    uint64_t window_ns() const { return window_ns_; }   ///< Durée d'une fenêtre
+    uint64_t closed() const { return closed_; }         ///< Fenêtres fermées depuis le début
+    
+    /// Résumés conservés (au plus la capacité de l'anneau)
+    size_t size() const { return closed_ < ring_.size() ? static_cast<size_t>(closed_) : ring_.size(); }
+    
+    /// k-ième résumé conservé, du plus ancien (0) au plus récent
+    const WindowSummary& at(size_t k) const
+    {
+        return ring_[static_cast<size_t>((closed_ - size() + k) % ring_.size())];
+    }
+    
+    /// Dernière fenêtre fermée (closed() > 0)
+    const WindowSummary& last() const { return ring_[static_cast<size_t>((closed_ - 1) % ring_.size())]; }
+    
+    /// Fenêtre de plus grande latence maximale depuis le début (closed() > 0)
+    const WindowSummary& worst() const { return worst_; }
+
+private:
+    uint64_t window_ns_;
+    std::vector<WindowSummary> ring_;
+    LatencyHistogram current_;
+    WindowSummary worst_;
+    uint64_t origin_ns_ = 0;
+    uint64_t last_ns_ = 0;
+    uint64_t index_ = 0;        ///< Fenêtre courante
+    uint64_t closed_ = 0;
+    uint64_t dropped_ = 0;
+    bool started_ = false;
+};
+
+#endif // RT_WINDOW_H
@@ -0,0 +1,360 @@
+/**
+ * @file rt_workload.h
+ * @brief Charges de calcul synthétiques exécutées à chaque cycle
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Une boucle qui ne fait que dormir et mesurer l'heure évalue la latence de
+ * réveil, mais pas ce que subit une vraie tâche de contrôle : empreinte
+ * cache, bande passante mémoire, calcul flottant. Ce fichier fournit des
+ * noyaux de calcul représentatifs pour dimensionner la quantité de travail
+ * qui tient dans un budget de 1 ms ou 250 µs sur le Cortex-A72 :
+ * 
+ * - memwalk : parcours aléatoire (pointer chasing) d'un tampon de N Ko,
+ *             une ligne de cache par accès, insensible au prefetcher
+ * - fir     : filtre FIR 32 coefficients sur un bloc de N échantillons
+ *             (NEON sur ARM64, scalaire ailleurs)
+ * - matmul  : produit de matrices N×N en virgule flottante
+ * 
+ * Toutes les allocations ont lieu dans init(), AVANT la boucle temps réel ;
+ * run() n'alloue rien et ne fait aucun appel système.
+ */
+
+#ifndef RT_WORKLOAD_H
+#define RT_WORKLOAD_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+// ============================================================================
+// TYPES DE CHARGE
+// ============================================================================
+
+/**
+ * @brief Noyau de calcul exécuté à chaque cycle
+ */
+enum class WorkloadType {
+    NONE,      ///< Aucune charge (mesure de la latence de réveil seule)
+    MEMWALK,   ///< Parcours mémoire aléatoire (paramètre : taille en Ko)
+    FIR,       ///< Filtre FIR (paramètre : nombre d'échantillons par bloc)
+    MATMUL     ///< Produit de matrices (paramètre : dimension N)
+};
+
+/**
+ * @brief Charge choisie et son paramètre (syntaxe "type:paramètre")
+ */
+struct WorkloadSpec {
+    WorkloadType type = WorkloadType::NONE;
+    int param = 0;   ///< 0 = valeur par défaut du type
+};
+
+/// Paramètres par défaut : ~ quelques dizaines de µs sur Cortex-A72
+constexpr int DEFAULT_MEMWALK_KB = 64;
+constexpr int DEFAULT_FIR_SAMPLES = 1024;
+constexpr int DEFAULT_MATMUL_N = 32;
+
+/**
+ * Paramètres maximaux acceptés : au-delà, l'allocation de init() échouerait
+ * (std::bad_alloc hors de tout gestionnaire) ou un cycle durerait des
+ * secondes, bien loin d'une période RT.
+ */
+constexpr int MAX_MEMWALK_KB = 1024 * 1024;   ///< 1 Gio parcouru
+constexpr int MAX_FIR_SAMPLES = 1 << 20;      ///< 4 Mo d'échantillons float par bloc
+constexpr int MAX_MATMUL_N = 1024;            ///< 3 matrices de 4 Mo, 10^9 multiplications
+
+/// Nombre de coefficients du filtre FIR (multiple de 4 pour NEON)
+constexpr size_t FIR_TAPS = 32;
+
+/**
+ * @brief Nom lisible d'un type de charge
+ */
+inline const char* workload_name(WorkloadType type)
+{
+    switch (type) {
+        case WorkloadType::MEMWALK: return "memwalk";
+        case WorkloadType::FIR:     return "fir";
+        case WorkloadType::MATMUL:  return "matmul";
+        default:                    return "none";
+    }
+}
+
+/**
+ * @brief Convertit une spécification "type[:paramètre]"
+ * 
+ * Exemples : "memwalk:256" (256 Ko), "fir" (1024 échantillons), "matmul:48"
+ * 
+ * @param text Spécification
+ * @param spec Résultat en cas de succès
+ * @return true si la spécification est valide (paramètre ≤ MAX_* du type)
+ */
+inline bool parse_workload_spec(const std::string& text, WorkloadSpec& spec)
+{
+    std::string name = text;
+    int param = 0;
+    
+    size_t colon = text.find(':');
+    if (colon != std::string::npos) {
+        name = text.substr(0, colon);
+        std::string value = text.substr(colon + 1);
+        if (value.empty() || value.find_first_not_of("0123456789") != std::string::npos
+            || value.size() > 7) {
+            return false;
+        }
+        param = std::stoi(value);
+        if (param <= 0) {
+            return false;
+        }
+    }
+    
+    int max_param = 0;
+    if (name == "none") {
+        spec.type = WorkloadType::NONE;
+    } else if (name == "memwalk") {
+        spec.type = WorkloadType::MEMWALK;
+        max_param = MAX_MEMWALK_KB;
+    } else if (name == "fir") {
+        spec.type = WorkloadType::FIR;
+        max_param = MAX_FIR_SAMPLES;
+    } else if (name == "matmul") {
+        spec.type = WorkloadType::MATMUL;
+        max_param = MAX_MATMUL_N;
+    } else {
+        return false;
+    }
+    if (param > max_param) {
+        return false;
+    }
+    spec.param = param;
+    return true;
+}
+
+// ============================================================================
+// CHARGE SYNTHÉTIQUE
+// ============================================================================
+
+/**
+ * @brief Charge de calcul pré-allouée, exécutée une fois par cycle
+ * 
+ * EXEMPLE D'UTILISATION :
+ * @code
+ * SyntheticWorkload workload;
+ * workload.init(spec);      // allocation + pré-chargement, hors boucle RT
+ * // ... dans la boucle RT, après la mesure de latence :
+ * workload.run();
+ * @endcode
+ */
+class SyntheticWorkload {
+public:
+    /**
+     * @brief Alloue et initialise les données de la charge
+     * 
+     * Toutes les pages sont écrites ici : aucune page fault dans run().
+     */
+    void init(const WorkloadSpec& spec)
+    {
+        type_ = spec.type;
+        
+        switch (type_) {
+            case WorkloadType::MEMWALK:
+                param_ = spec.param > 0 ? spec.param : DEFAULT_MEMWALK_KB;
+                init_memwalk(static_cast<size_t>(param_) * 1024);
+                break;
+            case WorkloadType::FIR:
+                param_ = spec.param > 0 ? spec.param : DEFAULT_FIR_SAMPLES;
+                init_fir(static_cast<size_t>(param_));
+                break;
+            case WorkloadType::MATMUL:
+                param_ = spec.param > 0 ? spec.param : DEFAULT_MATMUL_N;
+                init_matmul(static_cast<size_t>(param_));
+                break;
+            default:
+                param_ = 0;
+                break;
+        }
+    }
+    
+    /**
+     * @brief Exécute un cycle de charge - sans allocation ni appel système
+     */
+    void run()
+    {
+        switch (type_) {
+            case WorkloadType::MEMWALK: run_memwalk(); break;
+            case WorkloadType::FIR:     run_fir();     break;
+            case WorkloadType::MATMUL:  run_matmul();  break;
+            default: break;
+        }
+    }
+    
+    bool active() const { return type_ != WorkloadType::NONE; }   ///< Charge active ?
+    WorkloadType type() const { return type_; }                   ///< Type de charge
+    int param() const { return param_; }                          ///< Paramètre effectif
+    
+    /// Description lisible, ex. "memwalk 64 Ko"
+    std::string describe() const
+    {
+        switch (type_) {
+            case WorkloadType::MEMWALK: return "memwalk " + std::to_string(param_) + " Ko";
+            case WorkloadType::FIR:
+                return "fir " + std::to_string(FIR_TAPS) + " coefficients × "
+                     + std::to_string(param_) + " échantillons";
+            case WorkloadType::MATMUL:
+                return "matmul " + std::to_string(param_) + "×" + std::to_string(param_);
+            default: return "aucune";
+        }
+    }
+
+private:
+    // ------------------------------------------------------------------------
+    // memwalk : pointer chasing sur des lignes de cache
+    // ------------------------------------------------------------------------
+    
+    /// Une ligne de cache (64 octets sur Cortex-A72)
+    struct alignas(64) CacheLine {
+        uint32_t next;        ///< Indice de la ligne suivante du parcours
+        uint32_t counter;     ///< Écrit à chaque passage (ligne "sale")
+        uint8_t pad[56];
+    };
+    
+    void init_memwalk(size_t bytes)
+    {
+        size_t count = std::max<size_t>(1, bytes / sizeof(CacheLine));
+        lines_.assign(count, CacheLine{});
+        
+        /*
+         * Permutation cyclique aléatoire (algorithme de Sattolo) : chaque
+         * ligne est visitée une fois par tour, dans un ordre que le
+         * prefetcher matériel ne peut pas anticiper.
+         */
+        std::vector<uint32_t> order(count);
+        for (size_t i = 0; i < count; ++i) order[i] = static_cast<uint32_t>(i);
+        uint64_t seed = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = count - 1; i > 0; --i) {
+            seed ^= seed << 13; seed ^= seed >> 7; seed ^= seed << 17;   // xorshift64
+            size_t j = static_cast<size_t>(seed % i);
+            std::swap(order[i], order[j]);
+        }
+        for (size_t i = 0; i < count; ++i) {
+            lines_[order[i]].next = order[(i + 1) % count];
+        }
+    }
+    
+    void run_memwalk()
+    {
+        uint32_t idx = 0;
+        for (size_t i = 0; i < lines_.size(); ++i) {
+            CacheLine& line = lines_[idx];
+            line.counter++;
+            idx = line.next;
+        }
+        sink_ = sink_ + idx;
+    }
+    
+    // ------------------------------------------------------------------------
+    // fir : filtre à réponse impulsionnelle finie
+    // ------------------------------------------------------------------------
+    
+    void init_fir(size_t samples)
+    {
+        fir_samples_ = samples;
+        fir_in_.assign(samples + FIR_TAPS, 0.0f);
+        fir_out_.assign(samples, 0.0f);
+        for (size_t k = 0; k < FIR_TAPS; ++k) {
+            fir_taps_[k] = 1.0f / static_cast<float>(FIR_TAPS);
+        }
+        for (size_t i = 0; i < fir_in_.size(); ++i) {
+            fir_in_[i] = static_cast<float>(i % 17) * 0.25f;
+        }
+    }
+    
+    void run_fir()
+    {
+        const float* in = fir_in_.data();
+        float* out = fir_out_.data();
+        size_t i = 0;
+
+#if defined(__ARM_NEON)
+        // 4 sorties calculées en parallèle : out[i..i+3] += taps[k] × in[i+k..i+k+3]
+        for (; i + 4 <= fir_samples_; i += 4) {
+            float32x4_t acc = vdupq_n_f32(0.0f);
+            for (size_t k = 0; k < FIR_TAPS; ++k) {
+                acc = vmlaq_n_f32(acc, vld1q_f32(in + i + k), fir_taps_[k]);
+            }
+            vst1q_f32(out + i, acc);
+        }
+#endif
+        for (; i < fir_samples_; ++i) {
+            float acc = 0.0f;
+            for (size_t k = 0; k < FIR_TAPS; ++k) {
+                acc += fir_taps_[k] * in[i + k];
+            }
+            out[i] = acc;
+        }
+        
+        // Réinjecter une sortie pour que les données évoluent d'un cycle à l'autre
+        fir_in_[fir_samples_ % fir_in_.size()] = out[0];
+        sink_ = sink_ + static_cast<uint32_t>(out[fir_samples_ / 2]);
+    }
+    
+    // ------------------------------------------------------------------------
+    // matmul : produit de matrices N×N
+    // ------------------------------------------------------------------------
+    
+    void init_matmul(size_t n)
+    {
+        mat_n_ = n;
+        mat_a_.assign(n * n, 0.0f);
+        mat_b_.assign(n * n, 0.0f);
+        mat_c_.assign(n * n, 0.0f);
+        for (size_t i = 0; i < n * n; ++i) {
+            mat_a_[i] = static_cast<float>(i % 7) * 0.5f;
+            mat_b_[i] = static_cast<float>(i % 5) * 0.25f;
+        }
+    }
+    
+    void run_matmul()
+    {
+        const size_t n = mat_n_;
+        std::fill(mat_c_.begin(), mat_c_.end(), 0.0f);
+        
+        // Ordre i-k-j : accès séquentiels à B et C (vectorisable par le compilateur)
+        for (size_t i = 0; i < n; ++i) {
+            for (size_t k = 0; k < n; ++k) {
+                const float a = mat_a_[i * n + k];
+                for (size_t j = 0; j < n; ++j) {
+                    mat_c_[i * n + j] += a * mat_b_[k * n + j];
+                }
+            }
+        }
+        sink_ = sink_ + static_cast<uint32_t>(mat_c_[n * n / 2]);
+    }
+    
+    WorkloadType type_ = WorkloadType::NONE;
+    int param_ = 0;
+    
+    std::vector<CacheLine> lines_;
+    
+    size_t fir_samples_ = 0;
+    float fir_taps_[FIR_TAPS] = {};
+    std::vector<float> fir_in_;
+    std::vector<float> fir_out_;
+    
+    size_t mat_n_ = 0;
+    std::vector<float> mat_a_;
+    std::vector<float> mat_b_;
+    std::vector<float> mat_c_;
+    
+    /// Résultat consommé : empêche le compilateur d'éliminer le calcul
+    volatile uint32_t sink_ = 0;
+};
+
+#endif // RT_WORKLOAD_H
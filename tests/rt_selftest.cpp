@@ -0,0 +1,229 @@
+/**
+ * @file rt_selftest.cpp
+ * @brief Tests des calculs statistiques de rt_utils.h et rt_baseline.h (ctest)
+ * 
+ * @author Jeremy Dierx | Code Alchimie
+ * @date 2025
+ * 
+ * Les chiffres affichés par rt_tuto et la porte de non-régression reposent
+ * sur trois calculs qu'une mesure ne permet pas de vérifier à l'œil :
+ * 
+ * - les percentiles « nearest-rank », sur un histogramme dont chaque case
+ *   est exacte (valeurs < 128 ns) et sur un vecteur ;
+ * - la fusion de RunningStats (Chan), comparée à un passage unique ;
+ * - le test de queue compare_tail() : muet sur deux mesures identiques,
+ *   en alerte sur une queue nettement décalée.
+ * 
+ * ============================================================================
+ * UTILISATION
+ * ============================================================================
+ * 
+ *   ctest --test-dir build --output-on-failure
+ *   ./build/rt_selftest                 # Même chose, sans ctest
+ * 
+ * Code de retour : 0 si tous les contrôles passent, 1 sinon.
+ * 
+ * ============================================================================
+ */
+
+#include <math.h>
+#include <stdint.h>
+
+#include <iostream>
+#include <vector>
+
+#include "rt_utils.h"
+#include "rt_baseline.h"
+
+// ============================================================================
+// CONTRÔLES
+// ============================================================================
+
+/// Contrôles en échec (le programme continue pour tous les afficher)
+int g_failures = 0;
+
+/**
+ * @brief Vérifie une condition et décrit l'échec sur std::cerr
+ */
+#define CHECK(condition)                                                              \
+    do {                                                                              \
+        if (!(condition)) {                                                           \
+            std::cerr << COLOR_RED << "  ✗ " << __FILE__ << ":" << __LINE__ << " : "  \
+                      << #condition << COLOR_RESET << std::endl;                      \
+            g_failures++;                                                             \
+        }                                                                             \
+    } while (0)
+
+/// Écart relatif entre deux réels (référence non nulle)
+double relative_error(double value, double reference)
+{
+    return fabs(value - reference) / fabs(reference);
+}
+
+// ============================================================================
+// PERCENTILES « NEAREST-RANK »
+// ============================================================================
+
+/**
+ * Valeurs 1..100 ns, une par case : le p-ième percentile est exactement
+ * l'échantillon de rang ceil(p / 100 × 100) = p.
+ */
+void test_percentiles()
+{
+    std::cout << "• Percentiles nearest-rank" << std::endl;
+    
+    CHECK(percentile_rank(50.0, 1) == 1);
+    CHECK(percentile_rank(0.0, 10) == 1);
+    CHECK(percentile_rank(100.0, 10) == 10);
+    CHECK(percentile_rank(99.9, 1000) == 999);      // 999.0000000000001 en double
+    CHECK(percentile_rank(99.99, 10000) == 9999);
+    CHECK(percentile_rank(90.0, 7) == 7);           // ceil(6.3)
+    
+    LatencyHistogram histogram;
+    std::vector<uint64_t> latencies;
+    for (uint64_t value = 100; value >= 1; --value) {   // ordre décroissant : le tri est testé aussi
+        histogram.record(value);
+        latencies.push_back(value);
+    }
+    
+    CHECK(histogram.value_at_percentile(0.0) == 1);
+    CHECK(histogram.value_at_percentile(1.0) == 1);
+    CHECK(histogram.value_at_percentile(50.0) == 50);
+    CHECK(histogram.value_at_percentile(50.5) == 51);
+    CHECK(histogram.value_at_percentile(99.0) == 99);
+    CHECK(histogram.value_at_percentile(99.9) == 100);
+    CHECK(histogram.value_at_percentile(100.0) == 100);
+    
+    // Histogramme et vecteur : même définition, mêmes valeurs sur des cases exactes
+    const LatencyPercentiles from_histogram = calculate_percentiles(histogram);
+    const LatencyPercentiles from_vector = calculate_percentiles(latencies);
+    CHECK(from_histogram.p50_ns == 50 && from_vector.p50_ns == 50);
+    CHECK(from_histogram.p90_ns == 90 && from_vector.p90_ns == 90);
+    CHECK(from_histogram.p99_ns == 99 && from_vector.p99_ns == 99);
+    CHECK(from_histogram.p999_ns == 100 && from_vector.p999_ns == 100);
+    
+    // Au-delà de 128 ns, la case est bornée par le maximum exact
+    LatencyHistogram wide;
+    wide.record(20000);
+    CHECK(wide.value_at_percentile(50.0) == 20000);
+    CHECK(wide.value_at_percentile(100.0) == 20000);
+}
+
+// ============================================================================
+// FUSION DE RUNNINGSTATS (WELFORD / CHAN)
+// ============================================================================
+
+/**
+ * Une série coupée en deux accumulateurs de tailles inégales, puis
+ * fusionnée, doit redonner les statistiques d'un passage unique.
+ */
+void test_running_stats_merge()
+{
+    std::cout << "• Fusion RunningStats" << std::endl;
+    
+    const uint64_t deadline_ns = 60000;
+    RunningStats single(deadline_ns);
+    RunningStats first(deadline_ns);
+    RunningStats second(deadline_ns);
+    
+    // Série déterministe : base 20 µs, bruit pseudo-aléatoire, quelques pics
+    uint64_t state = 12345;
+    for (int i = 0; i < 10000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t value = 20000 + (state >> 33) % 5000;
+        if (i % 997 == 0) value += 50000;
+        
+        single.add(value);
+        (i < 3000 ? first : second).add(value);
+    }
+    
+    RunningStats merged = first;
+    merged.merge(second);
+    
+    CHECK(merged.count() == single.count());
+    CHECK(merged.min_ns() == single.min_ns());
+    CHECK(merged.max_ns() == single.max_ns());
+    CHECK(merged.deadline_misses() == single.deadline_misses());
+    CHECK(relative_error(merged.mean_ns(), single.mean_ns()) < 1e-12);
+    CHECK(relative_error(merged.variance_ns2(), single.variance_ns2()) < 1e-9);
+    
+    // Fusion avec un accumulateur vide, dans les deux sens
+    RunningStats empty(deadline_ns);
+    RunningStats left = empty;
+    left.merge(single);
+    RunningStats right = single;
+    right.merge(empty);
+    CHECK(left.count() == single.count() && left.mean_ns() == single.mean_ns());
+    CHECK(right.count() == single.count() && right.variance_ns2() == single.variance_ns2());
+}
+
+// ============================================================================
+// TEST DE QUEUE (compare_tail)
+// ============================================================================
+
+/**
+ * @brief Distribution de latences : base 20-25 µs et une queue plus lente
+ * 
+ * @param tail_ns Latence de la queue
+ * @param tail_every Un échantillon sur tail_every est dans la queue
+ */
+LatencyHistogram make_distribution(uint64_t tail_ns, int tail_every)
+{
+    LatencyHistogram histogram;
+    uint64_t state = 67890;
+    for (int i = 0; i < 20000; ++i) {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        uint64_t value = 20000 + (state >> 33) % 5000;
+        if (i % tail_every == 0) value = tail_ns + (state >> 40) % 1000;
+        histogram.record(value);
+    }
+    return histogram;
+}
+
+/**
+ * Même référence, deux mesures : elle-même (z nul), puis une queue plus
+ * lointaine et plus fréquente, que le test doit signaler.
+ */
+void test_compare_tail()
+{
+    std::cout << "• Test de queue compare_tail" << std::endl;
+    
+    const LatencyHistogram baseline = make_distribution(40000, 100);
+    
+    // Mesure identique : aucun excès, aucune alerte
+    for (double percentile : REGRESSION_PERCENTILES) {
+        const TailComparison same = compare_tail(baseline, baseline, percentile);
+        CHECK(!same.regression);
+        CHECK(same.z == 0.0);
+        CHECK(same.current_ns == same.baseline_ns);
+    }
+    
+    // Queue décalée de 40 à 200 µs et cinq fois plus fréquente : régression au p99
+    const LatencyHistogram shifted = make_distribution(200000, 20);
+    const TailComparison worse = compare_tail(baseline, shifted, 99.0);
+    CHECK(worse.regression);
+    CHECK(worse.z > REGRESSION_Z_THRESHOLD);
+    CHECK(worse.current_excess > worse.baseline_excess);
+    
+    // Sens inverse : une queue plus légère n'est pas une régression
+    const TailComparison better = compare_tail(shifted, baseline, 99.0);
+    CHECK(!better.regression);
+}
+
+// ============================================================================
+// FONCTION PRINCIPALE
+// ============================================================================
+
+int main()
+{
+    test_percentiles();
+    test_running_stats_merge();
+    test_compare_tail();
+    
+    if (g_failures != 0) {
+        std::cerr << COLOR_RED << "✗ " << g_failures << " contrôle(s) en échec" << COLOR_RESET << std::endl;
+        return 1;
+    }
+    std::cout << COLOR_GREEN << "✓ Tous les contrôles passent" << COLOR_RESET << std::endl;
+    return 0;
+}